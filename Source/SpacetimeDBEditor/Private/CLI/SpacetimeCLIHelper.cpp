@@ -1,32 +1,45 @@
 #include "CLI/SpacetimeCLIHelper.h"
 
-#include "CLI/toml.hpp"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Base64.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "SpacetimeProcessRunner.h"
+
+/** Seconds a status probe may take before the CLI is considered unresponsive. */
+static constexpr double CliProbeTimeout = 10.0;
 
 bool FSpacetimeCLIHelper::IsCliAvailable()
 {
-	int32 ReturnCode;
-	FString OutStdOut, OutStdErr;
-	
-	return FPlatformProcess::ExecProcess(
-		TEXT("spacetime"),
-		TEXT(""), &ReturnCode, &OutStdOut, &OutStdErr);
+	FSpacetimeProcessParams Params;
+	Params.Timeout = CliProbeTimeout;
+	return MakeShared<FSpacetimeProcessRunner>(Params)->Launch().Get().bLaunched;
 }
 
 bool FSpacetimeCLIHelper::IsLoggedIn()
 {
-	int32 ReturnCode;
-	FString OutStdOut, OutStdErr;
-	
-	if (!FPlatformProcess::ExecProcess(
-		TEXT("spacetime"),
-		TEXT("login show"), &ReturnCode, &OutStdOut, &OutStdErr))
+	FSpacetimeCliConfig Config;
+	if (FString Error; GetCliConfig(Config, Error))
 	{
-		return false;
+		if (Config.SpacetimeDBToken.IsEmpty())
+		{
+			return false;
+		}
+		if (FSpacetimeCredentials Credentials; DecodeToken(Config.SpacetimeDBToken, Credentials, Error))
+		{
+			return !Credentials.IsExpired();
+		}
 	}
 
-	if (ReturnCode != 0) return false;
+	// Only the CLI knows for sure, for instance if cli.toml moved or changed format
+	FSpacetimeProcessParams Params;
+	Params.Arguments = TEXT("login show");
+	Params.Timeout = CliProbeTimeout;
+	const FSpacetimeProcessResult Result = MakeShared<FSpacetimeProcessRunner>(Params)->Launch().Get();
 
-	return OutStdOut.Contains("You are logged in as ");
+	return Result.Succeeded() && Result.StdOut.Contains("You are logged in as ");
 }
 
 bool FSpacetimeCLIHelper::TryParseSpacetimeLogin(const FString& CliOutput, FSpacetimeCredentials& OutCredentials)
@@ -59,6 +72,67 @@ bool FSpacetimeCLIHelper::TryParseSpacetimeLogin(const FString& CliOutput, FSpac
 	return OutCredentials.IsValid();
 }
 
+bool FSpacetimeCLIHelper::DecodeToken(const FString& Token, FSpacetimeCredentials& OutCredentials, FString& OutError)
+{
+	OutCredentials = FSpacetimeCredentials();
+
+	// header.payload.signature, each base64url without padding
+	TArray<FString> Parts;
+	if (Token.ParseIntoArray(Parts, TEXT("."), /*InCullEmpty*/ false) != 3)
+	{
+		OutError = TEXT("Token is not a JWT");
+		return false;
+	}
+
+	FString Payload = Parts[1];
+	Payload.Append(FString::ChrN((4 - Payload.Len() % 4) % 4, TEXT('=')));
+	FString PayloadJson;
+	if (!FBase64::Decode(Payload, PayloadJson, EBase64Mode::UrlSafe))
+	{
+		OutError = TEXT("Token payload is not base64url");
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Claims;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(PayloadJson), Claims) || !Claims.IsValid())
+	{
+		OutError = TEXT("Token payload is not a JSON object");
+		return false;
+	}
+
+	if (!Claims->TryGetStringField(TEXT("hex_identity"), OutCredentials.Identity))
+	{
+		OutError = TEXT("Token has no 'hex_identity' claim");
+		return false;
+	}
+
+	// SpacetimeDB tokens may carry "exp": null, meaning they never expire
+	if (int64 Expiry; Claims->TryGetNumberField(TEXT("exp"), Expiry))
+	{
+		OutCredentials.ExpiresAt = FDateTime::FromUnixTimestamp(Expiry);
+	}
+
+	OutCredentials.Token = Token;
+	return true;
+}
+
+bool FSpacetimeCLIHelper::ResolveCredentials(FSpacetimeCredentials& OutCredentials, FString& OutError)
+{
+	OutCredentials = FSpacetimeCredentials();
+
+	FSpacetimeCliConfig Config;
+	if (!GetCliConfig(Config, OutError))
+	{
+		return false;
+	}
+	if (Config.SpacetimeDBToken.IsEmpty())
+	{
+		OutError = TEXT("No 'spacetimedb_token' in cli.toml");
+		return false;
+	}
+	return DecodeToken(Config.SpacetimeDBToken, OutCredentials, OutError);
+}
+
 bool FSpacetimeCLIHelper::GetCliTomlPath(FString& OutPath, FString& OutError)
 {
 	// Determine default location
@@ -92,110 +166,58 @@ bool FSpacetimeCLIHelper::GetCliTomlPath(FString& OutPath, FString& OutError)
 bool FSpacetimeCLIHelper::GetCliConfig(FSpacetimeCliConfig& OutConfig, FString& OutError)
 {
 	OutConfig = FSpacetimeCliConfig();
-	
-	const FString Path = GetDefaultCliTomlPath();
-	if (!ValidateFile(Path, OutError))
+
+	// Environment variables are not expected to change while the editor runs
+	static const FString Path = GetDefaultCliTomlPath();
+	if (Path.IsEmpty())
 	{
+		OutError = TEXT("Unable to determine cli.toml path.");
 		return false;
 	}
-	return ParseToml(Path, OutConfig, OutError);
-}
 
-bool FSpacetimeCLIHelper::ValidateFile(const FString& InPath, FString& OutError)
-{
-	if (InPath.IsEmpty())
+	const FFileStatData Stat = IFileManager::Get().GetStatData(*Path);
+	if (!Stat.bIsValid || Stat.bIsDirectory)
 	{
-		OutError = TEXT("Unable to determine cli.toml path.");
+		OutError = FString::Printf(TEXT("Configuration file not found: %s"), *Path);
 		return false;
 	}
-	IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
-	if (!PF.FileExists(*InPath))
+	if (Stat.FileSize <= 0)
 	{
-		OutError = FString::Printf(TEXT("Configuration file not found: %s"), *InPath);
+		OutError = FString::Printf(TEXT("Configuration file is empty: %s"), *Path);
 		return false;
 	}
-	if (PF.FileSize(*InPath) <= 0)
+
+	/** The last parse, shared by every caller; reused until the file's timestamp or size changes. */
+	struct FCachedConfig
+	{
+		FDateTime ModificationTime;
+		int64 FileSize = -1;
+		bool bParsed = false;
+		FSpacetimeCliConfig Config;
+		FString Error;
+	};
+	static FCriticalSection CacheLock;
+	static FCachedConfig Cache;
+
+	FScopeLock ScopeLock(&CacheLock);
+	if (Cache.FileSize != Stat.FileSize || Cache.ModificationTime != Stat.ModificationTime)
+	{
+		Cache.ModificationTime = Stat.ModificationTime;
+		Cache.FileSize = Stat.FileSize;
+		Cache.Config = FSpacetimeCliConfig();
+		Cache.Error.Empty();
+		Cache.bParsed = ParseToml(Path, Cache.Config, Cache.Error);
+	}
+
+	if (!Cache.bParsed)
 	{
-		OutError = FString::Printf(TEXT("Configuration file is empty: %s"), *InPath);
+		OutError = Cache.Error;
 		return false;
 	}
+	OutConfig = Cache.Config;
 	return true;
 }
 
-bool FSpacetimeCLIHelper::ParseToml(const FString& InPath, FSpacetimeCliConfig& OutConfig, FString& OutError)
-{
-	toml::table Table;
-    try
-    {
-        Table = toml::parse_file(TCHAR_TO_UTF8(*InPath));
-    }
-    catch (const toml::parse_error& Ex)
-    {
-        OutError = FString::Printf(TEXT("TOML parse error: %s"), ANSI_TO_TCHAR(Ex.what()));
-        return false;
-    }
-
-    auto ReadString = [&](const char* Key, FString& Dest) -> bool
-    {
-        if (auto Node = Table[Key].as_string())
-        {
-            Dest = UTF8_TO_TCHAR(Node->get().c_str());
-            return true;
-        }
-        OutError = FString::Printf(TEXT("Missing or invalid '%s' in cli.toml"), UTF8_TO_TCHAR(Key));
-        return false;
-    };
-
-    if (!ReadString("default_server", OutConfig.DefaultServer) ||
-        !ReadString("web_session_token", OutConfig.WebSessionToken) ||
-        !ReadString("spacetimedb_token", OutConfig.SpacetimeDBToken))
-    {
-        return false;
-    }
-
-    if (auto Array = Table["server_configs"].as_array())
-    {
-        for (auto& Item : *Array)
-        {
-            if (auto Sub = Item.as_table())
-            {
-                FSpacetimeServerConfig Cfg;
-                if (auto Nick = Sub->get("nickname")->value<std::string>(); Sub->get("nickname")->is_string())
-                {
-                    Cfg.Nickname = UTF8_TO_TCHAR(Nick->c_str());
-                }
-                else { OutError = TEXT("Invalid 'nickname' in server_configs"); return false; }
-
-                if (auto Host = Sub->get("host")->value<std::string>(); Sub->get("host")->is_string())
-                {
-                    Cfg.Host = UTF8_TO_TCHAR(Host->c_str());
-                }
-                else { OutError = TEXT("Invalid 'host' in server_configs"); return false; }
-
-                if (auto Prot = Sub->get("protocol")->value<std::string>(); Sub->get("protocol")->is_string())
-                {
-                    Cfg.Protocol = UTF8_TO_TCHAR(Prot->c_str());
-                }
-                else { OutError = TEXT("Invalid 'protocol' in server_configs"); return false; }
-
-                OutConfig.ServerConfigs.Add(MoveTemp(Cfg));
-            }
-            else
-            {
-                OutError = TEXT("Expected table entry in 'server_configs'");
-                return false;
-            }
-        }
-    }
-    else
-    {
-        OutError = TEXT("Missing or invalid 'server_configs' array");
-        return false;
-    }
-
-    return true;
-}
-
 FString FSpacetimeCLIHelper::GetDefaultCliTomlPath()
 {
 #if PLATFORM_WINDOWS
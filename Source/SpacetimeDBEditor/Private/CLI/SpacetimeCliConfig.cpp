@@ -1,4 +1,87 @@
 #include "CLI/SpacetimeCliConfig.h"
+#include "CLI/SpacetimeCLIHelper.h"
 
-#include "CLI/toml.hpp"
+// The only translation unit that includes toml.hpp, whose templates are slow to compile
+#include "toml.hpp"
 
+bool FSpacetimeCLIHelper::ParseToml(const FString& InPath, FSpacetimeCliConfig& OutConfig, FString& OutError)
+{
+	toml::table Table;
+    try
+    {
+        Table = toml::parse_file(TCHAR_TO_UTF8(*InPath));
+    }
+    catch (const toml::parse_error& Ex)
+    {
+        OutError = FString::Printf(TEXT("TOML parse error: %s"), ANSI_TO_TCHAR(Ex.what()));
+        return false;
+    }
+
+    auto ReadString = [&](const char* Key, FString& Dest) -> bool
+    {
+        if (auto Node = Table[Key].as_string())
+        {
+            Dest = UTF8_TO_TCHAR(Node->get().c_str());
+            return true;
+        }
+        OutError = FString::Printf(TEXT("Missing or invalid '%s' in cli.toml"), UTF8_TO_TCHAR(Key));
+        return false;
+    };
+
+    if (!ReadString("default_server", OutConfig.DefaultServer))
+    {
+        return false;
+    }
+
+    // Logging out removes the tokens, which leaves them empty
+    if (auto Node = Table["web_session_token"].as_string())
+    {
+        OutConfig.WebSessionToken = UTF8_TO_TCHAR(Node->get().c_str());
+    }
+    if (auto Node = Table["spacetimedb_token"].as_string())
+    {
+        OutConfig.SpacetimeDBToken = UTF8_TO_TCHAR(Node->get().c_str());
+    }
+
+    if (auto Array = Table["server_configs"].as_array())
+    {
+        for (auto& Item : *Array)
+        {
+            if (auto Sub = Item.as_table())
+            {
+                FSpacetimeServerConfig Cfg;
+                if (auto Nick = Sub->get("nickname")->value<std::string>(); Sub->get("nickname")->is_string())
+                {
+                    Cfg.Nickname = UTF8_TO_TCHAR(Nick->c_str());
+                }
+                else { OutError = TEXT("Invalid 'nickname' in server_configs"); return false; }
+
+                if (auto Host = Sub->get("host")->value<std::string>(); Sub->get("host")->is_string())
+                {
+                    Cfg.Host = UTF8_TO_TCHAR(Host->c_str());
+                }
+                else { OutError = TEXT("Invalid 'host' in server_configs"); return false; }
+
+                if (auto Prot = Sub->get("protocol")->value<std::string>(); Sub->get("protocol")->is_string())
+                {
+                    Cfg.Protocol = UTF8_TO_TCHAR(Prot->c_str());
+                }
+                else { OutError = TEXT("Invalid 'protocol' in server_configs"); return false; }
+
+                OutConfig.ServerConfigs.Add(MoveTemp(Cfg));
+            }
+            else
+            {
+                OutError = TEXT("Expected table entry in 'server_configs'");
+                return false;
+            }
+        }
+    }
+    else
+    {
+        OutError = TEXT("Missing or invalid 'server_configs' array");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,170 @@
+#include "CLI/SpacetimeCliStatusService.h"
+
+#include "Async/Async.h"
+#include "CLI/SpacetimeCLIHelper.h"
+#include "DirectoryWatcherModule.h"
+#include "HAL/FileManager.h"
+#include "IDirectoryWatcher.h"
+#include "Modules/ModuleManager.h"
+
+namespace
+{
+	TSharedPtr<FSpacetimeCliStatusService> GCliStatusService;
+}
+
+FSpacetimeCliStatusService& FSpacetimeCliStatusService::Get()
+{
+	check(IsInGameThread());
+	if (!GCliStatusService.IsValid())
+	{
+		GCliStatusService = MakeShared<FSpacetimeCliStatusService>();
+	}
+	return *GCliStatusService;
+}
+
+void FSpacetimeCliStatusService::Shutdown()
+{
+	if (GCliStatusService.IsValid())
+	{
+		GCliStatusService->StopWatching();
+		GCliStatusService.Reset();
+	}
+}
+
+FSpacetimeCliStatusService::~FSpacetimeCliStatusService()
+{
+	StopWatching();
+}
+
+void FSpacetimeCliStatusService::Refresh(const bool bForce)
+{
+	if (bProbing)
+	{
+		return;
+	}
+
+	const double Age = FPlatformTime::Seconds() - Status.ProbeTime;
+	if (bHasStatus && Age < (bForce ? MinProbeInterval : FMath::Max(TimeToLive, Backoff.GetDelay())))
+	{
+		return;
+	}
+	StartProbe();
+}
+
+void FSpacetimeCliStatusService::StartProbe()
+{
+	bProbing = true;
+	WatchConfigDirectory();
+
+	TWeakPtr<FSpacetimeCliStatusService> WeakThis = AsShared();
+	Async(EAsyncExecution::ThreadPool, [WeakThis]()
+	{
+		FSpacetimeCliStatus NewStatus;
+		NewStatus.bCliAvailable = FSpacetimeCLIHelper::IsCliAvailable();
+		NewStatus.bLoggedIn = NewStatus.bCliAvailable && FSpacetimeCLIHelper::IsLoggedIn();
+		if (NewStatus.bLoggedIn && !FSpacetimeCLIHelper::GetCliConfig(NewStatus.Config, NewStatus.ConfigError))
+		{
+			NewStatus.Config = FSpacetimeCliConfig();
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, NewStatus = MoveTemp(NewStatus)]() mutable
+		{
+			if (const TSharedPtr<FSpacetimeCliStatusService> This = WeakThis.Pin())
+			{
+				This->FinishProbe(MoveTemp(NewStatus));
+			}
+		});
+	});
+}
+
+void FSpacetimeCliStatusService::FinishProbe(FSpacetimeCliStatus&& NewStatus)
+{
+	if (!NewStatus.ConfigError.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Failed to load cli.toml: %s"), *NewStatus.ConfigError);
+	}
+
+	if (NewStatus.bCliAvailable)
+	{
+		Backoff.RecordSuccess();
+	}
+	else
+	{
+		Backoff.RecordFailure();
+	}
+
+	Status = MoveTemp(NewStatus);
+	Status.ProbeTime = FPlatformTime::Seconds();
+	bHasStatus = true;
+	bProbing = false;
+
+	// Whatever the CLI wrote while it was probed is part of this result, not a change to react to
+	IFileManager& FileManager = IFileManager::Get();
+	ConfigTimeStamp = FileManager.GetTimeStamp(*ConfigPath);
+	ConfigSize = FileManager.FileSize(*ConfigPath);
+
+	OnStatusChanged.Broadcast(Status);
+}
+
+void FSpacetimeCliStatusService::WatchConfigDirectory()
+{
+	ConfigPath = FSpacetimeCLIHelper::GetDefaultCliTomlPath();
+	const FString Directory = FPaths::GetPath(ConfigPath);
+	if (Directory.IsEmpty() || Directory == WatchedDirectory || !IFileManager::Get().DirectoryExists(*Directory))
+	{
+		// Without a directory yet there is nothing to log in to; the next probe tries again
+		return;
+	}
+
+	StopWatching();
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get())
+	{
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+				Directory,
+				IDirectoryWatcher::FDirectoryChanged::CreateSP(this, &FSpacetimeCliStatusService::HandleDirectoryChanged),
+				WatchHandle,
+				IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree))
+		{
+			WatchedDirectory = Directory;
+		}
+	}
+}
+
+void FSpacetimeCliStatusService::StopWatching()
+{
+	if (WatchedDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory, WatchHandle);
+		}
+	}
+	WatchedDirectory.Empty();
+	WatchHandle.Reset();
+}
+
+void FSpacetimeCliStatusService::HandleDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+	const bool bConfigTouched = Changes.ContainsByPredicate([](const FFileChangeData& Change)
+	{
+		return FPaths::GetCleanFilename(Change.Filename).Equals(TEXT("cli.toml"), ESearchCase::IgnoreCase);
+	});
+
+	// A change during a probe is most likely the probed CLI itself; FinishProbe records it
+	if (bConfigTouched && !bProbing && HasConfigChanged())
+	{
+		StartProbe();
+	}
+}
+
+bool FSpacetimeCliStatusService::HasConfigChanged() const
+{
+	IFileManager& FileManager = IFileManager::Get();
+	return FileManager.GetTimeStamp(*ConfigPath) != ConfigTimeStamp || FileManager.FileSize(*ConfigPath) != ConfigSize;
+}
@@ -0,0 +1,85 @@
+#include "SpacetimeCodegenCache.h"
+
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+FCriticalSection FSpacetimeCodegenCache::Lock;
+TMap<FString, FString> FSpacetimeCodegenCache::RawSchemas;
+TMap<FString, TSharedRef<const FSpacetimeParsedModule>> FSpacetimeCodegenCache::ParsedModules;
+FSpacetimeCodegenCache::FOnModuleParsed FSpacetimeCodegenCache::OnModuleParsed;
+
+bool FSpacetimeCodegenCache::FindRawSchema(const FString& DatabaseName, FString& OutRawSchema)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (const FString* Cached = RawSchemas.Find(DatabaseName))
+		{
+			OutRawSchema = *Cached;
+			return true;
+		}
+	}
+
+	// Saved by an earlier editor session
+	FString Saved;
+	if (!FFileHelper::LoadFileToString(Saved, *GetRawSchemaPath(DatabaseName)))
+	{
+		return false;
+	}
+	FScopeLock ScopeLock(&Lock);
+	OutRawSchema = RawSchemas.FindOrAdd(DatabaseName, MoveTemp(Saved));
+	return true;
+}
+
+void FSpacetimeCodegenCache::AddRawSchema(const FString& DatabaseName, const FString& RawSchema)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		RawSchemas.Add(DatabaseName, RawSchema);
+	}
+
+	if (!FFileHelper::SaveStringToFile(RawSchema, *GetRawSchemaPath(DatabaseName), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Could not save the RawModuleDef of '%s' to %s"), *DatabaseName, *GetRawSchemaPath(DatabaseName));
+	}
+}
+
+FString FSpacetimeCodegenCache::GetRawSchemaPath(const FString& DatabaseName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("SpacetimeDB/Schemas") / DatabaseName + TEXT(".json");
+}
+
+void FSpacetimeCodegenCache::AddParsedModule(const TSharedRef<const FSpacetimeParsedModule>& Module)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		ParsedModules.Add(Module->DatabaseName, Module);
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [DatabaseName = Module->DatabaseName]
+	{
+		OnModuleParsed.Broadcast(DatabaseName);
+	});
+}
+
+TSharedPtr<const FSpacetimeParsedModule> FSpacetimeCodegenCache::FindParsedModule(const FString& DatabaseName)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (const TSharedRef<const FSpacetimeParsedModule>* Module = ParsedModules.Find(DatabaseName))
+	{
+		return *Module;
+	}
+	return nullptr;
+}
+
+TArray<FString> FSpacetimeCodegenCache::GetParsedDatabaseNames()
+{
+	TArray<FString> Names;
+	{
+		FScopeLock ScopeLock(&Lock);
+		ParsedModules.GetKeys(Names);
+	}
+	Names.Sort();
+	return Names;
+}
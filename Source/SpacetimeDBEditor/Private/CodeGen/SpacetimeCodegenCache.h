@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Schema/RawModuleDefSchema.h"
+#include "TypespaceStructIRBuilder.h"
+
+/** A database's schema as code generation last parsed it. */
+struct FSpacetimeParsedModule
+{
+	FString DatabaseName;
+	SATS::FRawModuleDef RawModule;
+
+	/** IR of the exported types as built, before any moved to the shared header; has the generated Unreal names. */
+	FHeader ExportedTypesHeader;
+
+	/** UTC. */
+	FDateTime ParseTime;
+};
+
+/**
+ * What code generation keeps of the databases it saw: the raw schema, which a later run reuses for
+ * databases it knows did not change, and the parsed model, which the schema browser shows without
+ * describing the database again. Raw schemas are also saved under Saved/SpacetimeDB/Schemas, so they
+ * outlive the editor session.
+ *
+ * Any thread; OnModuleParsed fires on the game thread.
+ */
+class FSpacetimeCodegenCache
+{
+public:
+	static bool FindRawSchema(const FString& DatabaseName, FString& OutRawSchema);
+	static void AddRawSchema(const FString& DatabaseName, const FString& RawSchema);
+
+	/** Replaces the database's model; its users keep the one they hold. */
+	static void AddParsedModule(const TSharedRef<const FSpacetimeParsedModule>& Module);
+	static TSharedPtr<const FSpacetimeParsedModule> FindParsedModule(const FString& DatabaseName);
+
+	/** Databases with a parsed model, sorted. */
+	static TArray<FString> GetParsedDatabaseNames();
+
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnModuleParsed, const FString& /*DatabaseName*/);
+
+	/** Game thread, once a database's model was added or replaced. */
+	static FOnModuleParsed OnModuleParsed;
+
+private:
+	static FString GetRawSchemaPath(const FString& DatabaseName);
+
+	static FCriticalSection Lock;
+	static TMap<FString, FString> RawSchemas;
+	static TMap<FString, TSharedRef<const FSpacetimeParsedModule>> ParsedModules;
+};
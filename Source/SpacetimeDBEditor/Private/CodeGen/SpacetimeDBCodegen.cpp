@@ -1,6 +1,7 @@
 #include "SpacetimeDBCodegen.h"
 
 #include "TypespaceStructIRBuilder.h"
+#include "Algo/AllOf.h"
 #include "Containers/UnrealString.h"
 #include "Parser/Common.h"
 #include "../Config.h"
@@ -64,64 +65,524 @@ FString FSpacetimeDBCodeGen::ResolveAlgebraicTypeToUnrealCxx(const SATS::FAlgebr
     }    
 }
 
-bool FSpacetimeDBCodeGen::GenerateTableStructs(
+static const FStruct* FindStruct(const FHeader& Header, const FString& StructName)
+{
+    return Header.GetStructs().FindByPredicate([&StructName](const FStruct& Struct)
+    {
+        return Struct.Name == StructName;
+    });
+}
+
+static const SATS::FExportedType* FindExportedType(const SATS::FRawModuleDef& ModuleDef, const int32 TypeRef)
+{
+    return ModuleDef.Types.FindByPredicate([TypeRef](const SATS::FExportedType& Type)
+    {
+        return Type.TypeRef == TypeRef;
+    });
+}
+
+// The row struct's member for a key column, unless its type has no Unreal representation
+static const FAttribute* FindIndexKeyAttribute(const FStruct& RowStruct, const FString& Column)
+{
+    const FString FieldName = FCommon::ToPascalCase(Column);
+    const FAttribute* Attribute = RowStruct.Attributes.FindByPredicate([&FieldName](const FAttribute& Attr)
+    {
+        return Attr.Name == FieldName;
+    });
+    return Attribute && !Attribute->Type.StartsWith(TEXT("//")) ? Attribute : nullptr;
+}
+
+TArray<FString> FSpacetimeDBCodeGen::GetIndexAccessors(const SATS::FTableDef& Table, const FStruct& RowStruct)
+{
+    TArray<FString> Accessors;
+    TArray<FString> UsedAccessors;
+    for (const auto& Index : Table.Indexes)
+    {
+        FString& Accessor = Accessors.AddDefaulted_GetRef();
+        const bool bHasUnrealKey = Algo::AllOf(Index.Columns, [&RowStruct](const FString& Column)
+        {
+            return FindIndexKeyAttribute(RowStruct, Column) != nullptr;
+        });
+        if (!bHasUnrealKey)
+        {
+            continue;
+        }
+
+        const FString BaseAccessor = ToPascalCase(Index.AccessorName.IsSet()
+            ? Index.AccessorName.GetValue()
+            : FString::Join(Index.Columns, TEXT("_")));
+        Accessor = BaseAccessor;
+        for (int32 Suffix = 2; UsedAccessors.Contains(Accessor); ++Suffix)
+        {
+            Accessor = BaseAccessor + FString::FromInt(Suffix);
+        }
+        UsedAccessors.Add(Accessor);
+    }
+    return Accessors;
+}
+
+// Builtins the generated key funcs order as SpacetimeDB does, see GOutputIndexKeyFuncs
+static bool IsOrderedColumn(const SATS::EType Tag)
+{
+    return SATS::IsBuiltIn(Tag)
+        && Tag != SATS::EType::I256
+        && Tag != SATS::EType::U256
+        && Tag != SATS::EType::Array
+        && Tag != SATS::EType::Map;
+}
+
+// Emits the key funcs of a client-side index over the given key columns (a TTuple when there are several).
+// Strings compare case-sensitively, and signed/unsigned columns stored in an Unreal type of the other
+// signedness compare through a cast, so the index agrees with SpacetimeDB on equality and order.
+static FString GOutputIndexKeyFuncs(const FString& Name, const FString& KeyType, const TArray<SATS::EType>& Tags, const bool bOrdered)
+{
+    const FString Tab = FSpacetimeConfig::TabString;
+    auto Column = [&Tags](const TCHAR* Key, const int32 Position)
+    {
+        return Tags.Num() == 1 ? FString(Key) : FString::Printf(TEXT("%s.Get<%d>()"), Key, Position);
+    };
+
+    TArray<FString> Equalities;
+    TArray<FString> Hashes;
+    FString Ordering;
+    for (int32 i = 0; i < Tags.Num(); ++i)
+    {
+        const FString A = Column(TEXT("A"), i);
+        const FString B = Column(TEXT("B"), i);
+        const FString Key = Column(TEXT("Key"), i);
+        const TCHAR* Cast = Tags[i] == SATS::EType::I8 ? TEXT("int8")
+            : Tags[i] == SATS::EType::U32 ? TEXT("uint32")
+            : Tags[i] == SATS::EType::U64 ? TEXT("uint64")
+            : nullptr;
+
+        if (Tags[i] == SATS::EType::String)
+        {
+            Equalities.Add(FString::Printf(TEXT("%s.Equals(%s, ESearchCase::CaseSensitive)"), *A, *B));
+            Hashes.Add(FString::Printf(TEXT("FCrc::StrCrc32(*%s)"), *Key));
+            Ordering += Tab + Tab + Tab + FString::Printf(TEXT("if (const int32 Order = %s.Compare(%s, ESearchCase::CaseSensitive)) return Order < 0;\n"), *A, *B);
+        }
+        else
+        {
+            Equalities.Add(A + TEXT(" == ") + B);
+            Hashes.Add(TEXT("GetTypeHash(") + Key + TEXT(")"));
+            const FString OrderA = Cast ? FString::Printf(TEXT("static_cast<%s>(%s)"), Cast, *A) : A;
+            const FString OrderB = Cast ? FString::Printf(TEXT("static_cast<%s>(%s)"), Cast, *B) : B;
+            Ordering += Tab + Tab + Tab + FString::Printf(TEXT("if (%s != %s) return %s < %s;\n"), *OrderA, *OrderB, *OrderA, *OrderB);
+        }
+    }
+
+    FString Code = Tab + FString::Printf(TEXT("struct %s\n"), *Name) + Tab + TEXT("{\n");
+    Code += Tab + Tab + FString::Printf(TEXT("static bool Equals(const %s& A, const %s& B)\n"), *KeyType, *KeyType);
+    Code += Tab + Tab + TEXT("{\n");
+    Code += Tab + Tab + Tab + TEXT("return ") + FString::Join(Equalities, TEXT(" && ")) + TEXT(";\n");
+    Code += Tab + Tab + TEXT("}\n\n");
+    if (bOrdered)
+    {
+        Code += Tab + Tab + FString::Printf(TEXT("static bool Less(const %s& A, const %s& B)\n"), *KeyType, *KeyType);
+        Code += Tab + Tab + TEXT("{\n");
+        Code += Ordering;
+        Code += Tab + Tab + Tab + TEXT("return false;\n");
+        Code += Tab + Tab + TEXT("}\n\n");
+    }
+    Code += Tab + Tab + FString::Printf(TEXT("static uint32 GetKeyHash(const %s& Key)\n"), *KeyType);
+    Code += Tab + Tab + TEXT("{\n");
+    Code += Tab + Tab + Tab + TEXT("uint32 Hash = 0;\n");
+    for (const FString& ColumnHash : Hashes)
+    {
+        Code += Tab + Tab + Tab + TEXT("Hash = HashCombine(Hash, ") + ColumnHash + TEXT(");\n");
+    }
+    Code += Tab + Tab + Tab + TEXT("return Hash;\n");
+    Code += Tab + Tab + TEXT("}\n");
+    Code += Tab + TEXT("};\n\n");
+    return Code;
+}
+
+static FString GBsatnReadExpression(const FAttribute& Attribute, const FString& Target);
+static FString GBsatnWriteStatement(const FAttribute& Attribute, const FString& Source, const FString& Indent);
+
+// Size of a column on the wire, or INDEX_NONE if it varies from row to row
+static int32 GBsatnFixedSize(const FAttribute& Attribute)
+{
+    if (Attribute.Type == TEXT("FInt256") || Attribute.Type == TEXT("FUInt256"))
+    {
+        return 32;
+    }
+
+    switch (Attribute.WireType)
+    {
+    case SATS::EType::Bool:
+    case SATS::EType::I8:
+    case SATS::EType::U8:   return 1;
+    case SATS::EType::I16:
+    case SATS::EType::U16:  return 2;
+    case SATS::EType::I32:
+    case SATS::EType::U32:
+    case SATS::EType::F32:  return 4;
+    case SATS::EType::I64:
+    case SATS::EType::U64:
+    case SATS::EType::F64:  return 8;
+    case SATS::EType::I256:
+    case SATS::EType::U256: return 32;
+    default:                return INDEX_NONE;
+    }
+}
+
+// Emits a lazy row view with one getter per column; returns the columns that got a getter
+static TSet<FString> GOutputRowView(const FStruct& RowStruct, const FString& TableName, const FString& ViewName, FString& OutCode)
+{
+    const FString Tab = FSpacetimeConfig::TabString;
+    TSet<FString> Columns;
+
+    OutCode += FString::Printf(TEXT("/* Row of table '%s' that stays BSATN-encoded and decodes columns on demand */\n"), *TableName);
+    OutCode += FString::Printf(TEXT("class %s : public FSpacetimeRowView\n{\npublic:\n"), *ViewName);
+    OutCode += Tab + TEXT("using FSpacetimeRowView::FSpacetimeRowView;\n\n");
+
+    // Columns up to the first variable-size one sit at the same offset in every row
+    int32 PrefixSize = 0;
+    bool bInPrefix = true;
+    TArray<const FAttribute*> Skipped;
+    for (const FAttribute& Attribute : RowStruct.Attributes)
+    {
+        const FString Read = GBsatnReadExpression(Attribute, TEXT("Out"));
+        if (Read.IsEmpty() || Attribute.Type.StartsWith(TEXT("//")))
+        {
+            OutCode += Tab + FString::Printf(TEXT("// '%s' and later columns have no codec; use Materialize()\n\n"), *Attribute.Name);
+            break;
+        }
+
+        OutCode += Tab + FString::Printf(TEXT("%s Get%s() const\n"), *Attribute.Type, *Attribute.Name);
+        OutCode += Tab + TEXT("{\n");
+        OutCode += Tab + Tab + FString::Printf(TEXT("FSpacetimeBsatnReader Reader = MakeReader(%d);\n"), PrefixSize);
+        for (int32 i = 0; i < Skipped.Num(); ++i)
+        {
+            const FString SkippedName = FString::Printf(TEXT("Skipped%d"), i);
+            OutCode += Tab + Tab + FString::Printf(TEXT("%s %s;\n"), *Skipped[i]->Type, *SkippedName);
+            OutCode += Tab + Tab + GBsatnReadExpression(*Skipped[i], SkippedName) + TEXT(";\n");
+        }
+        OutCode += Tab + Tab + Attribute.Type + TEXT(" Out{};\n");
+        OutCode += Tab + Tab + Read + TEXT(";\n");
+        OutCode += Tab + Tab + TEXT("return Out;\n");
+        OutCode += Tab + TEXT("}\n\n");
+        Columns.Add(Attribute.Name);
+
+        const int32 Size = GBsatnFixedSize(Attribute);
+        if (bInPrefix && Size != INDEX_NONE)
+        {
+            PrefixSize += Size;
+        }
+        else
+        {
+            bInPrefix = false;
+            Skipped.Add(&Attribute);
+        }
+    }
+
+    OutCode += Tab + FString::Printf(TEXT("%s Materialize() const\n"), *RowStruct.Name);
+    OutCode += Tab + TEXT("{\n");
+    OutCode += Tab + Tab + FString::Printf(TEXT("return MaterializeAs<%s>();\n"), *RowStruct.Name);
+    OutCode += Tab + TEXT("}\n};\n\n\n");
+
+    return Columns;
+}
+
+bool FSpacetimeDBCodeGen::GenerateTableCaches(
     const SATS::FRawModuleDef& ModuleDef,
-    const FString& HeaderName,
+    const FString& ModuleName,
+    const FHeader& ExportedTypesHeader,
     FString& OutHeader,
     FString& OutError)
 {
-    FString OutHeaderText;
-    OutHeaderText += TEXT("#pragma once\n\n"
-                   "#include \"CoreMinimal.h\"\n"
-                   "#include \"UObject/NoExportTypes.h\"\n"
-                   "#include \"" + HeaderName + ".generated.h\"\n\n\n");
+    const FString Tab = FSpacetimeConfig::TabString;
+    const FString ModulePascal = ToPascalCase(ModuleName);
+
+    FString Code;
+    Code += TEXT("#pragma once\n\n"
+                 "#include \"CoreMinimal.h\"\n"
+                 "#include \"Cache/SpacetimeClientCache.h\"\n"
+                 "#include \"Cache/SpacetimeRowView.h\"\n");
+    Code += TEXT("#include \"") + FSpacetimeConfig::MakeCodecCodeFileName(ModuleName) + TEXT(".h\"\n\n\n");
+
+    FString AggregateMembers;
+    FString AggregateConstruction;
+    FString AggregateRegistration;
+
+    // Everything that shapes the cached bytes: tables and the layout of the exported types
+    FString Layout;
+    for (const auto& Struct : ExportedTypesHeader.GetStructs())
+    {
+        Layout += Struct.Name + TEXT("{");
+        for (const auto& Attribute : Struct.Attributes)
+        {
+            Layout += Attribute.Name + TEXT(":") + Attribute.Type + TEXT(":") + SATS::TypeToString(Attribute.WireType) + TEXT(";");
+        }
+        Layout += TEXT("}");
+    }
+    for (const auto& TaggedUnion : ExportedTypesHeader.GetTaggedUnions())
+    {
+        Layout += TaggedUnion.BaseName + TEXT("<");
+        for (const auto& Variant : TaggedUnion.Variants)
+        {
+            Layout += Variant.Name + TEXT(":") + Variant.Type + TEXT(":") + SATS::TypeToString(Variant.WireType) + TEXT(";");
+        }
+        Layout += TEXT(">");
+    }
+
+    struct FClientIndex
+    {
+        FString Name;
+        FString Accessor;
+        TArray<FString> Columns;
+        TArray<FString> Fields;
+        TArray<FString> FieldTypes;
+        TArray<SATS::EType> FieldTags;
+        bool bOrdered = false;
+    };
 
     for (const auto& Table : ModuleDef.Tables)
     {
-        // Lookup product definition
-        const int ProductTypeRef = Table.ProductTypeRef;
-        const auto& ProductType = ModuleDef.Typespace.TypeEntries[ProductTypeRef];
-        if (ProductType.Tag != SATS::EType::Product)
+        if (!ModuleDef.Typespace.TypeEntries.IsValidIndex(Table.ProductTypeRef)
+            || ModuleDef.Typespace.TypeEntries[Table.ProductTypeRef].Tag != SATS::EType::Product)
         {
-            OutError = TEXT("Table type is expected to be a SATS Product type.");
+            OutError = FString::Printf(TEXT("Table '%s' type is expected to be a SATS Product type."), *Table.Name);
             return false;
         }
+        const auto& RowElements = ModuleDef.Typespace.TypeEntries[Table.ProductTypeRef].Product.Elements;
 
-        FString StructName = TEXT("F") + ToPascalCase(Table.Name) + TEXT("Row");
-        OutHeaderText += TEXT("USTRUCT(BlueprintType)");
-        OutHeaderText += TEXT("\nstruct ") + FSpacetimeConfig::ApiMacroString + " " + StructName + TEXT(" {\n\n"
-            "    GENERATED_BODY()\n\n");
+        const SATS::FExportedType* RowType = FindExportedType(ModuleDef, Table.ProductTypeRef);
+        if (!RowType)
+        {
+            OutError = FString::Printf(TEXT("Table '%s' row type (ref %d) is not exported in 'types'"),
+                *Table.Name, Table.ProductTypeRef);
+            return false;
+        }
 
-        /*
-        for (const auto& [Name, AlgebraicKind] : ProductElements)
+        const FString RowStructName = FCommon::MakeStructName(RowType->Name.Name, ModuleName);
+        const FStruct* RowStruct = FindStruct(ExportedTypesHeader, RowStructName);
+        if (!RowStruct)
         {
-            FString CxxTypeString = ResolveAlgebraicTypeToUnrealCxx(AlgebraicKind);
-            
-            // FString CxxTypeString = MapBuiltin(ModuleDef.Typespace.TypeEntries[Type_Ref].Builtin); 
-            if (!IsBuiltinWithNativeRepresentation(AlgebraicKind->Tag))
+            OutError = FString::Printf(TEXT("Row struct '%s' of table '%s' was not generated"), *RowStructName, *Table.Name);
+            return false;
+        }
+
+        const FString TablePascal = ModulePascal + ToPascalCase(Table.Name);
+        Layout += Table.Name + TEXT("=") + RowStructName + TEXT(";");
+
+        // Resolve key column types of the client-side indexes from the generated row struct
+        TArray<FClientIndex> ClientIndexes;
+        const TArray<FString> Accessors = GetIndexAccessors(Table, *RowStruct);
+        for (int32 IndexPos = 0; IndexPos < Table.Indexes.Num(); ++IndexPos)
+        {
+            const auto& Index = Table.Indexes[IndexPos];
+            if (Accessors[IndexPos].IsEmpty())
             {
-                Implement
+                UE_LOG(LogTemp, Warning, TEXT("[spacetime] Skipping client index '%s' of table '%s': "
+                    "column type has no Unreal representation"), *Index.Name, *Table.Name);
+                continue;
             }
-            else
+
+            FClientIndex& ClientIndex = ClientIndexes.AddDefaulted_GetRef();
+            ClientIndex.Name = Index.Name;
+            ClientIndex.Accessor = Accessors[IndexPos];
+            ClientIndex.Columns = Index.Columns;
+            ClientIndex.bOrdered = Index.Algorithm != SATS::EIndexAlgorithm::Hash;
+            for (int32 i = 0; i < Index.Columns.Num(); ++i)
             {
-                Implement
+                const FString FieldName = FCommon::ToPascalCase(Index.Columns[i]);
+                ClientIndex.Fields.Add(FieldName);
+                ClientIndex.FieldTypes.Add(FindIndexKeyAttribute(*RowStruct, Index.Columns[i])->Type);
+                ClientIndex.FieldTags.Add(RowElements[Index.ColumnIds[i]].AlgebraicType->Tag);
+                ClientIndex.bOrdered &= IsOrderedColumn(ClientIndex.FieldTags.Last());
+            }
+            if (!ClientIndex.bOrdered && Index.Algorithm != SATS::EIndexAlgorithm::Hash)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("[spacetime] Client index '%s' of table '%s' falls back to hashing; "
+                    "its key has no Unreal ordering, range queries are unavailable"), *Index.Name, *Table.Name);
+            }
+        }
+
+        TArray<FString> KeyFields;
+        TSet<FString> StringKeyFields;
+        for (const FString& Column : Table.PrimaryKey)
+        {
+            KeyFields.Add(FCommon::ToPascalCase(Column));
+            const FAttribute* KeyAttribute = FindIndexKeyAttribute(*RowStruct, Column);
+            if (KeyAttribute && KeyAttribute->Type == TEXT("FString"))
+            {
+                StringKeyFields.Add(KeyFields.Last());
             }
-            
-            FString Prop = FString::Printf(
-                TEXT("    UPROPERTY(BlueprintReadWrite) %s %s;\n"),
-                *CxxTypeString, *ToPascalCase(Name)
-            );
-            
-            OutHeaderText += Prop;
         }
-        OutHeaderText += TEXT("};\n\n\n");
-        */
+
+        // Emits one cache class over CachedRowType, whose columns are read through ReadColumn
+        auto EmitTableClass = [&](const FString& ClassName, const FString& CachedRowType, const TSet<FString>& Readable,
+            const TFunctionRef<FString(const FString&, const FString&)> ReadColumn)
+        {
+            auto CanRead = [&Readable](const TArray<FString>& Fields)
+            {
+                return Algo::AllOf(Fields, [&Readable](const FString& Field) { return Readable.Contains(Field); });
+            };
+
+            FString PublicCode;
+            FString PrivateCode;
+            TArray<FString> IndexMembers;
+
+            for (const FClientIndex& Index : ClientIndexes)
+            {
+                if (!CanRead(Index.Fields))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("[spacetime] Skipping index '%s' of '%s': a key column cannot be read lazily"),
+                        *Index.Name, *ClassName);
+                    continue;
+                }
+
+                FString KeyType;
+                FString KeyExpr;
+                if (Index.Fields.Num() == 1)
+                {
+                    KeyType = Index.FieldTypes[0];
+                    KeyExpr = ReadColumn(TEXT("Row"), Index.Fields[0]);
+                }
+                else
+                {
+                    TArray<FString> KeyParts;
+                    for (const FString& Field : Index.Fields)
+                    {
+                        KeyParts.Add(ReadColumn(TEXT("Row"), Field));
+                    }
+                    KeyType = TEXT("TTuple<") + FString::Join(Index.FieldTypes, TEXT(", ")) + TEXT(">");
+                    KeyExpr = TEXT("MakeTuple(") + FString::Join(KeyParts, TEXT(", ")) + TEXT(")");
+                }
+
+                const FString KeyFuncs = TEXT("F") + Index.Accessor + TEXT("KeyFuncs");
+                const FString IndexType = FString::Printf(TEXT("%s<%s, %s, %s>"),
+                    Index.bOrdered ? TEXT("TSpacetimeBTreeIndex") : TEXT("TSpacetimeHashIndex"), *CachedRowType, *KeyType, *KeyFuncs);
+                const FString IndexMember = Index.Accessor + TEXT("Index");
+                const FString RowsOut = FString::Printf(TEXT("TArray<const %s*>& OutRows"), *CachedRowType);
+                IndexMembers.Add(IndexMember);
+
+                PublicCode += Tab + FString::Printf(TEXT("/* %s index '%s' on (%s) */\n"),
+                    Index.bOrdered ? TEXT("BTree") : TEXT("Hash"), *Index.Name, *FString::Join(Index.Columns, TEXT(", ")));
+                PublicCode += Tab + FString::Printf(TEXT("void FindBy%s(const %s& Key, %s) const\n"), *Index.Accessor, *KeyType, *RowsOut);
+                PublicCode += Tab + TEXT("{\n");
+                PublicCode += Tab + Tab + TEXT("TArray<FSpacetimeRowHandle> Handles;\n");
+                PublicCode += Tab + Tab + IndexMember + TEXT("->Find(Key, Handles);\n");
+                PublicCode += Tab + Tab + TEXT("ResolveHandles(Handles, OutRows);\n");
+                PublicCode += Tab + TEXT("}\n\n");
+
+                if (Index.bOrdered)
+                {
+                    PublicCode += Tab + FString::Printf(TEXT("void FindBy%sRange(const %s& Min, const %s& Max, %s) const\n"),
+                        *Index.Accessor, *KeyType, *KeyType, *RowsOut);
+                    PublicCode += Tab + TEXT("{\n");
+                    PublicCode += Tab + Tab + TEXT("TArray<FSpacetimeRowHandle> Handles;\n");
+                    PublicCode += Tab + Tab + IndexMember + TEXT("->FindRange(Min, Max, Handles);\n");
+                    PublicCode += Tab + Tab + TEXT("ResolveHandles(Handles, OutRows);\n");
+                    PublicCode += Tab + TEXT("}\n\n");
+                }
+
+                PrivateCode += GOutputIndexKeyFuncs(KeyFuncs, KeyType, Index.FieldTags, Index.bOrdered);
+                PrivateCode += Tab + FString::Printf(TEXT("TSharedRef<%s> %s = MakeShared<%s>(\n"), *IndexType, *IndexMember, *IndexType);
+                PrivateCode += Tab + Tab + FString::Printf(TEXT("[](const %s& Row) { return %s; });\n\n"), *CachedRowType, *KeyExpr);
+            }
+
+            // Primary key, used to pair a delete and an insert of the same row into an update
+            FString ProtectedCode;
+            if (!KeyFields.IsEmpty() && CanRead(KeyFields))
+            {
+                TArray<FString> Comparisons;
+                ProtectedCode += Tab + TEXT("virtual bool HasPrimaryKey() const override { return true; }\n\n");
+                ProtectedCode += Tab + FString::Printf(TEXT("virtual bool GetPrimaryKeyHash(const %s& Row, uint32& OutHash) const override\n"), *CachedRowType);
+                ProtectedCode += Tab + TEXT("{\n");
+                ProtectedCode += Tab + Tab + TEXT("OutHash = 0;\n");
+                for (const FString& Field : KeyFields)
+                {
+                    if (StringKeyFields.Contains(Field))
+                    {
+                        ProtectedCode += Tab + Tab + FString::Printf(TEXT("OutHash = HashCombine(OutHash, FCrc::StrCrc32(*%s));\n"), *ReadColumn(TEXT("Row"), Field));
+                        Comparisons.Add(FString::Printf(TEXT("%s.Equals(%s, ESearchCase::CaseSensitive)"), *ReadColumn(TEXT("A"), Field), *ReadColumn(TEXT("B"), Field)));
+                    }
+                    else
+                    {
+                        ProtectedCode += Tab + Tab + FString::Printf(TEXT("OutHash = HashCombine(OutHash, GetTypeHash(%s));\n"), *ReadColumn(TEXT("Row"), Field));
+                        Comparisons.Add(ReadColumn(TEXT("A"), Field) + TEXT(" == ") + ReadColumn(TEXT("B"), Field));
+                    }
+                }
+                ProtectedCode += Tab + Tab + TEXT("return true;\n");
+                ProtectedCode += Tab + TEXT("}\n\n");
+                ProtectedCode += Tab + FString::Printf(TEXT("virtual bool HasSamePrimaryKey(const %s& A, const %s& B) const override\n"), *CachedRowType, *CachedRowType);
+                ProtectedCode += Tab + TEXT("{\n");
+                ProtectedCode += Tab + Tab + TEXT("return ") + FString::Join(Comparisons, TEXT(" && ")) + TEXT(";\n");
+                ProtectedCode += Tab + TEXT("}\n\n");
+            }
+
+            Code += FString::Printf(TEXT("class %s : public TSpacetimeTableCache<%s>\n{\npublic:\n"), *ClassName, *CachedRowType);
+            Code += Tab + ClassName + TEXT("()\n");
+            Code += Tab + Tab + FString::Printf(TEXT(": TSpacetimeTableCache<%s>(TEXT(\"%s\"))\n"), *CachedRowType, *Table.Name);
+            Code += Tab + TEXT("{\n");
+            for (const FString& IndexMember : IndexMembers)
+            {
+                Code += Tab + Tab + TEXT("AddIndex(") + IndexMember + TEXT(");\n");
+            }
+            Code += Tab + TEXT("}\n\n");
+            Code += PublicCode;
+            if (!ProtectedCode.IsEmpty())
+            {
+                Code += TEXT("protected:\n") + ProtectedCode;
+            }
+            if (!PrivateCode.IsEmpty())
+            {
+                Code += TEXT("private:\n") + PrivateCode;
+            }
+            Code.RemoveFromEnd(TEXT("\n"));
+            Code += TEXT("};\n\n\n");
+        };
+
+        TSet<FString> StructFields;
+        for (const FAttribute& Attribute : RowStruct->Attributes)
+        {
+            StructFields.Add(Attribute.Name);
+        }
+
+        const FString ClassName = TEXT("F") + TablePascal + TEXT("Table");
+        Code += FString::Printf(TEXT("/* Client cache of table '%s' */\n"), *Table.Name);
+        EmitTableClass(ClassName, RowStructName, StructFields, [](const FString& Row, const FString& Field)
+        {
+            return Row + TEXT(".") + Field;
+        });
+
+        const FString ViewName = TEXT("F") + TablePascal + TEXT("RowView");
+        const FString LazyClassName = TEXT("F") + TablePascal + TEXT("LazyTable");
+        const TSet<FString> ViewColumns = GOutputRowView(*RowStruct, Table.Name, ViewName, Code);
+        Code += FString::Printf(TEXT("/* Client cache of table '%s' that keeps rows encoded, see %s */\n"), *Table.Name, *ViewName);
+        EmitTableClass(LazyClassName, ViewName, ViewColumns, [](const FString& Row, const FString& Field)
+        {
+            return Row + TEXT(".Get") + Field + TEXT("()");
+        });
+
+        const FString MemberName = ToPascalCase(Table.Name);
+        AggregateMembers += Tab + FString::Printf(TEXT("TSharedPtr<%s> %s;\n"), *ClassName, *MemberName);
+        AggregateMembers += Tab + FString::Printf(TEXT("TSharedPtr<%s> %sLazy;\n"), *LazyClassName, *MemberName);
+        AggregateConstruction += Tab + Tab + FString::Printf(TEXT("if (LazyTables.Contains(TEXT(\"%s\"))) %sLazy = MakeShared<%s>();\n"),
+            *Table.Name, *MemberName, *LazyClassName);
+        AggregateConstruction += Tab + Tab + FString::Printf(TEXT("else %s = MakeShared<%s>();\n"), *MemberName, *ClassName);
+        AggregateRegistration += Tab + Tab + FString::Printf(TEXT("if (%s) Cache.RegisterTable(%s.ToSharedRef());\n"), *MemberName, *MemberName);
+        AggregateRegistration += Tab + Tab + FString::Printf(TEXT("if (%sLazy) Cache.RegisterTable(%sLazy.ToSharedRef());\n"), *MemberName, *MemberName);
     }
-    // OutHeader = MoveTemp(OutHeaderText);
-    // return true;
-    
-    OutError = TEXT("Tables codegen not implemented");
-    return false;
+
+    // Every table of the module, ready to be registered with a client cache
+    Code += FString::Printf(TEXT("/* Client caches of every table in module '%s'; each table is either decoded or lazy */\n"), *ModuleName);
+    Code += FString::Printf(TEXT("struct F%sTables\n{\n"), *ModulePascal);
+    Code += Tab + TEXT("/** Identifies the schema these tables were generated for, e.g. for FSpacetimeCacheSnapshot */\n");
+    Code += Tab + FString::Printf(TEXT("static constexpr uint32 SchemaFingerprint = 0x%08x;\n\n"), FCrc::StrCrc32(*Layout));
+    Code += Tab + TEXT("/** @param LazyTables Names of the tables to cache as encoded row views */\n");
+    Code += Tab + FString::Printf(TEXT("explicit F%sTables(const TSet<FString>& LazyTables = {})\n"), *ModulePascal);
+    Code += Tab + TEXT("{\n") + AggregateConstruction + Tab + TEXT("}\n\n");
+    Code += AggregateMembers + TEXT("\n");
+    Code += Tab + TEXT("void RegisterWith(FSpacetimeClientCache& Cache) const\n") + Tab + TEXT("{\n");
+    Code += AggregateRegistration;
+    Code += Tab + TEXT("}\n};\n");
+
+    OutHeader = MoveTemp(Code);
+    return true;
 }
 
 bool FSpacetimeDBCodeGen::GenerateReducerFunctions(
@@ -141,27 +602,31 @@ bool FSpacetimeDBCodeGen::GenerateReducerFunctions(
     });
     
     const FString ClassName = "U" + ModuleName +  "Reducers";
+    const auto TabString = FSpacetimeConfig::TabString;
     
     // Header
     FString HeaderText;
     HeaderText += TEXT("#pragma once\n\n"
-                "#include \"Kismet/BlueprintFunctionLibrary.h\"\n"
                 "#include \"CoreMinimal.h\"\n"
+                "#include \"SpacetimeAsyncActions.h\"\n"
                 "#include \"" + FSpacetimeConfig::MakeExportedTypesCodeFileName(ModuleName) + ".h" + "\"\n"
                 "#include \"" + HeaderName + ".generated.h" + "\"\n\n\n");
+    HeaderText += FString::Printf(TEXT("/* Latent Blueprint nodes calling the reducers of module '%s'; they complete on the server's acknowledgement */\n"), *ModuleName);
     HeaderText += TEXT("UCLASS()\n"
-                "class " + FSpacetimeConfig::ApiMacroString + " " + ClassName + " : public UBlueprintFunctionLibrary {\n\n"
+                "class " + FSpacetimeConfig::ApiMacroString + " " + ClassName + " : public USpacetimeReducerCallAction {\n\n"
                 "   GENERATED_BODY()\n\npublic:\n\n");
 
     // Source
     FString Src;
     const FString HeaderFileRelativePath = FSpacetimeConfig::GeneratedDirectory + "/" + HeaderName + ".h";
-    Src += "#include \"" + HeaderFileRelativePath + "\"\n\n\n";
+    Src += "#include \"" + HeaderFileRelativePath + "\"\n\n";
+    Src += "#include \"" + FSpacetimeConfig::MakeCodecCodeFileName(ModuleName) + ".h\"\n\n\n";
 
     for (const auto& ReducerDef : ModuleDef.Reducers)
     {
         // Function signature
-        TArray<FString> Params;
+        TArray<FString> Params = {TEXT("UObject* WorldContextObject")};
+        FString Encoding;
         for (const auto& [Name, AlgebraicType] : ReducerDef.Params)
         {            
             // FString UEType = MapBuiltinToUnreal(ModuleDef.Typespace.TypeEntries[Argument.TypeRef].Builtin);
@@ -188,22 +653,40 @@ bool FSpacetimeDBCodeGen::GenerateReducerFunctions(
             const FString ParamArgString = FString::Printf(TEXT("const %s& %s"), *UEType, *ArgName);
             
             Params.Add(ParamArgString);
+
+            // The arguments travel as one product, in declaration order
+            const FAttribute Argument{ArgName, UEType, AlgebraicType.Tag};
+            FString Write = GBsatnWriteStatement(Argument, ArgName, TabString + TabString);
+            if (Write.IsEmpty())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("[spacetime] No BSATN codec for argument '%s' of reducer '%s'; calls will fail"),
+                    *ArgName, *ReducerDef.Name);
+                Write = TabString + TabString + TEXT("return false;\n");
+            }
+            Encoding += Write;
         }
 
-        FString Prefix = TEXT("    UFUNCTION(BlueprintCallable, Category=\"SpacetimeDB|" + ModuleName + "\")"); 
+        FString Prefix = TEXT("    UFUNCTION(BlueprintCallable, Category=\"SpacetimeDB|" + ModuleName + "\", "
+                              "meta=(BlueprintInternalUseOnly=\"true\", WorldContext=\"WorldContextObject\"))"); 
         FString Sig = Prefix + FString::Printf(
-            TEXT("\n    static void %s(%s);\n\n"),
+            TEXT("\n    static USpacetimeReducerCallAction* %s(%s);\n\n"),
             *ToPascalCase(ReducerDef.Name), *FString::Join(Params, TEXT(", "))
         );
         HeaderText += Sig;
 
-        // Implementation stub
-        FString Suffix = FString::Printf(
-            TEXT("::%s(%s)\n{\n    // TODO: call SpacetimeDB client reducer '%s'\n}\n\n"),
-            *ToPascalCase(ReducerDef.Name), *FString::Join(Params, TEXT(", ")),
-            *ReducerDef.Name
+        // Encodes the arguments and sends the call once the node activates
+        FString Impl = FString::Printf(
+            TEXT("USpacetimeReducerCallAction* %s::%s(%s)\n{\n"),
+            *ClassName, *ToPascalCase(ReducerDef.Name), *FString::Join(Params, TEXT(", "))
         );
-        FString Impl = "void " + ClassName + Suffix;
+        Impl += TabString + TEXT("TArray<uint8> Args;\n");
+        Impl += TabString + TEXT("FSpacetimeBsatnWriter Writer(Args);\n");
+        Impl += TabString + TEXT("const bool bEncoded = [&]\n") + TabString + TEXT("{\n");
+        Impl += Encoding;
+        Impl += TabString + TabString + TEXT("return true;\n") + TabString + TEXT("}();\n\n");
+        Impl += TabString + FString::Printf(
+            TEXT("return CallReducer(WorldContextObject, TEXT(\"%s\"), bEncoded ? TOptional<TArray<uint8>>(MoveTemp(Args)) : TOptional<TArray<uint8>>());\n}\n"),
+            *ReducerDef.Name);
         Src += "\n" + Impl;
     }
     HeaderText += TEXT("};\n");
@@ -213,6 +696,49 @@ bool FSpacetimeDBCodeGen::GenerateReducerFunctions(
     return true;
 }
 
+// Emits operator== and GetTypeHash, so generated types can key client-side table indexes.
+// Members without an Unreal representation (emitted as comments) are left out; strings compare case-sensitively.
+void GOutputEqualityAndHash(const FString& TypeName, const TArray<FAttribute>& Members, FString &OutHeaderCode)
+{
+    const auto TabString = FSpacetimeConfig::TabString;
+
+    TArray<FString> Comparisons;
+    TArray<FString> Hashes;
+    for (const auto& Member : Members)
+    {
+        if (Member.Type.StartsWith(TEXT("//")))
+        {
+            continue;
+        }
+        if (Member.Type == TEXT("FString"))
+        {
+            Comparisons.Add(FString::Printf(TEXT("%s.Equals(Other.%s, ESearchCase::CaseSensitive)"), *Member.Name, *Member.Name));
+            Hashes.Add(FString::Printf(TEXT("FCrc::StrCrc32(*Value.%s)"), *Member.Name));
+        }
+        else
+        {
+            Comparisons.Add(Member.Name + TEXT(" == Other.") + Member.Name);
+            Hashes.Add(FString::Printf(TEXT("GetTypeHash(Value.%s)"), *Member.Name));
+        }
+    }
+
+    OutHeaderCode += TabString + FString::Printf(TEXT("bool operator==(const %s& Other) const\n"), *TypeName);
+    OutHeaderCode += TabString + TEXT("{\n");
+    OutHeaderCode += TabString + TabString + TEXT("return ")
+        + (Comparisons.IsEmpty() ? TEXT("true") : FString::Join(Comparisons, TEXT(" && "))) + TEXT(";\n");
+    OutHeaderCode += TabString + TEXT("}\n\n");
+
+    OutHeaderCode += TabString + FString::Printf(TEXT("friend uint32 GetTypeHash(const %s& Value)\n"), *TypeName);
+    OutHeaderCode += TabString + TEXT("{\n");
+    OutHeaderCode += TabString + TabString + TEXT("uint32 Hash = 0;\n");
+    for (const auto& Hash : Hashes)
+    {
+        OutHeaderCode += TabString + TabString + TEXT("Hash = HashCombine(Hash, ") + Hash + TEXT(");\n");
+    }
+    OutHeaderCode += TabString + TabString + TEXT("return Hash;\n");
+    OutHeaderCode += TabString + TEXT("}\n\n");
+}
+
 void GOutputTaggedUnion(const FTaggedUnion &TaggedUnion, FString &OutHeaderCode)
 {
     const auto TabString = FSpacetimeConfig::TabString;
@@ -242,14 +768,17 @@ void GOutputTaggedUnion(const FTaggedUnion &TaggedUnion, FString &OutHeaderCode)
     OutHeaderCode += TaggedUnionOptionProperty;
     OutHeaderCode += TabString + FString::Printf(TEXT("%ls Tag = %ls::None;\n"), *TagName, *TagName);
 
+    TArray<FAttribute> Members = {{TEXT("Tag"), TagName}};
     for (const auto& Option : TaggedUnion.Variants)
     {
         OutHeaderCode += TabString + FString::Printf(TEXT("\n"));
         OutHeaderCode += TaggedUnionOptionProperty;
         OutHeaderCode += TabString + FString::Printf(TEXT("%ls %ls;\n"), *Option.Type, *Option.Name);
+        Members.Add(Option);
     }
     
     OutHeaderCode += TabString + FString::Printf(TEXT("\n"));
+    GOutputEqualityAndHash("F" + TaggedUnion.BaseName, Members, OutHeaderCode);
     OutHeaderCode += FString::Printf(TEXT("};\n\n\n"));
 }
 
@@ -317,6 +846,7 @@ void GOutputStruct(const FStruct& Struct, const FString& ApiMacro, FString &OutH
         OutHeaderCode += ";\n\n";
     }
 
+    GOutputEqualityAndHash(Name, Attributes, OutHeaderCode);
     OutHeaderCode += "};\n\n\n";
 }
 
@@ -411,10 +941,12 @@ bool FSpacetimeDBCodeGen::GenerateTypespaceCode(
     const FString& ModuleName,
     FString& OutExportedTypesCode,
     FString& OutInlineTypesCode,
+    FHeader& OutExportedTypesHeader,
+    FHeader& OutInlineTypesHeader,
     FString& OutError)
 {
-    FHeader ExportedTypesHeader;
-    FHeader InlineTypesHeader;
+    FHeader& ExportedTypesHeader = OutExportedTypesHeader;
+    FHeader& InlineTypesHeader = OutInlineTypesHeader;
     
     if (!FTypespaceStructIRBuilder::BuildTypesHeaders(
         ModuleName,
@@ -441,6 +973,420 @@ bool FSpacetimeDBCodeGen::GenerateTypespaceCode(
     }
 
     UE_LOG(LogTemp, Log, TEXT("[spacetime] Successfully rendered header layout to files"));
-    
+
+    return true;
+}
+
+bool FSpacetimeDBCodeGen::RenderTypesHeader(const FHeader& Header, const bool bTopoSort, FString& OutCode, FString& OutError)
+{
+    return GRenderHeaderToCode(Header, OutCode, OutError, bTopoSort);
+}
+
+// C++ expression reading one BSATN-encoded attribute into Target, or empty if the type has no codec yet
+static FString GBsatnReadExpression(const FAttribute& Attribute, const FString& Target)
+{
+    if (Attribute.Type == TEXT("FInt256") || Attribute.Type == TEXT("FUInt256"))
+    {
+        return FString::Printf(TEXT("SpacetimeReadBsatn(Reader, %s)"), *Target);
+    }
+
+    switch (Attribute.WireType)
+    {
+    case SATS::EType::Product:
+    case SATS::EType::Sum:
+    case SATS::EType::Ref:
+        return FString::Printf(TEXT("SpacetimeReadBsatn(Reader, %s)"), *Target);
+
+    case SATS::EType::Bool:   return FString::Printf(TEXT("Reader.ReadBool(%s)"), *Target);
+    case SATS::EType::String: return FString::Printf(TEXT("Reader.ReadString(%s)"), *Target);
+    case SATS::EType::I256:
+    case SATS::EType::U256:   return FString::Printf(TEXT("Reader.ReadWideInt(%s, 32)"), *Target);
+
+    case SATS::EType::I8:
+    case SATS::EType::U8:
+    case SATS::EType::I16:
+    case SATS::EType::U16:
+    case SATS::EType::I32:
+    case SATS::EType::U32:
+    case SATS::EType::I64:
+    case SATS::EType::U64:
+    case SATS::EType::F32:
+    case SATS::EType::F64:
+        return FString::Printf(TEXT("Reader.ReadAs<%s>(%s)"),
+            *SATS::MapBuiltinToUnreal(SATS::TypeToString(Attribute.WireType), true), *Target);
+
+    default:
+        return FString();
+    }
+}
+
+// C++ statement writing Source as one BSATN-encoded attribute, returning false from the enclosing
+// function if that fails; empty if the type has no codec yet
+static FString GBsatnWriteStatement(const FAttribute& Attribute, const FString& Source, const FString& Indent)
+{
+    const auto TabString = FSpacetimeConfig::TabString;
+    auto Checked = [&Indent, &TabString](const FString& Call)
+    {
+        return Indent + TEXT("if (!") + Call + TEXT(")\n")
+            + Indent + TEXT("{\n")
+            + Indent + TabString + TEXT("return false;\n")
+            + Indent + TEXT("}\n");
+    };
+
+    if (Attribute.Type == TEXT("FInt256") || Attribute.Type == TEXT("FUInt256"))
+    {
+        return Checked(FString::Printf(TEXT("SpacetimeWriteBsatn(Writer, %s)"), *Source));
+    }
+
+    switch (Attribute.WireType)
+    {
+    case SATS::EType::Product:
+    case SATS::EType::Sum:
+    case SATS::EType::Ref:
+        return Checked(FString::Printf(TEXT("SpacetimeWriteBsatn(Writer, %s)"), *Source));
+
+    case SATS::EType::Bool:   return Indent + FString::Printf(TEXT("Writer.WriteBool(%s);\n"), *Source);
+    case SATS::EType::String: return Indent + FString::Printf(TEXT("Writer.WriteString(%s);\n"), *Source);
+    case SATS::EType::I256:
+    case SATS::EType::U256:   return Checked(FString::Printf(TEXT("Writer.WriteWideInt(%s, 32)"), *Source));
+
+    case SATS::EType::I8:
+    case SATS::EType::U8:
+    case SATS::EType::I16:
+    case SATS::EType::U16:
+    case SATS::EType::I32:
+    case SATS::EType::U32:
+    case SATS::EType::I64:
+    case SATS::EType::U64:
+    case SATS::EType::F32:
+    case SATS::EType::F64:
+        // Blueprint-friendly members are wider than the wire type; narrowed back here
+        return Indent + FString::Printf(TEXT("Writer.WriteScalar(static_cast<%s>(%s));\n"),
+            *SATS::MapBuiltinToUnreal(SATS::TypeToString(Attribute.WireType), true), *Source);
+
+    default:
+        return FString();
+    }
+}
+
+// C++ statement clearing Target for reuse: containers are emptied without releasing their memory,
+// everything else goes back to its default
+static FString GResetStatement(const FAttribute& Attribute, const FString& Target, const FString& Indent)
+{
+    if (Attribute.Type == TEXT("FInt256") || Attribute.Type == TEXT("FUInt256"))
+    {
+        return Indent + FString::Printf(TEXT("SpacetimeReset(%s);\n"), *Target);
+    }
+
+    switch (Attribute.WireType)
+    {
+    case SATS::EType::Product:
+    case SATS::EType::Sum:
+    case SATS::EType::Ref:
+        return Indent + FString::Printf(TEXT("SpacetimeReset(%s);\n"), *Target);
+
+    case SATS::EType::String:
+    case SATS::EType::I256:
+    case SATS::EType::U256:
+    case SATS::EType::Array:
+    case SATS::EType::Map:
+        return Indent + FString::Printf(TEXT("%s.Reset();\n"), *Target);
+
+    default:
+        return Indent + FString::Printf(TEXT("%s = %s;\n"), *Target,
+            Attribute.DefaultValue.IsSet() ? *Attribute.DefaultValue.GetValue() : TEXT("{}"));
+    }
+}
+
+static void GOutputStructCodec(const FStruct& Struct, FString& OutCode)
+{
+    const auto TabString = FSpacetimeConfig::TabString;
+
+    TArray<FString> Reads;
+    for (const auto& Attribute : Struct.Attributes)
+    {
+        FString Read = GBsatnReadExpression(Attribute, TEXT("Out.") + Attribute.Name);
+        if (Read.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[spacetime] No BSATN codec for '%s::%s'; rows containing it will fail to decode"),
+                *Struct.Name, *Attribute.Name);
+            Read = FString::Printf(TEXT("Reader.Fail() /* %s: no codec for '%s' */"), *Attribute.Name, *SATS::TypeToString(Attribute.WireType));
+        }
+        Reads.Add(MoveTemp(Read));
+    }
+
+    OutCode += FString::Printf(TEXT("inline bool SpacetimeReadBsatn(FSpacetimeBsatnReader& Reader, %s& Out)\n{\n"), *Struct.Name);
+    const FString Separator = TEXT("\n") + TabString + TabString + TEXT("&& ");
+    OutCode += TabString + TEXT("return ")
+        + (Reads.IsEmpty() ? TEXT("Reader.IsOk()") : FString::Join(Reads, *Separator))
+        + TEXT(";\n}\n\n");
+
+    OutCode += FString::Printf(TEXT("inline bool SpacetimeWriteBsatn(FSpacetimeBsatnWriter& Writer, const %s& Value)\n{\n"), *Struct.Name);
+    for (const auto& Attribute : Struct.Attributes)
+    {
+        FString Write = GBsatnWriteStatement(Attribute, TEXT("Value.") + Attribute.Name, TabString);
+        if (Write.IsEmpty())
+        {
+            Write = TabString + FString::Printf(TEXT("return false; // %s: no codec for '%s'\n"), *Attribute.Name, *SATS::TypeToString(Attribute.WireType));
+        }
+        OutCode += Write;
+    }
+    OutCode += TabString + TEXT("return true;\n}\n\n");
+
+    OutCode += FString::Printf(TEXT("inline void SpacetimeReset(%s& Value)\n{\n"), *Struct.Name);
+    for (const auto& Attribute : Struct.Attributes)
+    {
+        if (!Attribute.Type.StartsWith(TEXT("//")))
+        {
+            OutCode += GResetStatement(Attribute, TEXT("Value.") + Attribute.Name, TabString);
+        }
+    }
+    OutCode += TEXT("}\n\n");
+}
+
+static void GOutputTaggedUnionCodec(const FTaggedUnion& TaggedUnion, FString& OutCode)
+{
+    const auto TabString = FSpacetimeConfig::TabString;
+    const FString TypeName = TEXT("F") + TaggedUnion.BaseName;
+    const FString TagName = FString::Printf(TEXT("E%s_Tags"), *TaggedUnion.BaseName);
+
+    OutCode += FString::Printf(TEXT("inline bool SpacetimeReadBsatn(FSpacetimeBsatnReader& Reader, %s& Out)\n{\n"), *TypeName);
+    OutCode += TabString + TEXT("uint8 Tag;\n");
+    OutCode += TabString + TEXT("if (!Reader.ReadTag(Tag))\n") + TabString + TEXT("{\n");
+    OutCode += TabString + TabString + TEXT("return false;\n") + TabString + TEXT("}\n\n");
+    OutCode += TabString + TEXT("switch (Tag)\n") + TabString + TEXT("{\n");
+    for (int32 i = 0; i < TaggedUnion.Variants.Num(); ++i)
+    {
+        const auto& Variant = TaggedUnion.Variants[i];
+        FString Read = GBsatnReadExpression(Variant, TEXT("Out.") + Variant.Name);
+        if (Read.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[spacetime] No BSATN codec for variant '%s::%s'"), *TypeName, *Variant.Name);
+            Read = TEXT("Reader.Fail()");
+        }
+
+        // Tag enums reserve 0 for 'None'
+        OutCode += TabString + FString::Printf(TEXT("case %d:\n"), i);
+        OutCode += TabString + TabString + FString::Printf(TEXT("Out.Tag = static_cast<%s>(%d);\n"), *TagName, i + 1);
+        OutCode += TabString + TabString + TEXT("return ") + Read + TEXT(";\n");
+    }
+    OutCode += TabString + TEXT("default:\n");
+    OutCode += TabString + TabString + TEXT("return Reader.Fail();\n");
+    OutCode += TabString + TEXT("}\n}\n\n");
+
+    // An unset union (Tag 'None') has no encoding
+    OutCode += FString::Printf(TEXT("inline bool SpacetimeWriteBsatn(FSpacetimeBsatnWriter& Writer, const %s& Value)\n{\n"), *TypeName);
+    OutCode += TabString + TEXT("switch (static_cast<int32>(Value.Tag))\n") + TabString + TEXT("{\n");
+    for (int32 i = 0; i < TaggedUnion.Variants.Num(); ++i)
+    {
+        const auto& Variant = TaggedUnion.Variants[i];
+        FString Write = GBsatnWriteStatement(Variant, TEXT("Value.") + Variant.Name, TabString + TabString);
+        if (Write.IsEmpty())
+        {
+            Write = TabString + TabString + TEXT("return false;\n");
+        }
+
+        OutCode += TabString + FString::Printf(TEXT("case %d:\n"), i + 1);
+        OutCode += TabString + TabString + FString::Printf(TEXT("Writer.WriteTag(%d);\n"), i);
+        OutCode += Write;
+        OutCode += TabString + TabString + TEXT("return true;\n");
+    }
+    OutCode += TabString + TEXT("default:\n");
+    OutCode += TabString + TabString + TEXT("return false;\n");
+    OutCode += TabString + TEXT("}\n}\n\n");
+
+    // Every variant is cleared, so reading a new value into a recycled union leaves no stale payload behind
+    OutCode += FString::Printf(TEXT("inline void SpacetimeReset(%s& Value)\n{\n"), *TypeName);
+    OutCode += TabString + FString::Printf(TEXT("Value.Tag = %s::None;\n"), *TagName);
+    for (const auto& Variant : TaggedUnion.Variants)
+    {
+        OutCode += GResetStatement(Variant, TEXT("Value.") + Variant.Name, TabString);
+    }
+    OutCode += TEXT("}\n\n");
+}
+
+// Codec for the types of the given headers, which the included types header declares
+static void GRenderCodec(const FString& TypesHeaderName, const FString& SharedCodecHeaderName, const TArray<const FHeader*>& Headers, FString& OutCode)
+{
+    FString Code;
+    Code += TEXT("#pragma once\n\n"
+                 "#include \"CoreMinimal.h\"\n"
+                 "#include \"Cache/SpacetimeRowPool.h\"\n"
+                 "#include \"Codec/SpacetimeBsatnReader.h\"\n"
+                 "#include \"Codec/SpacetimeBsatnWriter.h\"\n");
+    if (!SharedCodecHeaderName.IsEmpty())
+    {
+        Code += TEXT("#include \"") + SharedCodecHeaderName + TEXT(".h\"\n");
+    }
+    Code += TEXT("#include \"") + TypesHeaderName + TEXT(".h\"\n\n\n");
+
+    FString Declarations;
+    FString Definitions;
+    for (const FHeader* Header : Headers)
+    {
+        for (const auto& Struct : Header->GetStructs())
+        {
+            Declarations += FString::Printf(TEXT("inline bool SpacetimeReadBsatn(FSpacetimeBsatnReader& Reader, %s& Out);\n"), *Struct.Name);
+            Declarations += FString::Printf(TEXT("inline bool SpacetimeWriteBsatn(FSpacetimeBsatnWriter& Writer, const %s& Value);\n"), *Struct.Name);
+            Declarations += FString::Printf(TEXT("inline void SpacetimeReset(%s& Value);\n"), *Struct.Name);
+            GOutputStructCodec(Struct, Definitions);
+        }
+        for (const auto& TaggedUnion : Header->GetTaggedUnions())
+        {
+            Declarations += FString::Printf(TEXT("inline bool SpacetimeReadBsatn(FSpacetimeBsatnReader& Reader, F%s& Out);\n"), *TaggedUnion.BaseName);
+            Declarations += FString::Printf(TEXT("inline bool SpacetimeWriteBsatn(FSpacetimeBsatnWriter& Writer, const F%s& Value);\n"), *TaggedUnion.BaseName);
+            Declarations += FString::Printf(TEXT("inline void SpacetimeReset(F%s& Value);\n"), *TaggedUnion.BaseName);
+            GOutputTaggedUnionCodec(TaggedUnion, Definitions);
+        }
+    }
+
+    Code += TEXT("// BSATN decoders and encoders, and resets for recycling, of every generated type; declared up front so they can refer to each other\n");
+    Code += Declarations + TEXT("\n\n") + Definitions;
+
+    OutCode = MoveTemp(Code);
+}
+
+bool FSpacetimeDBCodeGen::GenerateCodecCode(
+    const FString& ModuleName,
+    const FHeader& InlineTypesHeader,
+    const FHeader& ExportedTypesHeader,
+    FString& OutCode,
+    FString& OutError,
+    const bool bUsesSharedTypes)
+{
+    GRenderCodec(
+        FSpacetimeConfig::MakeExportedTypesCodeFileName(ModuleName),
+        bUsesSharedTypes ? FSpacetimeConfig::SharedCodecCodeFileName : FString(),
+        {&InlineTypesHeader, &ExportedTypesHeader},
+        OutCode);
+    return true;
+}
+
+bool FSpacetimeDBCodeGen::GenerateSharedCodecCode(const FHeader& SharedTypesHeader, FString& OutCode, FString& OutError)
+{
+    GRenderCodec(FSpacetimeConfig::SharedTypesCodeFileName, FString(), {&SharedTypesHeader}, OutCode);
+    return true;
+}
+
+// Whether two modules generate the same C++ for a type; the Blueprint category names the module and does not count
+static bool GIsSameAttributes(const TArray<FAttribute>& A, const TArray<FAttribute>& B)
+{
+    if (A.Num() != B.Num())
+    {
+        return false;
+    }
+    for (int32 i = 0; i < A.Num(); ++i)
+    {
+        if (A[i].Name != B[i].Name || A[i].Type != B[i].Type || A[i].WireType != B[i].WireType
+            || A[i].DefaultValue.IsSet() != B[i].DefaultValue.IsSet()
+            || (A[i].DefaultValue.IsSet() && A[i].DefaultValue.GetValue() != B[i].DefaultValue.GetValue()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool GIsSameStruct(const FStruct& A, const FStruct& B)
+{
+    return A.bIsReflected == B.bIsReflected && A.Specifiers == B.Specifiers && GIsSameAttributes(A.Attributes, B.Attributes);
+}
+
+static bool GIsSameTaggedUnion(const FTaggedUnion& A, const FTaggedUnion& B)
+{
+    return A.OptionTags == B.OptionTags && GIsSameAttributes(A.Variants, B.Variants);
+}
+
+bool FSpacetimeDBCodeGen::ExtractSharedTypes(
+    const TArray<TPair<FHeader*, FHeader*>>& ModuleHeaders,
+    FHeader& OutSharedHeader,
+    TArray<FString>& OutSharedTypes,
+    FString& OutError)
+{
+    // First definition of every type name, and how many modules define it
+    struct FFirstDefinition
+    {
+        const FHeader* Header = nullptr;
+        FHeader::FHeaderElement Element;
+        int32 NumModules = 0;
+    };
+    TMap<FString, FFirstDefinition> Definitions;
+    TArray<FString> Conflicts;
+
+    for (const auto& [Exported, Inline] : ModuleHeaders)
+    {
+        for (const FHeader* Header : {Inline, Exported})
+        {
+            for (const auto& Element : Header->GetHeaderElements())
+            {
+                FFirstDefinition& First = Definitions.FindOrAdd(Element.Name);
+                ++First.NumModules;
+                if (!First.Header)
+                {
+                    First.Header = Header;
+                    First.Element = Element;
+                    continue;
+                }
+
+                const bool bSame = Element.Type == First.Element.Type && (Element.Type == FHeader::FHeaderElement::Struct
+                    ? GIsSameStruct(Header->GetStructs()[Element.Index], First.Header->GetStructs()[First.Element.Index])
+                    : GIsSameTaggedUnion(Header->GetTaggedUnions()[Element.Index], First.Header->GetTaggedUnions()[First.Element.Index]));
+                if (!bSame)
+                {
+                    Conflicts.AddUnique(Element.Name);
+                }
+            }
+        }
+    }
+
+    if (!Conflicts.IsEmpty())
+    {
+        OutError = FString::Printf(TEXT("Types defined differently by several modules: %s"), *FString::Join(Conflicts, TEXT(", ")));
+        return false;
+    }
+
+    TSet<FString> SharedNames;
+    for (const auto& [Name, First] : Definitions)
+    {
+        if (First.NumModules < 2)
+        {
+            continue;
+        }
+        SharedNames.Add(Name);
+        OutSharedTypes.Add(Name);
+
+        if (First.Element.Type == FHeader::FHeaderElement::Struct)
+        {
+            FStruct Struct = First.Header->GetStructs()[First.Element.Index];
+            Struct.MetadataSpecifiers.Add("Category", "\"SpacetimeDB\"");
+            OutSharedHeader.AddStruct(MoveTemp(Struct));
+        }
+        else
+        {
+            FTaggedUnion TaggedUnion = First.Header->GetTaggedUnions()[First.Element.Index];
+            TaggedUnion.SubCategory = TEXT("Shared");
+            OutSharedHeader.AddTaggedUnion(MoveTemp(TaggedUnion));
+        }
+    }
+    if (SharedNames.IsEmpty())
+    {
+        return true;
+    }
+    OutSharedTypes.Sort();
+
+    OutSharedHeader.ApiMacro = ModuleHeaders[0].Value->ApiMacro;
+    OutSharedHeader.Includes.Add({"CoreMinimal.h", true});
+    OutSharedHeader.Includes.Add({FSpacetimeConfig::SharedTypesCodeFileName + ".generated.h", true});
+
+    for (const auto& [Exported, Inline] : ModuleHeaders)
+    {
+        Exported->RemoveElements(SharedNames);
+        Inline->RemoveElements(SharedNames);
+
+        // Ahead of the .generated.h include, which has to come last
+        Inline->Includes.Insert({FSpacetimeConfig::SharedTypesCodeFileName + ".h", true}, FMath::Max(0, Inline->Includes.Num() - 1));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("[spacetime] %d types are shared by several modules: %s"), OutSharedTypes.Num(), *FString::Join(OutSharedTypes, TEXT(", ")));
     return true;
 }
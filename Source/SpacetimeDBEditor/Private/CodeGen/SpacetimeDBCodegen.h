@@ -1,6 +1,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "Schema/RawModuleDefSchema.h"
+#include "TypespaceStructIRBuilder.h"
 
 /**
  * Generates Unreal C++ code (USTRUCTs & Blueprint nodes) from SATS::RawModuleDef.
@@ -9,20 +10,34 @@ class FSpacetimeDBCodeGen
 {
 public:
 	/**
-	 * Emit a single header containing all table USTRUCTs.
-	 * @param ModuleDef  Parsed RawModuleDef
-	 * @param HeaderName The header name, without '.h'
-	 * @param OutHeader  Generated .h code
-	 * @param OutError   Error, if any, description
+	 * Emit a single header with a client-side cache class per table, including a secondary
+	 * index (ordered for 'BTree', hashed for 'Hash') for every index declared by the module.
+	 * Every table also gets a lazy variant over a generated row view, which keeps rows encoded.
+	 * @param ModuleDef           Parsed RawModuleDef
+	 * @param ModuleName          The module's name as present in the Spacetime server
+	 * @param ExportedTypesHeader IR of the exported types header, used to resolve row and column types
+	 * @param OutHeader           Generated .h code
+	 * @param OutError            Error, if any, description
 	 */
-	static bool GenerateTableStructs(
+	static bool GenerateTableCaches(
 		const SATS::FRawModuleDef& ModuleDef,
-		const FString& HeaderName,
+		const FString& ModuleName,
+		const FHeader& ExportedTypesHeader,
 		FString& OutHeader,
 		FString& OutError);
 
 	/**
-	 * Emit a Blueprint function library header + source for all reducers.
+	 * What GenerateTableCaches calls each of Table's client-side indexes, by position in Table.Indexes:
+	 * the accessor name, or the columns joined without one, in PascalCase and numbered if taken already.
+	 * Its lookups are FindBy<Accessor>. Empty for indexes it skips, as a key column has no Unreal type.
+	 * @param RowStruct The row struct of Table, as GenerateTypespaceCode built it
+	 */
+	static TArray<FString> GetIndexAccessors(const SATS::FTableDef& Table, const FStruct& RowStruct);
+
+	/**
+	 * Emit a header + source with a latent Blueprint node (USpacetimeReducerCallAction factory) for
+	 * every reducer; each encodes its arguments with the generated codec and completes on the
+	 * server's acknowledgement.
 	 * @param ModuleName The module's name as present in the Spacetime server
 	 * @param ModuleDef  Parsed RawModuleDef
 	 * @param HeaderName The header name, without '.h'
@@ -45,6 +60,8 @@ public:
 	 * @param HeaderName
 	 * @param OutExportedTypesCode
 	 * @param OutInlineTypesCode 
+	 * @param OutExportedTypesHeader IR the exported types code was rendered from
+	 * @param OutInlineTypesHeader IR the inline types code was rendered from
 	 * @param OutError 
 	 * @return 
 	 */
@@ -53,8 +70,50 @@ public:
 		const FString& ModuleName,
 		FString& OutExportedTypesCode,
 		FString& OutInlineTypesCode,
+		FHeader& OutExportedTypesHeader,
+		FHeader& OutInlineTypesHeader,
+		FString& OutError);
+
+	/**
+	 * Emit a header with a BSATN decoder (SpacetimeReadBsatn) and encoder (SpacetimeWriteBsatn) for every generated struct and tagged union,
+	 * and a SpacetimeReset that clears a value for reuse without releasing its string and container memory.
+	 * @param ModuleName          The module's name as present in the Spacetime server
+	 * @param InlineTypesHeader   IR of the inline types header
+	 * @param ExportedTypesHeader IR of the exported types header
+	 * @param OutCode             Generated .h code
+	 * @param OutError            Error, if any, description
+	 * @param bUsesSharedTypes    Whether ExtractSharedTypes moved some of the module's types to the shared header
+	 */
+	static bool GenerateCodecCode(
+		const FString& ModuleName,
+		const FHeader& InlineTypesHeader,
+		const FHeader& ExportedTypesHeader,
+		FString& OutCode,
+		FString& OutError,
+		bool bUsesSharedTypes = false);
+
+	/**
+	 * Moves the types that several modules generate under the same name into one shared header, so
+	 * the modules can be compiled side by side. Types must be defined identically by every module
+	 * that has them; any difference fails, since UHT would reject the duplicate anyway.
+	 * The modules' inline headers then include the shared header.
+	 * @param ModuleHeaders    Exported and inline types headers of every module, in pairs, as built by GenerateTypespaceCode
+	 * @param OutSharedHeader  IR of the shared types header; empty if no type is shared
+	 * @param OutSharedTypes   Names of the shared types
+	 * @param OutError         Conflicting types, in case of 'false' return value
+	 */
+	static bool ExtractSharedTypes(
+		const TArray<TPair<FHeader*, FHeader*>>& ModuleHeaders,
+		FHeader& OutSharedHeader,
+		TArray<FString>& OutSharedTypes,
 		FString& OutError);
 
+	/** Renders a types header IR to code, as GenerateTypespaceCode does; exported headers are sorted by dependency. */
+	static bool RenderTypesHeader(const FHeader& Header, bool bTopoSort, FString& OutCode, FString& OutError);
+
+	/** GenerateCodecCode for the header built by ExtractSharedTypes. */
+	static bool GenerateSharedCodecCode(const FHeader& SharedTypesHeader, FString& OutCode, FString& OutError);
+
 private:
 	static FString ResolveAlgebraicTypeToUnrealCxx(const SATS::FAlgebraicType& AlgebraicKind);
 	// Sanitize identifier and convert to PascalCase
@@ -63,7 +63,7 @@ void AddMissingBuiltIns(FHeader& Header)
 	{
 		FStruct UInt256;
 		UInt256.Name = TEXT("FUInt256");
-		UInt256.Attributes.Add({"Value", "FString"});
+		UInt256.Attributes.Add({"Value", "FString", SATS::EType::U256});
 		UInt256.bIsReflected = true;
 		UInt256.Specifiers.Add("BlueprintType");
 		UInt256.MetadataSpecifiers.Add("Category", "\"SpacetimeDB\"");
@@ -75,7 +75,7 @@ void AddMissingBuiltIns(FHeader& Header)
 	{
 		FStruct Int256;
 		Int256.Name = TEXT("FInt256");
-		Int256.Attributes.Add({"Value", "FString"});
+		Int256.Attributes.Add({"Value", "FString", SATS::EType::I256});
 		Int256.bIsReflected = true;
 		Int256.Specifiers.Add("BlueprintType");
 		Int256.MetadataSpecifiers.Add("Category", "\"SpacetimeDB\"");
@@ -160,7 +160,8 @@ bool FTypespaceStructIRBuilder::GenerateNewStruct(
 			const auto NewStructName = FCommon::ToPascalCase(RawName);
 			OutStruct.Attributes.Add({
 				NewStructName,
-				NewStruct.Name});
+				NewStruct.Name,
+				SATS::EType::Product});
 			OutInlineHeader.AddStruct(NewStruct);
 
 			continue;
@@ -182,7 +183,7 @@ bool FTypespaceStructIRBuilder::GenerateNewStruct(
 
 			const auto NewTaggedUnionName = FCommon::ToPascalCase(RawName);
 			
-			OutStruct.Attributes.Add({NewTaggedUnionName,  "F" + NewTaggedUnion.BaseName});
+			OutStruct.Attributes.Add({NewTaggedUnionName,  "F" + NewTaggedUnion.BaseName, SATS::EType::Sum});
 			OutInlineHeader.AddTaggedUnion(NewTaggedUnion);
 
 			continue;
@@ -198,6 +199,7 @@ bool FTypespaceStructIRBuilder::GenerateNewStruct(
 			Attribute.Type = FCommon::MakeStructName(Referenced.Name.Name, ModuleName);
 			Attribute.DefaultValue = FSpacetimeConfig::GetDefaultValueForType(Tag);
 			Attribute.Comment = RawName + ": " + Referenced.Name.Name;
+			Attribute.WireType = Tag;
 			
 			OutStruct.Attributes.Add(Attribute);
 			
@@ -211,6 +213,7 @@ bool FTypespaceStructIRBuilder::GenerateNewStruct(
 			Attribute.Type = SATS::MapBuiltinToUnreal(SATS::TypeToString(Tag), false);
 			Attribute.DefaultValue = FSpacetimeConfig::GetDefaultValueForType(Tag);
 			Attribute.Comment = RawName + ": " + SATS::TypeToString(Tag);
+			Attribute.WireType = Tag;
 			
 			OutStruct.Attributes.Add(Attribute);
 
@@ -270,7 +273,7 @@ bool FTypespaceStructIRBuilder::GenerateNewTaggedUnion(
 			}
 
 			const auto NewStructName = FCommon::ToPascalCase(RawName);
-			OutTaggedUnion.Variants.Add({NewStructName, NewStruct.Name});
+			OutTaggedUnion.Variants.Add({NewStructName, NewStruct.Name, SATS::EType::Product});
 			OutTaggedUnion.OptionTags.Add(NewStruct.Name);
 			OutInlineHeader.AddStruct(NewStruct);
 
@@ -288,8 +291,8 @@ bool FTypespaceStructIRBuilder::GenerateNewTaggedUnion(
 			}
 
 			const auto NewTaggedUnionName = FCommon::ToPascalCase(RawName);
-			OutTaggedUnion.Variants.Add({NewTaggedUnion.BaseName, "F" + NewTaggedUnionName});
-			OutTaggedUnion.OptionTags.Add(NewTaggedUnion.BaseName);
+			OutTaggedUnion.Variants.Add({NewTaggedUnionName, "F" + NewTaggedUnion.BaseName, SATS::EType::Sum});
+			OutTaggedUnion.OptionTags.Add("F" + NewTaggedUnion.BaseName);
 			OutInlineHeader.AddTaggedUnion(NewTaggedUnion);
 
 			continue;
@@ -307,8 +310,10 @@ bool FTypespaceStructIRBuilder::GenerateNewTaggedUnion(
             Variant.Type = FCommon::MakeStructName(Referenced.Name.Name, ModuleName);
             Variant.DefaultValue = FSpacetimeConfig::GetDefaultValueForType(Tag);
             Variant.Comment = RawName + ": " + Referenced.Name.Name;
+            Variant.WireType = Tag;
             			
 			OutTaggedUnion.Variants.Add(Variant);
+			OutTaggedUnion.OptionTags.Add("F" + Variant.Name);
 			
 			continue;
 		}
@@ -320,8 +325,10 @@ bool FTypespaceStructIRBuilder::GenerateNewTaggedUnion(
             Variant.Type = SATS::MapBuiltinToUnreal(SATS::TypeToString(Tag), false);
             Variant.DefaultValue = FSpacetimeConfig::GetDefaultValueForType(Tag);
             Variant.Comment = RawName + ": " + SATS::TypeToString(Tag);
+            Variant.WireType = Tag;
 		
 			OutTaggedUnion.Variants.Add(Variant);
+			OutTaggedUnion.OptionTags.Add("F" + Variant.Name);
 
 			WarnTypes(Tag);
 
@@ -15,6 +15,7 @@ struct FAttribute
 {
 	FString Name;
 	FString Type;
+	SATS::EType WireType = SATS::EType::Invalid;	// SATS type on the wire, drives the BSATN codec
 	SATS::FOptionalString DefaultValue;
 	TOptional<FString> Comment;
 };
@@ -108,6 +109,33 @@ struct FHeader
 	}
 	const TArray<FHeaderElement>& GetHeaderElements() const { return HeaderElements; }
 
+	/** Drops the structs and tagged unions with the given element names, keeping the order of the rest. */
+	void RemoveElements(const TSet<FString>& Names)
+	{
+		TArray<FStruct> OldStructs = MoveTemp(Structs);
+		TArray<FTaggedUnion> OldTaggedUnions = MoveTemp(TaggedUnions);
+		const TArray<FHeaderElement> OldElements = MoveTemp(HeaderElements);
+		Structs.Reset();
+		TaggedUnions.Reset();
+		HeaderElements.Reset();
+
+		for (const FHeaderElement& Element : OldElements)
+		{
+			if (Names.Contains(Element.Name))
+			{
+				continue;
+			}
+			if (Element.Type == FHeaderElement::Struct)
+			{
+				AddStruct(MoveTemp(OldStructs[Element.Index]));
+			}
+			else
+			{
+				AddTaggedUnion(MoveTemp(OldTaggedUnions[Element.Index]));
+			}
+		}
+	}
+
 	auto TopoSortElements() const
 	{
 
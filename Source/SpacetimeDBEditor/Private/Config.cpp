@@ -5,12 +5,24 @@
 const FString FSpacetimeConfig::ApiMacroString = "SPACETIMEDBRUNTIME_API";
 const FString FSpacetimeConfig::TabString = "    ";
 const FString FSpacetimeConfig::GeneratedDirectory = "StdbGenerated";
+const FString FSpacetimeConfig::SharedTypesCodeFileName = "StdbSharedTypes.stdbgen";
+const FString FSpacetimeConfig::SharedCodecCodeFileName = "StdbSharedCodec.stdbgen";
 
 FString FSpacetimeConfig::MakeReducerCodeFileName(const FString& ModuleName)
 {
 	return FCommon::ToPascalCase(ModuleName) + FString(TEXT("Reducers.stdbgen"));
 }
 
+FString FSpacetimeConfig::MakeTablesCodeFileName(const FString& ModuleName)
+{
+	return FCommon::ToPascalCase(ModuleName) + FString(TEXT("Tables.stdbgen"));
+}
+
+FString FSpacetimeConfig::MakeCodecCodeFileName(const FString& ModuleName)
+{
+	return FCommon::ToPascalCase(ModuleName) + FString(TEXT("Codec.stdbgen"));
+}
+
 SATS::FOptionalString FSpacetimeConfig::GetDefaultValueForType(const SATS::EType& Type)
 {
 	const auto NoValue = SATS::FOptionalString();
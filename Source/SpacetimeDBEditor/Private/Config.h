@@ -7,7 +7,13 @@ struct FSpacetimeConfig
 	static const FString TabString;
 	static const FString GeneratedDirectory;
 
+	/** Types and codec several modules share, see FSpacetimeDBCodeGen::ExtractSharedTypes. */
+	static const FString SharedTypesCodeFileName;
+	static const FString SharedCodecCodeFileName;
+
 	static FString MakeReducerCodeFileName(const FString& ModuleName);
+	static FString MakeTablesCodeFileName(const FString& ModuleName);
+	static FString MakeCodecCodeFileName(const FString& ModuleName);
 
 	static SATS::FOptionalString GetDefaultValueForType(const SATS::EType& Type);
 	
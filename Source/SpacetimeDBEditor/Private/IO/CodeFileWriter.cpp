@@ -36,3 +36,20 @@ bool FCodeFileWriter::WriteFile(
 	
 	return true;
 }
+
+bool FCodeFileWriter::WriteFileIfChanged(
+	const FString& FilePath,
+	const FString& Code,
+	bool& bOutWritten,
+	FString& OutError
+)
+{
+	if (FString Existing; FFileHelper::LoadFileToString(Existing, *FilePath) && Existing.Equals(Code, ESearchCase::CaseSensitive))
+	{
+		bOutWritten = false;
+		return true;
+	}
+
+	bOutWritten = WriteFile(FilePath, Code, OutError);
+	return bOutWritten;
+}
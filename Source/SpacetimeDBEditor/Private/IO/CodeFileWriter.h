@@ -20,4 +20,16 @@ public:
 		const FString& OutCode,
 		FString& OutError
 	);
+
+	/**
+	 * WriteFile, unless FilePath already has exactly this text. An untouched file keeps its
+	 * timestamp, so the next build or Live Coding patch only compiles what really changed.
+	 * @param bOutWritten Receives whether the file was written.
+	 */
+	static bool WriteFileIfChanged(
+		const FString& FilePath,
+		const FString& Code,
+		bool& bOutWritten,
+		FString& OutError
+	);
 };
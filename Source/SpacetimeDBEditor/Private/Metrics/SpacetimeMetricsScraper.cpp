@@ -0,0 +1,435 @@
+#include "Metrics/SpacetimeMetricsScraper.h"
+
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+FSpacetimeMetricsScraper::~FSpacetimeMetricsScraper()
+{
+	Stop();
+}
+
+void FSpacetimeMetricsScraper::Start(const FString& InServerURL, const FString& InDatabaseName)
+{
+	Stop();
+
+	ServerURL = InServerURL;
+	ServerURL.RemoveFromEnd(TEXT("/"));
+	DatabaseName = InDatabaseName;
+	DatabaseIdentity.Reset();
+	PreviousScrape.Reset();
+	Backoff.RecordSuccess();
+	RetryTime = 0.0;
+
+	Scrape();
+}
+
+void FSpacetimeMetricsScraper::Stop()
+{
+	ServerURL.Reset();
+	DatabaseName.Reset();
+	++Generation;
+	bBusy = false;
+}
+
+void FSpacetimeMetricsScraper::Scrape()
+{
+	// A slow server gets one request at a time, not a queue of them, and one that is down gets fewer
+	if (!IsRunning() || bBusy || FPlatformTime::Seconds() < RetryTime)
+	{
+		return;
+	}
+
+	if (DatabaseIdentity.IsEmpty())
+	{
+		ResolveIdentity();
+	}
+	else
+	{
+		RequestMetrics();
+	}
+}
+
+void FSpacetimeMetricsScraper::ResolveIdentity()
+{
+	bBusy = true;
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(ServerURL + TEXT("/v1/database/") + FGenericPlatformHttp::UrlEncode(DatabaseName));
+	Request->SetVerb(TEXT("GET"));
+	Request->SetTimeout(RequestTimeout);
+	Request->OnProcessRequestComplete().BindLambda(
+		[WeakThis = TWeakPtr<FSpacetimeMetricsScraper>(AsShared()), RequestGeneration = Generation]
+		(FHttpRequestPtr, const FHttpResponsePtr Response, const bool bConnectedSuccessfully)
+	{
+		const TSharedPtr<FSpacetimeMetricsScraper> This = WeakThis.Pin();
+		if (!This || RequestGeneration != This->Generation)
+		{
+			return;
+		}
+		This->bBusy = false;
+
+		// The identity is a string, or an object wrapping one, depending on the server version
+		FString Identity;
+		TSharedPtr<FJsonObject> Json;
+		if (bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())
+			&& FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Response->GetContentAsString()), Json) && Json.IsValid())
+		{
+			if (const TSharedPtr<FJsonValue> Field = Json->TryGetField(TEXT("database_identity")); Field.IsValid() && !Field->TryGetString(Identity))
+			{
+				if (const TSharedPtr<FJsonObject>* Wrapper; Field->TryGetObject(Wrapper))
+				{
+					for (const auto& [Key, Value] : (*Wrapper)->Values)
+					{
+						if (Value->TryGetString(Identity))
+						{
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if (Identity.IsEmpty())
+		{
+			This->Fail(FString::Printf(TEXT("Database '%s' was not found on %s"), *This->DatabaseName, *This->ServerURL));
+			return;
+		}
+		This->DatabaseIdentity = NormalizeIdentity(Identity);
+		This->RequestMetrics();
+	});
+	Request->ProcessRequest();
+}
+
+void FSpacetimeMetricsScraper::RequestMetrics()
+{
+	bBusy = true;
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(ServerURL + TEXT("/metrics"));
+	Request->SetVerb(TEXT("GET"));
+	Request->SetTimeout(RequestTimeout);
+	Request->OnProcessRequestComplete().BindSP(this, &FSpacetimeMetricsScraper::HandleMetrics, Generation);
+	Request->ProcessRequest();
+}
+
+void FSpacetimeMetricsScraper::HandleMetrics(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bConnectedSuccessfully, const uint32 RequestGeneration)
+{
+	if (RequestGeneration != Generation)
+	{
+		return;
+	}
+
+	if (!bConnectedSuccessfully || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		bBusy = false;
+		Fail(FString::Printf(TEXT("No metrics from %s/metrics"), *ServerURL));
+		return;
+	}
+
+	Async(EAsyncExecution::ThreadPool,
+		[WeakThis = TWeakPtr<FSpacetimeMetricsScraper>(AsShared()), Text = Response->GetContentAsString(), Identity = DatabaseIdentity, RequestGeneration]()
+	{
+		FScrape Scrape = ParseScrape(Text, Identity);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Scrape = MoveTemp(Scrape), RequestGeneration]() mutable
+		{
+			if (const TSharedPtr<FSpacetimeMetricsScraper> This = WeakThis.Pin(); This && RequestGeneration == This->Generation)
+			{
+				This->bBusy = false;
+				This->FinishScrape(MoveTemp(Scrape));
+			}
+		});
+	});
+}
+
+void FSpacetimeMetricsScraper::FinishScrape(FScrape&& Scrape)
+{
+	FSpacetimeMetricsSnapshot Snapshot;
+	if (PreviousScrape.IsSet())
+	{
+		Snapshot.Interval = Scrape.Time - PreviousScrape->Time;
+	}
+
+	// Without an earlier scrape, percentiles cover everything since the server started
+	auto Delta = [this](const FHistogram& Histogram, const FHistogram* Earlier)
+	{
+		return PreviousScrape.IsSet() && Earlier ? Histogram.Since(*Earlier) : Histogram;
+	};
+
+	for (const auto& [Reducer, Histogram] : Scrape.Reducers)
+	{
+		const FHistogram Interval = Delta(Histogram, PreviousScrape.IsSet() ? PreviousScrape->Reducers.Find(Reducer) : nullptr);
+
+		FSpacetimeReducerMetrics& Metrics = Snapshot.Reducers.AddDefaulted_GetRef();
+		Metrics.Reducer = Reducer;
+		Metrics.TotalCalls = static_cast<uint64>(Histogram.Count);
+		Metrics.CallsPerSecond = Snapshot.Interval > 0.0 ? Interval.Count / Snapshot.Interval : 0.0;
+		Metrics.P50Ms = Interval.GetPercentile(0.5) * 1000.0;
+		Metrics.P99Ms = Interval.GetPercentile(0.99) * 1000.0;
+	}
+	Snapshot.Reducers.Sort([](const FSpacetimeReducerMetrics& A, const FSpacetimeReducerMetrics& B)
+	{
+		return A.CallsPerSecond != B.CallsPerSecond ? A.CallsPerSecond > B.CallsPerSecond : A.TotalCalls > B.TotalCalls;
+	});
+
+	const FHistogram Updates = Delta(Scrape.UpdateSizes, PreviousScrape.IsSet() ? &PreviousScrape->UpdateSizes : nullptr);
+	Snapshot.UpdatesPerSecond = Snapshot.Interval > 0.0 ? Updates.Count / Snapshot.Interval : 0.0;
+	Snapshot.BytesPerUpdate = Updates.Count > 0.0 ? Updates.Sum / Updates.Count : 0.0;
+
+	Backoff.RecordSuccess();
+	PreviousScrape = MoveTemp(Scrape);
+	OnUpdated.ExecuteIfBound(Snapshot);
+}
+
+void FSpacetimeMetricsScraper::Fail(const FString& Error)
+{
+	UE_LOG(LogTemp, Verbose, TEXT("[spacetime] %s"), *Error);
+
+	Backoff.RecordFailure();
+	RetryTime = FPlatformTime::Seconds() + Backoff.GetDelay();
+
+	FSpacetimeMetricsSnapshot Snapshot;
+	Snapshot.Error = Error;
+	OnUpdated.ExecuteIfBound(Snapshot);
+}
+
+FString FSpacetimeMetricsScraper::NormalizeIdentity(const FString& Identity)
+{
+	FString Normalized = Identity.TrimStartAndEnd().ToLower();
+	Normalized.RemoveFromStart(TEXT("0x"));
+	return Normalized;
+}
+
+FSpacetimeMetricsScraper::FScrape FSpacetimeMetricsScraper::ParseScrape(const FString& Text, const FString& DatabaseIdentity)
+{
+	FScrape Scrape;
+	Scrape.Time = FPlatformTime::Seconds();
+
+	const FStringView DurationMetric(ReducerDurationMetric);
+	const FStringView SizeMetric(SentMessageSizeMetric);
+
+	ParsePrometheusText(Text,
+		[DurationMetric, SizeMetric](const FStringView Name)
+		{
+			return Name.StartsWith(DurationMetric) || Name.StartsWith(SizeMetric);
+		},
+		[&Scrape, &DatabaseIdentity, DurationMetric, SizeMetric](const FStringView Name, const TMap<FString, FString>& Labels, const double Value)
+		{
+			const FString* Database = Labels.Find(DatabaseLabel);
+			if (!Database || NormalizeIdentity(*Database) != DatabaseIdentity)
+			{
+				return;
+			}
+
+			FHistogram* Histogram = nullptr;
+			FStringView Suffix;
+			if (Name.StartsWith(DurationMetric))
+			{
+				const FString* Reducer = Labels.Find(ReducerLabel);
+				const FString* TransactionType = Labels.Find(TransactionTypeLabel);
+				if (!Reducer || (TransactionType && !TransactionType->Equals(TEXT("Reducer"), ESearchCase::IgnoreCase)))
+				{
+					return;
+				}
+				Histogram = &Scrape.Reducers.FindOrAdd(*Reducer);
+				Suffix = Name.RightChop(DurationMetric.Len());
+			}
+			else
+			{
+				if (const FString* Workload = Labels.Find(WorkloadLabel); Workload && !Workload->Equals(TEXT("Update"), ESearchCase::IgnoreCase))
+				{
+					return;
+				}
+				Histogram = &Scrape.UpdateSizes;
+				Suffix = Name.RightChop(SizeMetric.Len());
+			}
+
+			// Series that differ in other labels, such as whether the transaction committed, add up
+			if (Suffix == TEXT("_bucket"))
+			{
+				const FString* UpperBoundText = Labels.Find(TEXT("le"));
+				double UpperBound = TNumericLimits<double>::Max();
+				if (!UpperBoundText || (*UpperBoundText != TEXT("+Inf") && !LexTryParseString(UpperBound, **UpperBoundText)))
+				{
+					return;
+				}
+				if (TPair<double, double>* Bucket = Histogram->Buckets.FindByPredicate([UpperBound](const TPair<double, double>& Existing) { return Existing.Key == UpperBound; }))
+				{
+					Bucket->Value += Value;
+				}
+				else
+				{
+					Histogram->Buckets.Emplace(UpperBound, Value);
+				}
+			}
+			else if (Suffix == TEXT("_sum"))
+			{
+				Histogram->Sum += Value;
+			}
+			else if (Suffix == TEXT("_count"))
+			{
+				Histogram->Count += Value;
+			}
+		});
+
+	auto SortBuckets = [](FHistogram& Histogram)
+	{
+		Histogram.Buckets.Sort([](const TPair<double, double>& A, const TPair<double, double>& B) { return A.Key < B.Key; });
+	};
+	for (auto& [Reducer, Histogram] : Scrape.Reducers)
+	{
+		SortBuckets(Histogram);
+	}
+	SortBuckets(Scrape.UpdateSizes);
+	return Scrape;
+}
+
+FSpacetimeMetricsScraper::FHistogram FSpacetimeMetricsScraper::FHistogram::Since(const FHistogram& Earlier) const
+{
+	// Counters only go down if the server restarted, and then everything counted is new
+	if (Count < Earlier.Count || Buckets.Num() != Earlier.Buckets.Num())
+	{
+		return *this;
+	}
+
+	FHistogram Difference;
+	Difference.Sum = Sum - Earlier.Sum;
+	Difference.Count = Count - Earlier.Count;
+	Difference.Buckets.Reserve(Buckets.Num());
+	for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+	{
+		Difference.Buckets.Emplace(Buckets[Index].Key, Buckets[Index].Value - Earlier.Buckets[Index].Value);
+	}
+	return Difference;
+}
+
+double FSpacetimeMetricsScraper::FHistogram::GetPercentile(const double Fraction) const
+{
+	if (Count <= 0.0 || Buckets.IsEmpty())
+	{
+		return 0.0;
+	}
+
+	const double Rank = Fraction * Count;
+	double LowerBound = 0.0;
+	double Below = 0.0;
+	for (const auto& [UpperBound, Cumulative] : Buckets)
+	{
+		if (Cumulative >= Rank)
+		{
+			// The open-ended last bucket has no width to interpolate in
+			if (UpperBound == TNumericLimits<double>::Max() || Cumulative <= Below)
+			{
+				return LowerBound;
+			}
+			return LowerBound + (UpperBound - LowerBound) * (Rank - Below) / (Cumulative - Below);
+		}
+		LowerBound = UpperBound;
+		Below = Cumulative;
+	}
+	return LowerBound;
+}
+
+void FSpacetimeMetricsScraper::ParsePrometheusText(
+	FStringView Text,
+	const TFunctionRef<bool(FStringView Name)> WantsMetric,
+	const TFunctionRef<void(FStringView Name, const TMap<FString, FString>& Labels, double Value)> OnSample)
+{
+	TMap<FString, FString> Labels;
+	while (!Text.IsEmpty())
+	{
+		int32 LineEnd = INDEX_NONE;
+		if (!Text.FindChar(TEXT('\n'), LineEnd))
+		{
+			LineEnd = Text.Len();
+		}
+		const FStringView Line = Text.Left(LineEnd).TrimStartAndEnd();
+		Text.RightChopInline(LineEnd + 1);
+
+		// Comments, including the # HELP and # TYPE lines
+		if (Line.IsEmpty() || Line[0] == TEXT('#'))
+		{
+			continue;
+		}
+
+		int32 Pos = 0;
+		while (Pos < Line.Len() && Line[Pos] != TEXT('{') && !FChar::IsWhitespace(Line[Pos]))
+		{
+			++Pos;
+		}
+		const FStringView Name = Line.Left(Pos);
+		if (!WantsMetric(Name))
+		{
+			continue;
+		}
+
+		// name{label="value",...} value [timestamp]
+		Labels.Reset();
+		bool bValid = true;
+		if (Pos < Line.Len() && Line[Pos] == TEXT('{'))
+		{
+			++Pos;
+			while (bValid && Pos < Line.Len() && Line[Pos] != TEXT('}'))
+			{
+				int32 Equals = Pos;
+				while (Equals < Line.Len() && Line[Equals] != TEXT('='))
+				{
+					++Equals;
+				}
+				FString Key(Line.Mid(Pos, Equals - Pos).TrimStartAndEnd());
+				Pos = Equals + 1;
+				if (Pos >= Line.Len() || Line[Pos] != TEXT('"'))
+				{
+					bValid = false;
+					break;
+				}
+
+				FString Value;
+				for (++Pos; Pos < Line.Len() && Line[Pos] != TEXT('"'); ++Pos)
+				{
+					if (Line[Pos] == TEXT('\\') && Pos + 1 < Line.Len())
+					{
+						++Pos;
+						Value.AppendChar(Line[Pos] == TEXT('n') ? TEXT('\n') : Line[Pos]);
+					}
+					else
+					{
+						Value.AppendChar(Line[Pos]);
+					}
+				}
+				Labels.Add(MoveTemp(Key), MoveTemp(Value));
+
+				for (++Pos; Pos < Line.Len() && (Line[Pos] == TEXT(',') || FChar::IsWhitespace(Line[Pos])); ++Pos)
+				{
+				}
+			}
+			++Pos;
+		}
+		if (!bValid)
+		{
+			continue;
+		}
+
+		const FStringView Rest = Line.RightChop(Pos).TrimStart();
+		int32 ValueEnd = 0;
+		while (ValueEnd < Rest.Len() && !FChar::IsWhitespace(Rest[ValueEnd]))
+		{
+			++ValueEnd;
+		}
+		const FString ValueText(Rest.Left(ValueEnd));
+		double Value = 0.0;
+		if (ValueText == TEXT("+Inf"))
+		{
+			Value = TNumericLimits<double>::Max();
+		}
+		else if (!LexTryParseString(Value, *ValueText))
+		{
+			continue;
+		}
+		OnSample(Name, Labels, Value);
+	}
+}
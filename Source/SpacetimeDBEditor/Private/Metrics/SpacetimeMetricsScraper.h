@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "SpacetimeBackoff.h"
+
+/** One reducer's activity between the two latest scrapes. */
+struct FSpacetimeReducerMetrics
+{
+	FString Reducer;
+	double CallsPerSecond = 0.0;
+
+	/** Execution time percentiles, interpolated within histogram buckets; 0 without calls. */
+	double P50Ms = 0.0;
+	double P99Ms = 0.0;
+
+	/** Calls since the server started. */
+	uint64 TotalCalls = 0;
+};
+
+/** A database's reducer and subscription activity, as of the latest scrape. */
+struct FSpacetimeMetricsSnapshot
+{
+	/** Every reducer the server has metrics for, the most called first. */
+	TArray<FSpacetimeReducerMetrics> Reducers;
+
+	double UpdatesPerSecond = 0.0;
+	double BytesPerUpdate = 0.0;
+
+	/** Seconds between the scrapes the rates come from; 0 after the first scrape, which has no rates yet. */
+	double Interval = 0.0;
+
+	/** Why there are no metrics; empty if the scrape succeeded. */
+	FString Error;
+};
+
+/**
+ * Scrapes the Prometheus metrics endpoint of a SpacetimeDB server, for one database, whenever
+ * its owner calls Scrape; the metrics panel does so from an active timer, so nothing is scraped
+ * while the panel is hidden. Once the server stops answering, scrapes back off until it is back.
+ *
+ * The server reports cumulative histograms per database and reducer; rates and percentiles are
+ * taken from the difference between two scrapes, so they describe the last interval rather than
+ * everything since the server started. The exposition text of a busy server is large, so it is
+ * parsed on the thread pool, keeping only the metrics used here.
+ *
+ * Metrics are labeled with the database's identity, which is looked up by name once.
+ * Game thread only.
+ */
+class FSpacetimeMetricsScraper : public TSharedFromThis<FSpacetimeMetricsScraper>
+{
+public:
+	/** Histogram of reducer execution times, labeled with DatabaseLabel, ReducerLabel and TransactionTypeLabel. */
+	static constexpr const TCHAR* ReducerDurationMetric = TEXT("spacetime_txn_elapsed_time_sec");
+
+	/** Histogram of the sizes of messages sent to clients, labeled with DatabaseLabel and WorkloadLabel. */
+	static constexpr const TCHAR* SentMessageSizeMetric = TEXT("spacetime_websocket_sent_msg_size_bytes");
+
+	static constexpr const TCHAR* DatabaseLabel = TEXT("db");
+	static constexpr const TCHAR* ReducerLabel = TEXT("reducer_or_query");
+	static constexpr const TCHAR* TransactionTypeLabel = TEXT("txn_type");
+	static constexpr const TCHAR* WorkloadLabel = TEXT("workload");
+
+	static constexpr float RequestTimeout = 5.f;
+
+	/** Seconds before the first retry after a failed scrape, doubling up to MaxRetryDelay. */
+	static constexpr double MinRetryDelay = 2.0;
+	static constexpr double MaxRetryDelay = 60.0;
+
+	~FSpacetimeMetricsScraper();
+
+	/** Targets a database and scrapes it right away; restarts if already running. */
+	void Start(const FString& InServerURL, const FString& InDatabaseName);
+	void Stop();
+
+	/** Scrapes again, unless the last scrape is still on its way or failed too recently. */
+	void Scrape();
+
+	bool IsRunning() const { return !ServerURL.IsEmpty(); }
+
+	DECLARE_DELEGATE_OneParam(FOnUpdated, const FSpacetimeMetricsSnapshot& /*Snapshot*/);
+
+	/** After every scrape, successful or not. */
+	FOnUpdated OnUpdated;
+
+	/**
+	 * Calls OnSample for every sample in Prometheus text exposition format whose metric name
+	 * WantsMetric accepts; labels are only parsed for those. Any thread.
+	 */
+	static void ParsePrometheusText(
+		FStringView Text,
+		TFunctionRef<bool(FStringView Name)> WantsMetric,
+		TFunctionRef<void(FStringView Name, const TMap<FString, FString>& Labels, double Value)> OnSample);
+
+private:
+	/** A cumulative histogram as exposed: counts of samples up to each bucket's upper bound. */
+	struct FHistogram
+	{
+		TArray<TPair<double, double>> Buckets;
+		double Sum = 0.0;
+		double Count = 0.0;
+
+		/** This histogram minus an earlier one of the same series; itself if the server restarted in between. */
+		FHistogram Since(const FHistogram& Earlier) const;
+
+		/** Interpolated value below which Fraction of the samples are. */
+		double GetPercentile(double Fraction) const;
+	};
+
+	struct FScrape
+	{
+		TMap<FString, FHistogram> Reducers;
+		FHistogram UpdateSizes;
+		double Time = 0.0;
+	};
+
+	void ResolveIdentity();
+	void RequestMetrics();
+	void HandleMetrics(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, uint32 Generation);
+	void FinishScrape(FScrape&& Scrape);
+	void Fail(const FString& Error);
+
+	/** Parses the metrics of DatabaseIdentity out of the exposition text. Any thread. */
+	static FScrape ParseScrape(const FString& Text, const FString& DatabaseIdentity);
+
+	/** Lowercase hex without a '0x' prefix, as identities are compared. */
+	static FString NormalizeIdentity(const FString& Identity);
+
+	FString ServerURL;
+	FString DatabaseName;
+	FString DatabaseIdentity;
+
+	/** A request or parse is on its way; scrapes skip until it finished. */
+	bool bBusy = false;
+
+	FSpacetimeBackoff Backoff{MinRetryDelay, MaxRetryDelay};
+	double RetryTime = 0.0;
+
+	/** Answers for an earlier Start are ignored. */
+	uint32 Generation = 0;
+
+	TOptional<FScrape> PreviousScrape;
+};
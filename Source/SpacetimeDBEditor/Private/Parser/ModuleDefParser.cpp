@@ -45,8 +45,137 @@ bool FModuleDefParser::ParseTypes(
     return FTypespaceParser::ParseTypes(RawModuleDefJson, TypesOutput, OutError);
 }
 
+// Reads a SATS-JSON ColList, either a bare array of column ids or wrapped in a 'columns'/'column' object.
+static bool ParseColumnIds(const TSharedPtr<FJsonValue>& ColumnsValue, TArray<uint16>& OutColumnIds)
+{
+    if (!ColumnsValue.IsValid())
+    {
+        return false;
+    }
+
+    if (const TSharedPtr<FJsonObject>* Wrapper; ColumnsValue->TryGetObject(Wrapper))
+    {
+        if ((*Wrapper)->HasField(TEXT("columns")))
+        {
+            return ParseColumnIds((*Wrapper)->TryGetField(TEXT("columns")), OutColumnIds);
+        }
+        return ParseColumnIds((*Wrapper)->TryGetField(TEXT("column")), OutColumnIds);
+    }
+
+    if (const TArray<TSharedPtr<FJsonValue>>* Array; ColumnsValue->TryGetArray(Array))
+    {
+        for (const auto& Column : *Array)
+        {
+            uint32 ColumnId;
+            if (!Column->TryGetNumber(ColumnId))
+            {
+                return false;
+            }
+            OutColumnIds.Add(static_cast<uint16>(ColumnId));
+        }
+        return OutColumnIds.Num() > 0;
+    }
+
+    if (uint32 ColumnId; ColumnsValue->TryGetNumber(ColumnId))
+    {
+        OutColumnIds.Add(static_cast<uint16>(ColumnId));
+        return true;
+    }
+
+    return false;
+}
+
+bool FModuleDefParser::ParseIndexes(
+    const TSharedPtr<FJsonObject>& TableJson,
+    const SATS::FTypespace& Typespace,
+    SATS::FTableDef& Table,
+    FString& OutError)
+{
+    const TArray<TSharedPtr<FJsonValue>>* Indexes;
+    if (!TableJson->TryGetArrayField(TEXT("indexes"), Indexes))
+    {
+        // Older module definitions have no 'indexes' at all
+        return true;
+    }
+
+    if (!Typespace.TypeEntries.IsValidIndex(Table.ProductTypeRef) ||
+        Typespace.TypeEntries[Table.ProductTypeRef].Tag != SATS::EType::Product)
+    {
+        OutError = FString::Printf(TEXT("Table '%s' does not refer to a Product type in typespace"), *Table.Name);
+        return false;
+    }
+    const auto& RowElements = Typespace.TypeEntries[Table.ProductTypeRef].Product.Elements;
+
+    for (const auto& IndexValue : *Indexes)
+    {
+        const TSharedPtr<FJsonObject> IndexObj = IndexValue->AsObject();
+        if (!IndexObj.IsValid())
+        {
+            OutError = FString::Printf(TEXT("Invalid index entry in table '%s'; expected JSON object"), *Table.Name);
+            return false;
+        }
+
+        SATS::FIndexDef Index;
+
+        // 'name' is an Option<String> in RawModuleDefV9, a plain string before that
+        if (const TSharedPtr<FJsonObject>* NameObj; IndexObj->TryGetObjectField(TEXT("name"), NameObj))
+        {
+            Index.Name = FCommon::UnwrapOptionString(*NameObj);
+        }
+        else
+        {
+            IndexObj->TryGetStringField(TEXT("name"), Index.Name);
+        }
+
+        if (const TSharedPtr<FJsonObject>* AccessorObj; IndexObj->TryGetObjectField(TEXT("accessor_name"), AccessorObj))
+        {
+            Index.AccessorName = FCommon::GetOptionalString(*AccessorObj);
+        }
+
+        const TSharedPtr<FJsonObject> AlgorithmObj = FCommon::ParseRequiredObject(IndexObj, TEXT("algorithm"), OutError);
+        if (!AlgorithmObj.IsValid() || AlgorithmObj->Values.Num() != 1)
+        {
+            OutError = FString::Printf(TEXT("Invalid 'algorithm' in index '%s' of table '%s'"), *Index.Name, *Table.Name);
+            return false;
+        }
+
+        const auto& [AlgorithmName, AlgorithmValue] = *AlgorithmObj->Values.CreateConstIterator();
+        if      (AlgorithmName == TEXT("BTree"))  Index.Algorithm = SATS::EIndexAlgorithm::BTree;
+        else if (AlgorithmName == TEXT("Hash"))   Index.Algorithm = SATS::EIndexAlgorithm::Hash;
+        else if (AlgorithmName == TEXT("Direct")) Index.Algorithm = SATS::EIndexAlgorithm::Direct;
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[spacetime] Skipping index '%s' of table '%s': unknown algorithm '%s'"),
+                *Index.Name, *Table.Name, *AlgorithmName);
+            continue;
+        }
+
+        if (!ParseColumnIds(AlgorithmValue, Index.ColumnIds))
+        {
+            OutError = FString::Printf(TEXT("Invalid column list in index '%s' of table '%s'"), *Index.Name, *Table.Name);
+            return false;
+        }
+
+        for (const uint16 ColumnId : Index.ColumnIds)
+        {
+            if (!RowElements.IsValidIndex(ColumnId) || !RowElements[ColumnId].Name.IsSet())
+            {
+                OutError = FString::Printf(TEXT("Index '%s' of table '%s' refers to unknown column %d"),
+                    *Index.Name, *Table.Name, ColumnId);
+                return false;
+            }
+            Index.Columns.Add(RowElements[ColumnId].Name.GetValue());
+        }
+
+        Table.Indexes.Add(MoveTemp(Index));
+    }
+
+    return true;
+}
+
 bool FModuleDefParser::ParseTables(
     const TSharedPtr<FJsonObject>& RawModuleDefJson,
+    const SATS::FTypespace& Typespace,
     TArray<SATS::FTableDef>& TablesOutput,
     FString& OutError)
 {
@@ -60,14 +189,29 @@ bool FModuleDefParser::ParseTables(
             SATS::FTableDef T;
             T.Name = Obj->GetStringField(TEXT("name"));
             T.ProductTypeRef = Obj->GetIntegerField(TEXT("product_type_ref"));
-            // primary_key
+            // primary_key: column ids, resolved to column names like index columns
             const TArray<TSharedPtr<FJsonValue>>* PrimaryKeyArray;
             if (Obj->TryGetArrayField(TEXT("primary_key"), PrimaryKeyArray)) {
+                const SATS::FProductType* RowType =
+                    Typespace.TypeEntries.IsValidIndex(T.ProductTypeRef) ? &Typespace.TypeEntries[T.ProductTypeRef].Product : nullptr;
                 for (auto& P : *PrimaryKeyArray) {
-                    T.PrimaryKey.Add(P->AsString());
+                    uint32 ColumnId;
+                    if (!P->TryGetNumber(ColumnId)) {
+                        T.PrimaryKey.Add(P->AsString());
+                        continue;
+                    }
+                    if (!RowType || !RowType->Elements.IsValidIndex(ColumnId) || !RowType->Elements[ColumnId].Name.IsSet()) {
+                        OutError = FString::Printf(TEXT("Primary key of table '%s' refers to unknown column %u"), *T.Name, ColumnId);
+                        return false;
+                    }
+                    T.PrimaryKey.Add(RowType->Elements[ColumnId].Name.GetValue());
                 }
             }
-            // TODO: parse indexes, constraints, sequences, schedule, access
+            if (!ParseIndexes(Obj, Typespace, T, OutError))
+            {
+                return false;
+            }
+            // TODO: parse constraints, sequences, schedule, access
             TablesOutput.Add(MoveTemp(T));
         }
 
@@ -193,7 +337,7 @@ bool FModuleDefParser::ParseRawModuleDef(
     }
 
     // --- tables ---
-    if (!ParseTables(RawModuleDefJson, OutDef.Tables, OutError))
+    if (!ParseTables(RawModuleDefJson, OutDef.Typespace, OutDef.Tables, OutError))
     {
         OutError = TEXT("Failed to parse tables: ") + OutError;
         return false;
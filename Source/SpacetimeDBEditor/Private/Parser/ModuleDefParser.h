@@ -34,8 +34,15 @@ private:
 		FString& OutError);
 	static bool ParseTables(
 		const TSharedPtr<FJsonObject>& RawModuleDefJson,
+		const SATS::FTypespace& Typespace,
 		TArray<SATS::FTableDef>& TablesOutput,
 		FString& OutError);
+	/** Parses a table's 'indexes' and resolves their column ids to names using the table's row type. */
+	static bool ParseIndexes(
+		const TSharedPtr<FJsonObject>& TableJson,
+		const SATS::FTypespace& Typespace,
+		SATS::FTableDef& Table,
+		FString& OutError);
 	static bool ParseReducers(
 		const TSharedPtr<FJsonObject>& RawModuleDefJson,
 		TArray<SATS::FReducerDef>& ReducersOutput,
@@ -0,0 +1,378 @@
+#include "SchemaBrowser/SpacetimeSchemaModel.h"
+
+#include "Algo/Sort.h"
+#include "CodeGen/SpacetimeCodegenCache.h"
+#include "CodeGen/SpacetimeDBCodegen.h"
+#include "Parser/Common.h"
+
+namespace
+{
+	using FItemPtr = FSpacetimeSchemaModel::FItemPtr;
+	using EKind = FSpacetimeSchemaItem::EKind;
+
+	FItemPtr MakeItem(const EKind Kind, FString Name, FString UnrealName, FString Details)
+	{
+		const FItemPtr Item = MakeShared<FSpacetimeSchemaItem>();
+		Item->Kind = Kind;
+		Item->Name = MoveTemp(Name);
+		Item->UnrealName = MoveTemp(UnrealName);
+		Item->Details = MoveTemp(Details);
+		return Item;
+	}
+
+	FString GetExportedName(const SATS::FExportedType& Type)
+	{
+		return Type.Name.Scope.IsEmpty() ? Type.Name.Name : FString::Join(Type.Name.Scope, TEXT("::")) + TEXT("::") + Type.Name.Name;
+	}
+
+	const SATS::FExportedType* FindExportedType(const SATS::FRawModuleDef& ModuleDef, const int32 TypeRef)
+	{
+		return ModuleDef.Types.FindByPredicate([TypeRef](const SATS::FExportedType& Type)
+		{
+			return Type.TypeRef == TypeRef;
+		});
+	}
+
+	const FStruct* FindStruct(const FHeader& Header, const FString& StructName)
+	{
+		return Header.GetStructs().FindByPredicate([&StructName](const FStruct& Struct)
+		{
+			return Struct.Name == StructName;
+		});
+	}
+
+	/** The SATS type, with references resolved to the exported type's name. */
+	FString DescribeType(const SATS::FAlgebraicType& Type, const SATS::FRawModuleDef& ModuleDef)
+	{
+		switch (Type.Tag)
+		{
+		case SATS::EType::Ref:
+			if (const SATS::FExportedType* Exported = FindExportedType(ModuleDef, Type.Ref.Index))
+			{
+				return GetExportedName(*Exported);
+			}
+			return FString::Printf(TEXT("Ref %u"), Type.Ref.Index);
+		case SATS::EType::Product:
+			return FString::Printf(TEXT("Product (%d fields)"), Type.Product.Elements.Num());
+		case SATS::EType::Sum:
+			return FString::Printf(TEXT("Sum (%d variants)"), Type.Sum.Options.Num());
+		default:
+			return SATS::TypeToString(Type.Tag);
+		}
+	}
+
+	/** Placeholders stand in for types the generator cannot represent yet; they start with a comment. */
+	FString GetUnrealMember(const FString& Type, const FString& Name)
+	{
+		return Type.StartsWith(TEXT("//")) ? FString() : Type + TEXT(" ") + Name;
+	}
+
+	/** The fields of a product type, with the members the types IR generated for them, which follow the same order. */
+	void AddFields(const FItemPtr& Parent, const SATS::FProductType& Product, const FStruct* Struct, const SATS::FRawModuleDef& ModuleDef)
+	{
+		for (int32 i = 0; i < Product.Elements.Num(); ++i)
+		{
+			const SATS::FProductType::FField& Element = Product.Elements[i];
+			FString UnrealName;
+			if (Struct && Struct->Attributes.IsValidIndex(i))
+			{
+				UnrealName = GetUnrealMember(Struct->Attributes[i].Type, Struct->Attributes[i].Name);
+			}
+			Parent->Children.Add(MakeItem(
+				EKind::Field,
+				Element.Name.IsSet() ? *Element.Name : FString::Printf(TEXT("#%d"), i),
+				MoveTemp(UnrealName),
+				Element.AlgebraicType.IsValid() ? DescribeType(*Element.AlgebraicType, ModuleDef) : FString()));
+		}
+	}
+
+	const TCHAR* GetAlgorithmName(const SATS::EIndexAlgorithm Algorithm)
+	{
+		switch (Algorithm)
+		{
+		case SATS::EIndexAlgorithm::BTree:  return TEXT("BTree");
+		case SATS::EIndexAlgorithm::Hash:   return TEXT("Hash");
+		case SATS::EIndexAlgorithm::Direct: return TEXT("Direct");
+		default:                            return TEXT("Unknown");
+		}
+	}
+
+	void SortByName(TArray<FItemPtr>& Items)
+	{
+		Algo::Sort(Items, [](const FItemPtr& A, const FItemPtr& B)
+		{
+			return A->Name < B->Name;
+		});
+	}
+}
+
+TSharedRef<FSpacetimeSchemaModel> FSpacetimeSchemaModel::Build(const FSpacetimeParsedModule& Module)
+{
+	const SATS::FRawModuleDef& ModuleDef = Module.RawModule;
+	const FString& ModuleName = Module.DatabaseName;
+	const FString ModulePascal = FCommon::ToPascalCase(ModuleName);
+	const TSharedRef<FSpacetimeSchemaModel> Model = MakeShared<FSpacetimeSchemaModel>();
+
+	// Unreal names as FSpacetimeDBCodeGen and FTypespaceStructIRBuilder generate them
+	const FItemPtr Tables = MakeItem(EKind::Category, TEXT("Tables"), FString(), FString());
+	for (const SATS::FTableDef& Table : ModuleDef.Tables)
+	{
+		const SATS::FExportedType* RowType = FindExportedType(ModuleDef, Table.ProductTypeRef);
+		const FString RowStructName = RowType ? FCommon::MakeStructName(RowType->Name.Name, ModuleName) : FString();
+
+		const FItemPtr Item = MakeItem(
+			EKind::Table,
+			Table.Name,
+			TEXT("F") + ModulePascal + FCommon::ToPascalCase(Table.Name) + TEXT("Table"),
+			FString::Printf(TEXT("%s %s, rows %s, primary key %s"),
+				*Table.TableAccess, *Table.TableType,
+				RowType ? *RowStructName : TEXT("(not exported)"),
+				Table.PrimaryKey.IsEmpty() ? TEXT("(none)") : *FString::Join(Table.PrimaryKey, TEXT(", "))));
+
+		const FStruct* RowStruct = FindStruct(Module.ExportedTypesHeader, RowStructName);
+		if (ModuleDef.Typespace.TypeEntries.IsValidIndex(Table.ProductTypeRef))
+		{
+			AddFields(Item, ModuleDef.Typespace.TypeEntries[Table.ProductTypeRef].Product, RowStruct, ModuleDef);
+		}
+		const TArray<FString> Accessors = RowStruct ? FSpacetimeDBCodeGen::GetIndexAccessors(Table, *RowStruct) : TArray<FString>();
+		for (int32 i = 0; i < Table.Indexes.Num(); ++i)
+		{
+			const SATS::FIndexDef& Index = Table.Indexes[i];
+			Item->Children.Add(MakeItem(
+				EKind::Index,
+				Index.Name,
+				Accessors.IsValidIndex(i) && !Accessors[i].IsEmpty() ? TEXT("FindBy") + Accessors[i] : FString(),
+				FString::Printf(TEXT("%s index on %s"), GetAlgorithmName(Index.Algorithm), *FString::Join(Index.Columns, TEXT(", ")))));
+		}
+		Tables->Children.Add(Item);
+	}
+
+	const FItemPtr Reducers = MakeItem(EKind::Category, TEXT("Reducers"), FString(), FString());
+	const FString ReducersClassName = TEXT("U") + ModulePascal + TEXT("Reducers");
+	for (const SATS::FReducerDef& Reducer : ModuleDef.Reducers)
+	{
+		const FItemPtr Item = MakeItem(
+			EKind::Reducer,
+			Reducer.Name,
+			ReducersClassName + TEXT("::") + FCommon::ToPascalCase(Reducer.Name),
+			FString::Printf(TEXT("%d parameters"), Reducer.Params.Num()));
+
+		for (int32 i = 0; i < Reducer.Params.Num(); ++i)
+		{
+			const SATS::FReducerDef::FParam& Param = Reducer.Params[i];
+			const FString Name = Param.Name.IsSet() ? *Param.Name : FString::Printf(TEXT("#%d"), i);
+
+			FString UnrealType;
+			if (Param.Type.Tag == SATS::EType::Ref)
+			{
+				if (const SATS::FExportedType* Exported = FindExportedType(ModuleDef, Param.Type.Ref.Index))
+				{
+					UnrealType = FCommon::MakeStructName(Exported->Name.Name, ModuleName);
+				}
+			}
+			else if (SATS::IsBuiltinWithNativeRepresentation(Param.Type.Tag))
+			{
+				UnrealType = SATS::MapBuiltinToUnreal(SATS::TypeToString(Param.Type.Tag), false);
+			}
+
+			Item->Children.Add(MakeItem(
+				EKind::Field,
+				Name,
+				UnrealType.IsEmpty() ? FString() : GetUnrealMember(UnrealType, FCommon::ToPascalCase(Name)),
+				DescribeType(Param.Type, ModuleDef)));
+		}
+		Reducers->Children.Add(Item);
+	}
+
+	const FItemPtr Types = MakeItem(EKind::Category, TEXT("Types"), FString(), FString());
+	for (const SATS::FExportedType& Type : ModuleDef.Types)
+	{
+		const FString StructName = FCommon::MakeStructName(Type.Name.Name, ModuleName);
+		const FItemPtr Item = MakeItem(EKind::Type, GetExportedName(Type), StructName, FString());
+
+		if (ModuleDef.Typespace.TypeEntries.IsValidIndex(Type.TypeRef))
+		{
+			const SATS::FAlgebraicType& AlgebraicType = ModuleDef.Typespace.TypeEntries[Type.TypeRef];
+			Item->Details = DescribeType(AlgebraicType, ModuleDef);
+			if (AlgebraicType.Tag == SATS::EType::Product)
+			{
+				AddFields(Item, AlgebraicType.Product, FindStruct(Module.ExportedTypesHeader, StructName), ModuleDef);
+			}
+		}
+		Types->Children.Add(Item);
+	}
+
+	// Modules list things in declaration order, which is no help in a long list
+	SortByName(Tables->Children);
+	SortByName(Reducers->Children);
+	SortByName(Types->Children);
+
+	Model->NumTables = Tables->Children.Num();
+	Model->NumReducers = Reducers->Children.Num();
+	Model->NumTypes = Types->Children.Num();
+	Tables->Details = FString::Printf(TEXT("%d tables"), Model->NumTables);
+	Reducers->Details = FString::Printf(TEXT("%d reducers"), Model->NumReducers);
+	Types->Details = FString::Printf(TEXT("%d types"), Model->NumTypes);
+
+	Model->Roots = {Tables, Reducers, Types};
+	for (const FItemPtr& Root : Model->Roots)
+	{
+		Model->AddItem(Root, INDEX_NONE);
+	}
+	return Model;
+}
+
+void FSpacetimeSchemaModel::AddItem(const FItemPtr& Item, const int32 ParentIndex)
+{
+	Item->Index = Items.Num();
+	Item->ParentIndex = ParentIndex;
+	Item->VisibleChildren = Item->Children;
+	Items.Add(Item);
+
+	// Categories are not searched, or 'type' would find every type
+	FString& Text = SearchTexts.AddDefaulted_GetRef();
+	if (Item->Kind != EKind::Category)
+	{
+		Text = (Item->Name + TEXT("\n") + Item->UnrealName).ToLower();
+		for (int32 i = 0; i + 3 <= Text.Len(); ++i)
+		{
+			TArray<int32>& Postings = Trigrams.FindOrAdd(MakeTrigram(*Text + i));
+			if (Postings.IsEmpty() || Postings.Last() != Item->Index)
+			{
+				Postings.Add(Item->Index);
+			}
+		}
+	}
+
+	for (const FItemPtr& Child : Item->Children)
+	{
+		AddItem(Child, Item->Index);
+	}
+	Item->SubtreeEnd = Items.Num();
+}
+
+uint64 FSpacetimeSchemaModel::MakeTrigram(const TCHAR* Chars)
+{
+	constexpr uint64 Mask = (uint64(1) << 21) - 1;
+	return (static_cast<uint64>(Chars[0]) & Mask) << 42
+		| (static_cast<uint64>(Chars[1]) & Mask) << 21
+		| (static_cast<uint64>(Chars[2]) & Mask);
+}
+
+TArray<int32> FSpacetimeSchemaModel::Search(const FString& Query) const
+{
+	const FString Lower = Query.ToLower();
+	TArray<int32> Matches;
+
+	TArray<int32> Candidates;
+	if (Lower.Len() < 3)
+	{
+		Candidates.Reserve(Items.Num());
+		for (int32 Index = 0; Index < Items.Num(); ++Index)
+		{
+			Candidates.Add(Index);
+		}
+	}
+	else
+	{
+		TArray<const TArray<int32>*> Lists;
+		for (int32 i = 0; i + 3 <= Lower.Len(); ++i)
+		{
+			const TArray<int32>* Postings = Trigrams.Find(MakeTrigram(*Lower + i));
+			if (!Postings)
+			{
+				return Matches;
+			}
+			Lists.AddUnique(Postings);
+		}
+
+		// Shortest first, so the candidates only shrink
+		Algo::Sort(Lists, [](const TArray<int32>* A, const TArray<int32>* B)
+		{
+			return A->Num() < B->Num();
+		});
+		Candidates = *Lists[0];
+		for (int32 List = 1; List < Lists.Num() && !Candidates.IsEmpty(); ++List)
+		{
+			const TArray<int32>& Postings = *Lists[List];
+			TArray<int32> Common;
+			int32 Next = 0;
+			for (const int32 Index : Candidates)
+			{
+				while (Next < Postings.Num() && Postings[Next] < Index)
+				{
+					++Next;
+				}
+				if (Next < Postings.Num() && Postings[Next] == Index)
+				{
+					Common.Add(Index);
+				}
+			}
+			Candidates = MoveTemp(Common);
+		}
+	}
+
+	// Trigrams in common do not make a substring; their order does
+	for (const int32 Index : Candidates)
+	{
+		if (!SearchTexts[Index].IsEmpty() && SearchTexts[Index].Contains(Lower, ESearchCase::CaseSensitive))
+		{
+			Matches.Add(Index);
+		}
+	}
+	return Matches;
+}
+
+int32 FSpacetimeSchemaModel::ApplyFilter(const FString& Query, TArray<FItemPtr>& OutRoots, TArray<FItemPtr>& OutExpand)
+{
+	const FString Trimmed = Query.TrimStartAndEnd();
+	if (Trimmed.IsEmpty())
+	{
+		for (const FItemPtr& Item : Items)
+		{
+			Item->VisibleChildren = Item->Children;
+		}
+		OutRoots = Roots;
+		return Items.Num();
+	}
+
+	// A match shows with its subtree, so matches inside it need no work of their own
+	const TArray<int32> Matches = Search(Trimmed);
+	TBitArray<> Visible(false, Items.Num());
+	int32 CoveredEnd = 0;
+	for (const int32 Match : Matches)
+	{
+		if (Match < CoveredEnd)
+		{
+			continue;
+		}
+		const FSpacetimeSchemaItem& Item = *Items[Match];
+		for (int32 Index = Match; Index < Item.SubtreeEnd; ++Index)
+		{
+			Visible[Index] = true;
+		}
+		CoveredEnd = Item.SubtreeEnd;
+
+		for (int32 Parent = Item.ParentIndex; Parent != INDEX_NONE && !Visible[Parent]; Parent = Items[Parent]->ParentIndex)
+		{
+			Visible[Parent] = true;
+			OutExpand.Add(Items[Parent]);
+		}
+	}
+
+	for (const FItemPtr& Item : Items)
+	{
+		if (Visible[Item->Index])
+		{
+			Item->VisibleChildren = Item->Children.FilterByPredicate([&Visible](const FItemPtr& Child)
+			{
+				return Visible[Child->Index];
+			});
+		}
+	}
+	OutRoots = Roots.FilterByPredicate([&Visible](const FItemPtr& Root)
+	{
+		return Visible[Root->Index];
+	});
+	return Matches.Num();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSpacetimeParsedModule;
+
+/** One row of the schema browser: a table, reducer or exported type, or one of their fields. */
+struct FSpacetimeSchemaItem
+{
+	enum class EKind : uint8 { Category, Table, Reducer, Type, Field, Index };
+
+	EKind Kind = EKind::Field;
+
+	/** As the module declares it. */
+	FString Name;
+
+	/** What the generated code calls it: the table's cache class, a reducer's function, a field's type and member. */
+	FString UnrealName;
+
+	/** The SATS type of a field, the algorithm and columns of an index, a summary for the rest. */
+	FString Details;
+
+	TArray<TSharedPtr<FSpacetimeSchemaItem>> Children;
+
+	/** The children that pass the current filter; all of them without a filter. */
+	TArray<TSharedPtr<FSpacetimeSchemaItem>> VisibleChildren;
+
+	/** Position in the model, in tree order; the item's descendants follow it up to SubtreeEnd. */
+	int32 Index = INDEX_NONE;
+	int32 SubtreeEnd = INDEX_NONE;
+	int32 ParentIndex = INDEX_NONE;
+};
+
+/**
+ * The tables, reducers and exported types of a parsed module as a tree, with a trigram index over
+ * the names of every item, fields included.
+ *
+ * Searching looks up the query's trigrams and intersects their posting lists, then confirms the
+ * few candidates left, so a filter stays instant over modules with thousands of types. Queries
+ * shorter than a trigram scan every item.
+ *
+ * Built on any thread; filtered on the game thread.
+ */
+class FSpacetimeSchemaModel
+{
+public:
+	using FItemPtr = TSharedPtr<FSpacetimeSchemaItem>;
+
+	static TSharedRef<FSpacetimeSchemaModel> Build(const FSpacetimeParsedModule& Module);
+
+	/** Indices of the items whose name or Unreal name contains Query, ignoring case, in tree order. */
+	TArray<int32> Search(const FString& Query) const;
+
+	/**
+	 * Shows only the items Search finds, with their ancestors and descendants; everything for an
+	 * empty query. Updates VisibleChildren and OutRoots.
+	 * @param OutExpand Ancestors of the matches, to expand so the matches can be seen
+	 * @return Number of matches; every item for an empty query
+	 */
+	int32 ApplyFilter(const FString& Query, TArray<FItemPtr>& OutRoots, TArray<FItemPtr>& OutExpand);
+
+	const TArray<FItemPtr>& GetRoots() const { return Roots; }
+	int32 GetNumItems() const { return Items.Num(); }
+
+	int32 NumTables = 0;
+	int32 NumReducers = 0;
+	int32 NumTypes = 0;
+
+private:
+	/** Appends Item and its subtree in tree order, and indexes their names. */
+	void AddItem(const FItemPtr& Item, int32 ParentIndex);
+
+	/** Three lowercase characters, 21 bits each. */
+	static uint64 MakeTrigram(const TCHAR* Chars);
+
+	TArray<FItemPtr> Roots;
+	TArray<FItemPtr> Items;
+
+	/** Lowercase name and Unreal name of every item, by index. */
+	TArray<FString> SearchTexts;
+
+	/** Items containing each trigram, in increasing order. */
+	TMap<uint64, TArray<int32>> Trigrams;
+};
@@ -0,0 +1,137 @@
+#include "SpacetimeCodegenTask.h"
+
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "SpacetimeDBEditorHelpers.h"
+#include "SpacetimeDBEditorSettings.h"
+#include "SpacetimeProcessRunner.h"
+
+#define LOCTEXT_NAMESPACE "SpacetimeDBCodegenTask"
+
+FText GetSpacetimeCodegenPhaseText(const ESpacetimeCodegenPhase Phase)
+{
+	switch (Phase)
+	{
+	case ESpacetimeCodegenPhase::Fetching:   return LOCTEXT("Fetching", "Fetching the module definition");
+	case ESpacetimeCodegenPhase::Parsing:    return LOCTEXT("Parsing", "Parsing the module definition");
+	case ESpacetimeCodegenPhase::Generating: return LOCTEXT("Generating", "Generating code");
+	case ESpacetimeCodegenPhase::Writing:    return LOCTEXT("Writing", "Writing files");
+	default:                                 return FText::GetEmpty();
+	}
+}
+
+FText FSpacetimeCodegenSummary::ToText() const
+{
+	TArray<FText> Lines;
+	for (const FDatabase& Database : Databases)
+	{
+		if (Database.Error.IsEmpty())
+		{
+			Lines.Add(FText::Format(
+				LOCTEXT("SummaryDatabase", "✅ {0}: {1} tables, {2} reducers, {3} types ({4} s)"),
+				FText::FromString(Database.Name),
+				Database.NumTables,
+				Database.NumReducers,
+				Database.NumTypes,
+				FText::AsNumber(Database.Seconds, &FNumberFormattingOptions().SetMaximumFractionalDigits(1))));
+			if (Database.bCompanion)
+			{
+				Lines.Last() = FText::Format(LOCTEXT("SummaryCompanion", "{0}, regenerated for the types it shares"), Lines.Last());
+			}
+		}
+		else if (Database.bCompanion)
+		{
+			Lines.Add(FText::Format(LOCTEXT("SummaryCompanionSkipped", "⚠️ {0}: {1} Skipped, its types are not shared."), FText::FromString(Database.Name), FText::FromString(Database.Error)));
+		}
+		else
+		{
+			Lines.Add(FText::Format(LOCTEXT("SummaryDatabaseFailed", "🛑 {0}: {1}"), FText::FromString(Database.Name), FText::FromString(Database.Error)));
+		}
+	}
+
+	if (!SharedTypes.IsEmpty())
+	{
+		Lines.Add(FText::Format(LOCTEXT("SummaryShared", "Shared types ({0}): {1}"), SharedTypes.Num(), FText::FromString(FString::Join(SharedTypes, TEXT(", ")))));
+	}
+
+	Lines.Add(Succeeded()
+		? FText::Format(LOCTEXT("SummarySucceeded", "Wrote {0} of {1} files, the others were unchanged, to {2} in {3} s"),
+			NumFilesWritten,
+			NumFiles,
+			FText::FromString(OutputPath),
+			FText::AsNumber(Seconds, &FNumberFormattingOptions().SetMaximumFractionalDigits(1)))
+		: FText::Format(LOCTEXT("SummaryFailed", "Nothing was written: {0}"), FText::FromString(Error)));
+
+	return FText::Join(FText::FromString(TEXT("\n")), Lines);
+}
+
+int32 FSpacetimeCodegenTask::NumRunning = 0;
+
+FSpacetimeCodegenTask::FSpacetimeCodegenTask(const FString& InServerURL, TArray<FString> InDatabaseNames)
+	: ServerURL(InServerURL)
+	, DatabaseNames(MoveTemp(InDatabaseNames))
+{
+	check(IsInGameThread());
+	CompanionDatabaseNames = GetDefault<USpacetimeDBEditorSettings>()->GetAllDatabases();
+	CompanionDatabaseNames.RemoveAll([this](const FString& Name)
+	{
+		return DatabaseNames.Contains(Name);
+	});
+}
+
+void FSpacetimeCodegenTask::Start()
+{
+	check(!bRunning);
+	bRunning = true;
+	++NumRunning;
+
+	Async(EAsyncExecution::Thread, [This = AsShared()]
+	{
+		FSpacetimeCodegenSummary Summary;
+		USpacetimeDBEditorHelpers::GenerateCodeForDatabases(This->ServerURL, This->DatabaseNames, This->CompanionDatabaseNames, Summary, &This.Get());
+
+		AsyncTask(ENamedThreads::GameThread, [This, Summary = MoveTemp(Summary)]
+		{
+			This->bRunning = false;
+			--NumRunning;
+			This->OnCompleted.ExecuteIfBound(Summary);
+		});
+	});
+}
+
+void FSpacetimeCodegenTask::Cancel()
+{
+	bCanceled = true;
+
+	FScopeLock ScopeLock(&ProcessLock);
+	for (const TSharedRef<FSpacetimeProcessRunner>& Process : Processes)
+	{
+		Process->Cancel();
+	}
+}
+
+void FSpacetimeCodegenTask::EnterPhase(const ESpacetimeCodegenPhase Phase)
+{
+	if (OnPhase.IsBound())
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakPtr<FSpacetimeCodegenTask>(AsShared()), Phase]
+		{
+			if (const TSharedPtr<FSpacetimeCodegenTask> This = WeakThis.Pin(); This && This->bRunning)
+			{
+				This->OnPhase.ExecuteIfBound(Phase);
+			}
+		});
+	}
+}
+
+void FSpacetimeCodegenTask::AttachProcess(const TSharedRef<FSpacetimeProcessRunner>& Runner)
+{
+	FScopeLock ScopeLock(&ProcessLock);
+	Processes.Add(Runner);
+	if (bCanceled)
+	{
+		Runner->Cancel();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,10 +2,16 @@
 
 
 #include "SpacetimeDBEditorHelpers.h"
+#include "Algo/Count.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "CodeGen/SpacetimeCodegenCache.h"
 #include "CodeGen/SpacetimeDBCodegen.h"
-#include "HAL/PlatformProcess.h"
+#include "SpacetimeCodegenTask.h"
+#include "SpacetimeDBEditorSettings.h"
+#include "SpacetimeProcessRunner.h"
 #include "IO/CodeFileWriter.h"
 #include "Parser/ModuleDefParser.h"
 #include "Schema/SchemaModels.h"
@@ -17,21 +23,24 @@
 
 bool RawModuleDefFromCli(
 	const FString &DatabaseName,
-	FString &Output);
+	FString &Output,
+	FSpacetimeCodegenTask* Task);
 
-bool RawModuleDefFromHttp(
-	const FString& ServerURL,
+TSharedRef<FSpacetimeProcessRunner> LaunchCliDescribe(
 	const FString& DatabaseName,
-	FString& OutRawModuleDef);
+	FSpacetimeCodegenTask* Task,
+	TFuture<FSpacetimeProcessResult>& OutResult);
 
-static bool FetchRawData(
+bool ReadCliDescribe(
+	const FSpacetimeProcessResult& Result,
+	const FSpacetimeProcessParams& Params,
+	FString& Output);
+
+bool RawModuleDefFromHttp(
 	const FString& ServerURL,
 	const FString& DatabaseName,
-	FString& OutRawModuleDef)
-{	
-	return RawModuleDefFromCli(DatabaseName, OutRawModuleDef);
-	// return RawModuleDefFromHttp(ServerURL, DatabaseName, OutRawModuleDef);
-}
+	FString& OutRawModuleDef,
+	FSpacetimeCodegenTask* Task);
 
 // Converts any snake_case, kebab-case, space separated, or camelCase string
 // into PascalCase (e.g. "chat_message" → "ChatMessage", "sendMessage" → "SendMessage").
@@ -77,236 +86,549 @@ auto ToPascalCase = [](const FString& InString) -> FString
 	return Result;
 };
 
-bool USpacetimeDBEditorHelpers::GenerateCxxUnrealCodeFromSpacetimeDB(
-	const FString& ServerURL,
-	const FString& DatabaseName,
-	FString& OutFullPath,
-	FString& OutError)
+/** One database on its way through code generation; nothing is written until all its files were generated. */
+struct FModuleCodegen
 {
-	const FString DatabaseNamePascal = ToPascalCase(DatabaseName);
-	const FString GeneratedDirectory = "StdbGenerated";
-
-	// 0. Fetch raw JSON schema
-    UE_LOG(LogTemp, Log, TEXT("[spacetime] Fetching RawModuleDef for '%s'"), *DatabaseName);
-    FString RawModuleDefString;
-    if (!FetchRawData(ServerURL, DatabaseName, RawModuleDefString))
-    {
-        OutError = TEXT("Failed to fetch raw module definition.");
-        UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-        return false;
-    }
-
-
-	// 1. Parse into SATS model
-    UE_LOG(LogTemp, Log, TEXT("[spacetime] Parsing RawModuleDef JSON"));
-    SATS::FRawModuleDef RawModule;
-	if (FModuleDefParser Parser; !Parser.Parse(RawModuleDefString, RawModule, OutError))
-    {
-        UE_LOG(LogTemp, Error, TEXT("[spacetime] RawModuleDef parse failed: %s"), *OutError);
-        return false;
-    }
-
-	// 2. Ensure output directory exists
-	const FString OutputDir = FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/<Public&Private>") / GeneratedDirectory;
-	const FString HeaderOutputDir = FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/Public") / GeneratedDirectory;
-	const FString SourceOutputDir = FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/Private") / GeneratedDirectory;
-    UE_LOG(LogTemp, Log, TEXT("[spacetime] Creating output directories '%s' and '%s'"), *HeaderOutputDir, *SourceOutputDir);
-    if (!IFileManager::Get().MakeDirectory(*HeaderOutputDir, /*Tree=*/ true) | !IFileManager::Get().MakeDirectory(*SourceOutputDir, /*Tree=*/ true))
-    {
-        OutError = TEXT("Failed to create output directory.");
-        UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-        return false;
-    }
-	
+	FString DatabaseName;
+	FString RawModuleDefString;
+	SATS::FRawModuleDef RawModule;
+
+	/** Generated again only for the types it shares; its schema fetched earlier will do. */
+	bool bCompanion = false;
+
+	/** IR of the types; FSpacetimeDBCodeGen::ExtractSharedTypes may move some of it to the shared header. */
+	FHeader ExportedTypesHeader;
+	FHeader InlineTypesHeader;
+
+	/** The exported types as built, in which the table caches find their rows, shared or not. */
+	FHeader RowTypesHeader;
+	bool bUsesSharedTypes = false;
+
+	/** Path and contents of every generated file. */
+	TArray<TPair<FString, FString>> Files;
+
+	/** Set by the step that failed. A companion that fails is left out of the run rather than failing it. */
+	FString Error;
+	double Seconds = 0.0;
+};
+
+static FString GetHeaderOutputDir()
+{
+	return FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/Public") / FSpacetimeConfig::GeneratedDirectory;
+}
+
+static FString GetSourceOutputDir()
+{
+	return FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/Private") / FSpacetimeConfig::GeneratedDirectory;
+}
+
+static FString GetFullOutputDir()
+{
+	FString OutputDir = FPaths::ProjectDir() / TEXT("Plugins/SpacetimeDB/Source/SpacetimeDBRuntime/<Public&Private>") / FSpacetimeConfig::GeneratedDirectory;
+	FPaths::ConvertRelativePathToFull(OutputDir);
+	return OutputDir;
+}
+
+static void EnterPhase(FSpacetimeCodegenTask* Task, const ESpacetimeCodegenPhase Phase)
+{
+	if (Task)
+	{
+		Task->EnterPhase(Phase);
+	}
+}
+
+static bool IsCanceled(const FSpacetimeCodegenTask* Task)
+{
+	return Task && Task->IsCanceled();
+}
+
+static const TCHAR* CanceledError = TEXT("Code generation was canceled.");
 
-	// 3. Generate typespace structs
+static bool FailModule(FModuleCodegen& Module, const FString& Error)
+{
+	Module.Error = Error;
+	if (Module.bCompanion)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating SATS-JSON Typespace Unreal-reflected C++ structs"));
-		
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] '%s': %s Its types are left out of the shared header."), *Module.DatabaseName, *Module.Error);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] '%s': %s"), *Module.DatabaseName, *Module.Error);
+	}
+	return false;
+}
+
+static bool IsSkippedCompanion(const FModuleCodegen& Module)
+{
+	return Module.bCompanion && !Module.Error.IsEmpty();
+}
+
+// Raw schemas fetched by earlier runs, this session or saved by an earlier one, for companions and for databases the task knows did not change
+static bool ReuseRawSchema(FModuleCodegen& Module, const FSpacetimeCodegenTask* Task)
+{
+	if ((Module.bCompanion || (Task && Task->CanReuseSchema(Module.DatabaseName)))
+		&& FSpacetimeCodegenCache::FindRawSchema(Module.DatabaseName, Module.RawModuleDefString))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Reusing the RawModuleDef fetched earlier for '%s'"), *Module.DatabaseName);
+		return true;
+	}
+	return false;
+}
+
+static bool FinishFetch(FModuleCodegen& Module, const FSpacetimeProcessResult& Result, const FSpacetimeProcessParams& Params, const FSpacetimeCodegenTask* Task)
+{
+	if (!ReadCliDescribe(Result, Params, Module.RawModuleDefString))
+	{
+		return FailModule(Module, IsCanceled(Task) ? CanceledError : TEXT("Failed to fetch raw module definition."));
+	}
+
+	FSpacetimeCodegenCache::AddRawSchema(Module.DatabaseName, Module.RawModuleDefString);
+	return true;
+}
+
+// Parses the raw JSON schema into the SATS model and the types IR
+static bool ParseModule(FModuleCodegen& Module)
+{
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Parsing RawModuleDef JSON of '%s'"), *Module.DatabaseName);
+	FString Error;
+	const bool bParsed = FModuleDefParser().Parse(Module.RawModuleDefString, Module.RawModule, Error);
+	Module.RawModuleDefString.Empty();
+	if (!bParsed)
+	{
+		return FailModule(Module, TEXT("RawModuleDef parse failed: ") + Error);
+	}
+
+	if (!FTypespaceStructIRBuilder::BuildTypesHeaders(
+		Module.DatabaseName,
+		Module.RawModule.Typespace,
+		Module.RawModule.Types,
+		Module.ExportedTypesHeader,
+		Module.InlineTypesHeader,
+		Error))
+	{
+		return FailModule(Module, TEXT("Failed to generate typespace structures: ") + Error);
+	}
+	Module.RowTypesHeader = Module.ExportedTypesHeader;
+
+	// For the schema browser, as parsed rather than as split up by ExtractSharedTypes
+	const TSharedRef<FSpacetimeParsedModule> Parsed = MakeShared<FSpacetimeParsedModule>();
+	Parsed->DatabaseName = Module.DatabaseName;
+	Parsed->RawModule = Module.RawModule;
+	Parsed->ExportedTypesHeader = Module.ExportedTypesHeader;
+	Parsed->ParseTime = FDateTime::UtcNow();
+	FSpacetimeCodegenCache::AddParsedModule(Parsed);
+	return true;
+}
+
+static bool GenerateModuleFiles(FModuleCodegen& Module)
+{
+	const FString& DatabaseName = Module.DatabaseName;
+	const FString HeaderOutputDir = GetHeaderOutputDir();
+	const FString SourceOutputDir = GetSourceOutputDir();
+	FString Error;
+
+	// Typespace structs
+	{
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating SATS-JSON Typespace Unreal-reflected C++ structs for '%s'"), *DatabaseName);
+
 		FString ExportedTypesHeaderCode;
 		FString InlineTypesHeaderCode;
-		// const FString BaseSpacetimeHeaderName = FString::Printf(TEXT("%sTypespace"), *DatabaseNamePascal);
-		if (!FSpacetimeDBCodeGen::GenerateTypespaceCode(
-			RawModule,						DatabaseName,
-			ExportedTypesHeaderCode,		InlineTypesHeaderCode,
-			OutError))
+		if (!FSpacetimeDBCodeGen::RenderTypesHeader(Module.ExportedTypesHeader, /*bTopoSort=*/ true, ExportedTypesHeaderCode, Error)
+			|| !FSpacetimeDBCodeGen::RenderTypesHeader(Module.InlineTypesHeader, /*bTopoSort=*/ false, InlineTypesHeaderCode, Error))
 		{
-			OutError = TEXT("Failed to generate typespace structures: ") + OutError;
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-			return false;
+			return FailModule(Module, TEXT("Failed to generate typespace structures: ") + Error);
 		}
 
-		const FString ExportedFilePath =
-			HeaderOutputDir / FSpacetimeConfig::MakeExportedTypesCodeFileName(DatabaseName) + ".h";
+		Module.Files.Emplace(HeaderOutputDir / FSpacetimeConfig::MakeExportedTypesCodeFileName(DatabaseName) + ".h", MoveTemp(ExportedTypesHeaderCode));
+		Module.Files.Emplace(HeaderOutputDir / FSpacetimeConfig::MakeInlineTypesCodeFileName(DatabaseName) + ".h", MoveTemp(InlineTypesHeaderCode));
+	}
 
-		const FString InlineFilePath =
-			HeaderOutputDir / FSpacetimeConfig::MakeInlineTypesCodeFileName(DatabaseName) + ".h";
-		
-		if (!FCodeFileWriter::WriteFile(ExportedFilePath, ExportedTypesHeaderCode, OutError))
-		{
-			OutError = TEXT("Failed to write typespace header file: ") + OutError;
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-			return false;
-		}
+	// BSATN decoders for the typespace structs, used by the table caches
+	{
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating BSATN codec for '%s'"), *DatabaseName);
 
-		if (!FCodeFileWriter::WriteFile(InlineFilePath, InlineTypesHeaderCode, OutError))
+		FString CodecHeader;
+		if (!FSpacetimeDBCodeGen::GenerateCodecCode(DatabaseName, Module.InlineTypesHeader, Module.ExportedTypesHeader, CodecHeader, Error, Module.bUsesSharedTypes))
 		{
-			OutError = TEXT("Failed to write typespace header file: ") + OutError;
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-			return false;
+			return FailModule(Module, TEXT("Codec generation failed: ") + Error);
 		}
-
-		// FString NicePath = ExportedFilePath;
-		// FPaths::NormalizeFilename(NicePath);
-		// FPaths::CollapseRelativeDirectories(NicePath);
-		// UE_LOG(LogTemp, Log, TEXT("[spacetime] Wrote typespace code to %s"), *NicePath);
-
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Typespace code output success"));
-		
+		Module.Files.Emplace(HeaderOutputDir / FSpacetimeConfig::MakeCodecCodeFileName(DatabaseName) + ".h", MoveTemp(CodecHeader));
 	}
-	
-	
-    // 4. Generate table structs header
-	if (0)
+
+	// Client-side table caches and their secondary indexes
 	{
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating SATS-JSON Tables' Unreal-reflected C++ structs"));
-		
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating client-side table caches for '%s'"), *DatabaseName);
+
 		FString TablesHeader;
-		const FString BaseTablesHeaderName = FString::Printf(TEXT("%sTables"), *DatabaseNamePascal);
-		if (!FSpacetimeDBCodeGen::GenerateTableStructs(RawModule, BaseTablesHeaderName, TablesHeader, OutError))
+		if (!FSpacetimeDBCodeGen::GenerateTableCaches(Module.RawModule, DatabaseName, Module.RowTypesHeader, TablesHeader, Error))
 		{
-			OutError = TEXT("Table struct generation failed: ") + OutError;
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-			return false;
+			return FailModule(Module, TEXT("Table cache generation failed: ") + Error);
 		}
-		const FString TablesHeaderName = BaseTablesHeaderName + ".h";
-		const FString TablesHeaderPath = HeaderOutputDir / TablesHeaderName;
-		if (!FCodeFileWriter::WriteFile(TablesHeaderPath, TablesHeader, OutError))
-		{
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] Failed to write tables header '%s': %s"), *TablesHeaderPath, *OutError);
-			return false;
-		}
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Wrote %s"), *TablesHeaderPath);
-	} 
+		Module.Files.Emplace(HeaderOutputDir / FSpacetimeConfig::MakeTablesCodeFileName(DatabaseName) + ".h", MoveTemp(TablesHeader));
+	}
 
-	
-    // 5. Generate STDB Reducer functions (header + source)
+	// STDB Reducer functions (header + source)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating reducer Blueprint nodes"));
-		
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Generating reducer Blueprint nodes for '%s'"), *DatabaseName);
+
 		FString ReducersHeader, ReducersSource;
 		if (!FSpacetimeDBCodeGen::GenerateReducerFunctions(
-			DatabaseNamePascal,
-			RawModule,
+			ToPascalCase(DatabaseName),
+			Module.RawModule,
 			ReducersHeader,
 			ReducersSource,
-			OutError))
+			Error))
 		{
-			OutError = TEXT("Reducer function generation failed: ") + OutError;
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
-			return false;
+			return FailModule(Module, TEXT("Reducer function generation failed: ") + Error);
 		}
 
-		const FString ReducersFilename = FSpacetimeConfig::MakeReducerCodeFileName(DatabaseName); 		
-		const FString ReducersHeaderPath = HeaderOutputDir / ReducersFilename + ".h";
-		const FString ReducersSourcePath = SourceOutputDir / ReducersFilename + ".cpp";
-		
-		if (!FCodeFileWriter::WriteFile(ReducersHeaderPath, ReducersHeader, OutError))
+		const FString ReducersFilename = FSpacetimeConfig::MakeReducerCodeFileName(DatabaseName);
+		Module.Files.Emplace(HeaderOutputDir / ReducersFilename + ".h", MoveTemp(ReducersHeader));
+		Module.Files.Emplace(SourceOutputDir / ReducersFilename + ".cpp", MoveTemp(ReducersSource));
+	}
+
+	return true;
+}
+
+// Writes the files whose contents changed; OutNumWritten counts them
+static bool WriteFiles(const TArray<TPair<FString, FString>>& Files, int32& OutNumWritten, FString& OutError)
+{
+	OutNumWritten = 0;
+	const FString HeaderOutputDir = GetHeaderOutputDir();
+	const FString SourceOutputDir = GetSourceOutputDir();
+
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Creating output directories '%s' and '%s'"), *HeaderOutputDir, *SourceOutputDir);
+	if (!IFileManager::Get().MakeDirectory(*HeaderOutputDir, /*Tree=*/ true) | !IFileManager::Get().MakeDirectory(*SourceOutputDir, /*Tree=*/ true))
+	{
+		OutError = TEXT("Failed to create output directory.");
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *OutError);
+		return false;
+	}
+
+	for (const TPair<FString, FString>& File : Files)
+	{
+		bool bWritten = false;
+		if (!FCodeFileWriter::WriteFileIfChanged(File.Key, File.Value, bWritten, OutError))
 		{
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] Failed to write reducers header '%s': %s"), *ReducersHeaderPath, *OutError);
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Failed to write '%s': %s"), *File.Key, *OutError);
 			return false;
 		}
 
-		FString NicePath = ReducersHeaderPath;
+		FString NicePath = File.Key;
 		FPaths::NormalizeFilename(NicePath);
 		FPaths::CollapseRelativeDirectories(NicePath);
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Wrote %s"), *NicePath);
-		
-		if (!FCodeFileWriter::WriteFile(ReducersSourcePath, ReducersSource, OutError))
+		if (bWritten)
 		{
-			UE_LOG(LogTemp, Error, TEXT("[spacetime] Failed to write reducers source '%s': %s"), *ReducersSourcePath, *OutError);
-			return false;
+			++OutNumWritten;
+			UE_LOG(LogTemp, Log, TEXT("[spacetime] Wrote %s"), *NicePath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Unchanged %s"), *NicePath);
 		}
+	}
+	return true;
+}
 
-		
-		NicePath = ReducersSourcePath;
-		FPaths::NormalizeFilename(NicePath);
-		FPaths::CollapseRelativeDirectories(NicePath);
-		UE_LOG(LogTemp, Log, TEXT("[spacetime] Wrote reducer code to %s"), *NicePath);
+bool USpacetimeDBEditorHelpers::GenerateCxxUnrealCodeFromSpacetimeDB(
+	const FString& ServerURL,
+	const FString& DatabaseName,
+	FString& OutFullPath,
+	FString& OutError)
+{
+	return GenerateCode(ServerURL, DatabaseName, OutFullPath, OutError, nullptr);
+}
+
+bool USpacetimeDBEditorHelpers::GenerateCode(
+	const FString& ServerURL,
+	const FString& DatabaseName,
+	FString& OutFullPath,
+	FString& OutError,
+	FSpacetimeCodegenTask* Task)
+{
+	// The other databases write to the same directory, and may share types with this one
+	TArray<FString> CompanionDatabaseNames;
+	if (Task)
+	{
+		CompanionDatabaseNames = Task->GetCompanionDatabaseNames();
 	}
+	else
+	{
+		check(IsInGameThread());
+		CompanionDatabaseNames = GetDefault<USpacetimeDBEditorSettings>()->GetAllDatabases();
+	}
+	CompanionDatabaseNames.Remove(DatabaseName);
 
-	
-    // 6. Success
-    OutFullPath = OutputDir;
-	FPaths::ConvertRelativePathToFull(OutFullPath);
-    UE_LOG(LogTemp, Log, TEXT("[spacetime] Code generation completed for SpacetimeDB Module '%s'"), *DatabaseName);
+	FSpacetimeCodegenSummary Summary;
+	if (!GenerateCodeForDatabases(ServerURL, { DatabaseName }, CompanionDatabaseNames, Summary, Task))
+	{
+		const FSpacetimeCodegenSummary::FDatabase* Failed = Summary.Databases.FindByPredicate([](const FSpacetimeCodegenSummary::FDatabase& Database)
+		{
+			return !Database.Error.IsEmpty() && !Database.bCompanion;
+		});
+		OutError = Failed ? FString::Printf(TEXT("'%s': %s"), *Failed->Name, *Failed->Error) : Summary.Error;
+		return false;
+	}
+
+	OutFullPath = Summary.OutputPath;
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Code generation completed for SpacetimeDB Module '%s'"), *DatabaseName);
 	UE_LOG(LogTemp, Log, TEXT("[spacetime] Location: %s"), *OutFullPath);
-	
-    return true;
-    
+
+	return true;
 }
 
-bool RawModuleDefFromCli(const FString &DatabaseName, FString &Output)
+bool USpacetimeDBEditorHelpers::GenerateCodeForDatabases(
+	const FString& ServerURL,
+	const TArray<FString>& DatabaseNames,
+	const TArray<FString>& CompanionDatabaseNames,
+	FSpacetimeCodegenSummary& OutSummary,
+	FSpacetimeCodegenTask* Task)
 {
-	// Build the CLI command and parameters
-	const FString Executable = TEXT("spacetime");
-	const FString Arguments  = FString::Printf(TEXT("describe --json %s"), *DatabaseName);
-
-	UE_LOG(LogTemp, Log, TEXT("[spacetime] Running command: %s %s"), *Executable, *Arguments);  // :contentReference[oaicite:0]{index=0}
-
-	int32 ReturnCode = -1;
-	FString StdOut;
-	FString StdErr;
-
-	// Execute synchronously, capturing stdout and stderr
-	const bool bLaunched = FPlatformProcess::ExecProcess(
-		*Executable,
-		*Arguments,
-		&ReturnCode,
-		&StdOut,
-		&StdErr,
-		nullptr,
-		/*bShouldEndWithParentProcess=*/ false
-	);  // :contentReference[oaicite:1]{index=1}
-
-	if (!bLaunched)
-	{
-		UE_LOG(LogTemp, Error,
-			TEXT("[spacetime] Failed to launch SpacetimeDB CLI executable '%s'"),
-			*Executable
-		);
-		return false;
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<FModuleCodegen> Modules;
+	auto AddModule = [&Modules](const FString& DatabaseName, const bool bCompanion)
+	{
+		if (!DatabaseName.IsEmpty() && !Modules.ContainsByPredicate([&DatabaseName](const FModuleCodegen& Module) { return Module.DatabaseName == DatabaseName; }))
+		{
+			FModuleCodegen& Module = Modules.AddDefaulted_GetRef();
+			Module.DatabaseName = DatabaseName;
+			Module.bCompanion = bCompanion;
+		}
+	};
+	for (const FString& DatabaseName : DatabaseNames)
+	{
+		AddModule(DatabaseName, false);
 	}
+	const bool bAnySelected = !Modules.IsEmpty();
 
-	// Check exit code
-	if (ReturnCode != 0)
+	// Whether a type is shared depends on every database generated into the output directory, not only on the ones asked for
+	if (bAnySelected)
 	{
-		UE_LOG(LogTemp, Error,
-			TEXT("[spacetime] SpacetimeDB CLI exited with code %d"), ReturnCode
-		);
-		if (!StdErr.IsEmpty())
+		for (const FString& DatabaseName : CompanionDatabaseNames)
+		{
+			AddModule(DatabaseName, true);
+		}
+	}
+
+	auto Finish = [&OutSummary, &Modules, StartTime](const FString& Error)
+	{
+		for (const FModuleCodegen& Module : Modules)
+		{
+			FSpacetimeCodegenSummary::FDatabase& Database = OutSummary.Databases.AddDefaulted_GetRef();
+			Database.Name = Module.DatabaseName;
+			Database.Error = Module.Error;
+			Database.NumTables = Module.RawModule.Tables.Num();
+			Database.NumReducers = Module.RawModule.Reducers.Num();
+			Database.NumTypes = Module.ExportedTypesHeader.GetHeaderElements().Num() + Module.InlineTypesHeader.GetHeaderElements().Num();
+			Database.Seconds = Module.Seconds;
+			Database.bCompanion = Module.bCompanion;
+		}
+		OutSummary.Error = Error;
+		OutSummary.Seconds = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Code generation for %d databases:\n%s"), Modules.Num(), *OutSummary.ToText().ToString());
+		return OutSummary.Succeeded();
+	};
+
+	// Why the run stops after a step, if it does
+	auto CheckStep = [&Modules, Task]() -> FString
+	{
+		if (IsCanceled(Task))
+		{
+			return CanceledError;
+		}
+		const int32 NumFailed = Algo::CountIf(Modules, [](const FModuleCodegen& Module) { return !Module.Error.IsEmpty() && !Module.bCompanion; });
+		return NumFailed > 0 ? FString::Printf(TEXT("%d of %d databases failed."), NumFailed, Modules.Num()) : FString();
+	};
+
+	// Runs one step for every database still going, side by side on the task graph
+	auto RunStep = [&Modules, Task, &CheckStep](const ESpacetimeCodegenPhase Phase, TFunctionRef<bool(FModuleCodegen&)> Step) -> FString
+	{
+		EnterPhase(Task, Phase);
+		ParallelFor(Modules.Num(), [&Modules, Task, &Step](const int32 Index)
+		{
+			FModuleCodegen& Module = Modules[Index];
+			if (!Module.Error.IsEmpty() || IsCanceled(Task))
+			{
+				return;
+			}
+			const double StepStart = FPlatformTime::Seconds();
+			Step(Module);
+			Module.Seconds += FPlatformTime::Seconds() - StepStart;
+		}, EParallelForFlags::Unbalanced);
+
+		return CheckStep();
+	};
+
+	if (!bAnySelected)
+	{
+		return Finish(TEXT("No database selected."));
+	}
+
+	// 0. Fetch every raw JSON schema: all the describes run at once, each on its runner's thread, while this one waits
+	EnterPhase(Task, ESpacetimeCodegenPhase::Fetching);
+	{
+		struct FDescribe
+		{
+			TSharedPtr<FSpacetimeProcessRunner> Runner;
+			TFuture<FSpacetimeProcessResult> Result;
+		};
+		TArray<FDescribe> Describes;
+		Describes.SetNum(Modules.Num());
+
+		const double FetchStart = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Modules.Num() && !IsCanceled(Task); ++Index)
+		{
+			if (!ReuseRawSchema(Modules[Index], Task))
+			{
+				Describes[Index].Runner = LaunchCliDescribe(Modules[Index].DatabaseName, Task, Describes[Index].Result);
+			}
+		}
+		for (int32 Index = 0; Index < Modules.Num(); ++Index)
 		{
-			UE_LOG(LogTemp, Error,
-				TEXT("[spacetime] SpacetimeDB CLI stderr: %s"), *StdErr
-			);
+			if (FDescribe& Describe = Describes[Index]; Describe.Result.IsValid())
+			{
+				FinishFetch(Modules[Index], Describe.Result.Get(), Describe.Runner->GetParams(), Task);
+				Modules[Index].Seconds += FPlatformTime::Seconds() - FetchStart;
+			}
+		}
+	}
+	if (const FString Error = CheckStep(); !Error.IsEmpty())
+	{
+		return Finish(Error);
+	}
+
+	// 1. Parse into SATS models and types IR
+	if (const FString Error = RunStep(ESpacetimeCodegenPhase::Parsing, [](FModuleCodegen& Module) { return ParseModule(Module); }); !Error.IsEmpty())
+	{
+		return Finish(Error);
+	}
+
+	// 2. Types several databases define go to a header of their own, then every file is generated in memory
+	TArray<TPair<FString, FString>> Files;
+	{
+		TArray<TPair<FHeader*, FHeader*>> ModuleHeaders;
+		for (FModuleCodegen& Module : Modules)
+		{
+			if (!IsSkippedCompanion(Module))
+			{
+				ModuleHeaders.Emplace(&Module.ExportedTypesHeader, &Module.InlineTypesHeader);
+			}
 		}
+
+		FHeader SharedTypesHeader;
+		FString Error;
+		if (!FSpacetimeDBCodeGen::ExtractSharedTypes(ModuleHeaders, SharedTypesHeader, OutSummary.SharedTypes, Error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s"), *Error);
+			return Finish(Error);
+		}
+
+		if (!OutSummary.SharedTypes.IsEmpty())
+		{
+			FString SharedTypesCode;
+			FString SharedCodecCode;
+			if (!FSpacetimeDBCodeGen::RenderTypesHeader(SharedTypesHeader, /*bTopoSort=*/ true, SharedTypesCode, Error)
+				|| !FSpacetimeDBCodeGen::GenerateSharedCodecCode(SharedTypesHeader, SharedCodecCode, Error))
+			{
+				return Finish(TEXT("Shared type generation failed: ") + Error);
+			}
+			Files.Emplace(GetHeaderOutputDir() / FSpacetimeConfig::SharedTypesCodeFileName + ".h", MoveTemp(SharedTypesCode));
+			Files.Emplace(GetHeaderOutputDir() / FSpacetimeConfig::SharedCodecCodeFileName + ".h", MoveTemp(SharedCodecCode));
+
+			for (FModuleCodegen& Module : Modules)
+			{
+				Module.bUsesSharedTypes = true;
+			}
+		}
+	}
+	if (const FString Error = RunStep(ESpacetimeCodegenPhase::Generating, [](FModuleCodegen& Module) { return GenerateModuleFiles(Module); }); !Error.IsEmpty())
+	{
+		return Finish(Error);
+	}
+
+	// 3. Write everything at once, so the databases' files and the shared types never disagree
+	EnterPhase(Task, ESpacetimeCodegenPhase::Writing);
+	for (FModuleCodegen& Module : Modules)
+	{
+		Files.Append(MoveTemp(Module.Files));
+	}
+	OutSummary.NumFiles = Files.Num();
+	if (FString Error; !WriteFiles(Files, OutSummary.NumFilesWritten, Error))
+	{
+		return Finish(Error);
+	}
+
+	// Nothing includes the shared headers any more; left behind, they would still be compiled.
+	// A skipped companion's files were not regenerated though, and may still include them.
+	if (OutSummary.SharedTypes.IsEmpty() && !Modules.ContainsByPredicate(IsSkippedCompanion))
+	{
+		for (const FString& FileName : { FSpacetimeConfig::SharedTypesCodeFileName, FSpacetimeConfig::SharedCodecCodeFileName })
+		{
+			const FString Path = GetHeaderOutputDir() / FileName + ".h";
+			if (IFileManager::Get().FileExists(*Path))
+			{
+				if (!IFileManager::Get().Delete(*Path, /*RequireExists=*/ false, /*EvenReadOnly=*/ true))
+				{
+					return Finish(FString::Printf(TEXT("Could not delete %s, which no database uses any more."), *Path));
+				}
+				UE_LOG(LogTemp, Log, TEXT("[spacetime] Deleted %s, no types are shared any more"), *Path);
+			}
+		}
+	}
+
+	OutSummary.OutputPath = GetFullOutputDir();
+	return Finish(FString());
+}
+
+bool RawModuleDefFromCli(const FString &DatabaseName, FString &Output, FSpacetimeCodegenTask* Task)
+{
+	TFuture<FSpacetimeProcessResult> Result;
+	const TSharedRef<FSpacetimeProcessRunner> Runner = LaunchCliDescribe(DatabaseName, Task, Result);
+	return ReadCliDescribe(Result.Get(), Runner->GetParams(), Output);
+}
+
+TSharedRef<FSpacetimeProcessRunner> LaunchCliDescribe(const FString& DatabaseName, FSpacetimeCodegenTask* Task, TFuture<FSpacetimeProcessResult>& OutResult)
+{
+	// Build the CLI command and parameters
+	FSpacetimeProcessParams Params;
+	Params.Arguments = FString::Printf(TEXT("describe --json %s"), *DatabaseName);
+	Params.Timeout = 120.0;
+
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Running command: %s %s"), *Params.Executable, *Params.Arguments);
+
+	// The CLI cannot hang whoever waits for the result past the timeout, and a task can kill it
+	const TSharedRef<FSpacetimeProcessRunner> Runner = MakeShared<FSpacetimeProcessRunner>(Params);
+	if (Task)
+	{
+		Task->AttachProcess(Runner);
+	}
+	OutResult = Runner->Launch();
+	return Runner;
+}
+
+bool ReadCliDescribe(const FSpacetimeProcessResult& Result, const FSpacetimeProcessParams& Params, FString& Output)
+{
+	if (!Result.Succeeded())
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] SpacetimeDB CLI failed: %s"), *Result.DescribeFailure(Params));
 		return false;
 	}
 
 	// Warn if there was any stderr output despite success
-	if (!StdErr.IsEmpty())
+	if (!Result.StdErr.IsEmpty())
 	{
 		UE_LOG(LogTemp, Warning,
-			TEXT("[spacetime] SpacetimeDB CLI reported warnings: %s"), *StdErr
+			TEXT("[spacetime] SpacetimeDB CLI reported warnings: %s"), *Result.StdErr
 		);
 	}
 
 	// Log a bit of context for debugging
 	UE_LOG(LogTemp, Log,
-		TEXT("[spacetime] SpacetimeDB CLI returned %d bytes of JSON"), StdOut.Len()
+		TEXT("[spacetime] SpacetimeDB CLI returned %d bytes of JSON"), Result.StdOut.Len()
 	);
 
-	Output = StdOut;
+	Output = Result.StdOut;
 	// Return SUCCESS
 	return true;
 }
@@ -314,9 +636,10 @@ bool RawModuleDefFromCli(const FString &DatabaseName, FString &Output)
 bool RawModuleDefFromHttp(
 	const FString& ServerURL,
 	const FString& DatabaseName,
-	FString& OutRawModuleDef)
+	FString& OutRawModuleDef,
+	FSpacetimeCodegenTask* Task)
 {
-	return RawModuleDefFromCli(DatabaseName, OutRawModuleDef);
+	return RawModuleDefFromCli(DatabaseName, OutRawModuleDef, Task);
 	/*
 	SpacetimeDB::String DBName = TCHAR_TO_UTF8(*DatabaseName);
 	SpacetimeDB::Database::Client Client =
@@ -5,9 +5,13 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Misc/MessageDialog.h"
+#include "SpacetimeSchemaBrowser.h"
 #include "SpacetimeStatusTab.h"
+#include "CLI/SpacetimeCliStatusService.h"
+#include "SpacetimeSchemaWatcher.h"
 
 static const FName UtilsTabName("SpacetimeDBUtils");
+static const FName SchemaTabName("SpacetimeDBSchema");
 
 #define LOCTEXT_NAMESPACE "FSpacetimeDBEditorModule"
 
@@ -22,6 +26,10 @@ void FSpacetimeDBEditorModule::StartupModule()
     .SetDisplayNameAttribute(LOCTEXT("SpacetimeDBTabTitle", "SpacetimeDB"))
     .SetMenuType(ETabSpawnerMenuType::Hidden);
 
+    FGlobalTabmanager::Get()->RegisterNomadTabSpawner(SchemaTabName, FOnSpawnTab::CreateRaw(this, &FSpacetimeDBEditorModule::SpawnSchemaTab))
+    .SetDisplayNameAttribute(LOCTEXT("SpacetimeDBSchemaTabTitle", "SpacetimeDB Schema"))
+    .SetMenuType(ETabSpawnerMenuType::Hidden);
+
     // 2. Add menu entry under Window > Developer Tools
     UToolMenus::RegisterStartupCallback(
         FSimpleMulticastDelegate::FDelegate::CreateLambda([this]()
@@ -44,15 +52,32 @@ void FSpacetimeDBEditorModule::StartupModule()
                     FGlobalTabmanager::Get()->TryInvokeTab(UtilsTabName);
                 }))
             );
+
+            SpacetimeSection.AddMenuEntry(
+                "OpenSpacetimeDBSchema",
+                LOCTEXT("OpenSchema", "Spacetime Schema"),
+                LOCTEXT("OpenSchemaTooltip", "Browse the tables, reducers and types of the databases code was generated for."),
+                FSlateIcon(FAppStyle::GetAppStyleSetName(), TEXT("ClassIcon.UserDefinedStruct")),
+                FUIAction(FExecuteAction::CreateLambda([]
+                {
+                    FGlobalTabmanager::Get()->TryInvokeTab(SchemaTabName);
+                }))
+            );
         })
     );
+
+    // 3. Watch the databases for schema changes, if the project settings ask for it
+    FSpacetimeSchemaWatcher::Get().ApplySettings();
 }
 
 void FSpacetimeDBEditorModule::ShutdownModule()
 {
+    FSpacetimeSchemaWatcher::Shutdown();
+    FSpacetimeCliStatusService::Shutdown();
     UToolMenus::UnRegisterStartupCallback(this);
     UToolMenus::UnregisterOwner(this);
     FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(UtilsTabName);
+    FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SchemaTabName);
 }
 
 TSharedRef<SDockTab> FSpacetimeDBEditorModule::SpawnGeneralTab(const FSpawnTabArgs& Args)
@@ -65,6 +90,15 @@ TSharedRef<SDockTab> FSpacetimeDBEditorModule::SpawnGeneralTab(const FSpawnTabAr
     ];
 }
 
+TSharedRef<SDockTab> FSpacetimeDBEditorModule::SpawnSchemaTab(const FSpawnTabArgs& Args)
+{
+    return SNew(SDockTab)
+    .TabRole(ETabRole::NomadTab)
+    [
+        SNew(SSpacetimeSchemaBrowser)
+    ];
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(FSpacetimeDBEditorModule, SpacetimeDBEditor)
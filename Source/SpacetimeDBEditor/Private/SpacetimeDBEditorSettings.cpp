@@ -0,0 +1,32 @@
+#include "SpacetimeDBEditorSettings.h"
+
+TArray<FString> USpacetimeDBEditorSettings::GetSelectedDatabases() const
+{
+	TArray<FString> Names;
+	for (const FSpacetimeCodegenDatabase& Database : CodegenDatabases)
+	{
+		if (Database.bSelected && !Database.Name.IsEmpty())
+		{
+			Names.AddUnique(Database.Name);
+		}
+	}
+	return Names;
+}
+
+TArray<FString> USpacetimeDBEditorSettings::GetAllDatabases() const
+{
+	TArray<FString> Names;
+	for (const FSpacetimeCodegenDatabase& Database : CodegenDatabases)
+	{
+		if (!Database.Name.IsEmpty())
+		{
+			Names.AddUnique(Database.Name);
+		}
+	}
+	return Names;
+}
+
+void USpacetimeDBEditorSettings::Save()
+{
+	TryUpdateDefaultConfigFile();
+}
@@ -0,0 +1,217 @@
+#include "SpacetimeMetricsPanel.h"
+
+#include "SpacetimeDBEditorSettings.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SpacetimeDBMetricsPanel"
+
+namespace
+{
+	const FName ReducerColumn("Reducer");
+	const FName CallsColumn("Calls");
+	const FName P50Column("P50");
+	const FName P99Column("P99");
+	const FName TotalColumn("Total");
+
+	FText FormatNumber(const double Value, const int32 FractionalDigits)
+	{
+		return FText::AsNumber(Value, &FNumberFormattingOptions().SetMinimumFractionalDigits(FractionalDigits).SetMaximumFractionalDigits(FractionalDigits));
+	}
+
+	/** Cells read the row when painted, so a scrape updates them without rebuilding the row. */
+	class SSpacetimeReducerRow final : public SMultiColumnTableRow<SSpacetimeMetricsPanel::FRowPtr>
+	{
+	public:
+		SLATE_BEGIN_ARGS(SSpacetimeReducerRow) {}
+		SLATE_END_ARGS()
+
+		void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable, const SSpacetimeMetricsPanel::FRowPtr& InRow)
+		{
+			Row = InRow;
+			SMultiColumnTableRow::Construct(FSuperRowType::FArguments(), OwnerTable);
+		}
+
+		virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+		{
+			const TWeakPtr<SSpacetimeMetricsPanel::FRow> WeakRow = Row;
+			auto Text = [WeakRow, ColumnName]() -> FText
+			{
+				const TSharedPtr<SSpacetimeMetricsPanel::FRow> Pinned = WeakRow.Pin();
+				if (!Pinned.IsValid())
+				{
+					return FText::GetEmpty();
+				}
+				const FSpacetimeReducerMetrics& Metrics = Pinned->Metrics;
+				if (ColumnName == ReducerColumn) return FText::FromString(Metrics.Reducer);
+				if (ColumnName == CallsColumn)   return FormatNumber(Metrics.CallsPerSecond, 1);
+				if (ColumnName == P50Column)     return FormatNumber(Metrics.P50Ms, 2);
+				if (ColumnName == P99Column)     return FormatNumber(Metrics.P99Ms, 2);
+				if (ColumnName == TotalColumn)   return FText::AsNumber(Metrics.TotalCalls);
+				return FText::GetEmpty();
+			};
+
+			return SNew(STextBlock)
+				.Text_Lambda(MoveTemp(Text))
+				.Justification(ColumnName == ReducerColumn ? ETextJustify::Left : ETextJustify::Right);
+		}
+
+	private:
+		SSpacetimeMetricsPanel::FRowPtr Row;
+	};
+}
+
+void SSpacetimeMetricsPanel::Construct(const FArguments& InArgs)
+{
+	ServerURL = InArgs._ServerURL;
+	DatabaseName = InArgs._DatabaseName;
+
+	Scraper = MakeShared<FSpacetimeMetricsScraper>();
+	Scraper->OnUpdated.BindSP(this, &SSpacetimeMetricsPanel::HandleUpdated);
+
+	RegisterActiveTimer(RestartDelay / 4.0, FWidgetActiveTimerDelegate::CreateSP(this, &SSpacetimeMetricsPanel::HandleTargetTimer));
+	RegisterActiveTimer(FMath::Max(0.5f, GetDefault<USpacetimeDBEditorSettings>()->MetricsScrapeInterval),
+		FWidgetActiveTimerDelegate::CreateSP(this, &SSpacetimeMetricsPanel::HandleScrapeTimer));
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+
+		+ SVerticalBox::Slot().AutoHeight().Padding(0.f, 0.f, 0.f, 4.f)
+		[
+			SNew(STextBlock).Text(this, &SSpacetimeMetricsPanel::GetSummaryText)
+		]
+
+		+ SVerticalBox::Slot().FillHeight(1.f)
+		[
+			SAssignNew(List, SListView<FRowPtr>)
+			.ListItemsSource(&Rows)
+			.OnGenerateRow(this, &SSpacetimeMetricsPanel::MakeRow)
+			.SelectionMode(ESelectionMode::Single)
+			.HeaderRow
+			(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column(ReducerColumn).FillWidth(0.4f).DefaultLabel(LOCTEXT("ReducerColumn", "Reducer"))
+				+ SHeaderRow::Column(CallsColumn).FillWidth(0.15f).DefaultLabel(LOCTEXT("CallsColumn", "Calls/s"))
+				+ SHeaderRow::Column(P50Column).FillWidth(0.15f).DefaultLabel(LOCTEXT("P50Column", "p50 (ms)"))
+				+ SHeaderRow::Column(P99Column).FillWidth(0.15f).DefaultLabel(LOCTEXT("P99Column", "p99 (ms)"))
+				+ SHeaderRow::Column(TotalColumn).FillWidth(0.15f).DefaultLabel(LOCTEXT("TotalColumn", "Total calls"))
+			)
+		]
+	];
+}
+
+SSpacetimeMetricsPanel::~SSpacetimeMetricsPanel()
+{
+	if (Scraper.IsValid())
+	{
+		Scraper->Stop();
+	}
+}
+
+EActiveTimerReturnType SSpacetimeMetricsPanel::HandleTargetTimer(const double InCurrentTime, const float InDeltaTime)
+{
+	const FString CurrentServerURL = ServerURL.Get().TrimStartAndEnd();
+	const FString CurrentDatabaseName = DatabaseName.Get().TrimStartAndEnd();
+	if (CurrentServerURL != PendingServerURL || CurrentDatabaseName != PendingDatabaseName)
+	{
+		PendingServerURL = CurrentServerURL;
+		PendingDatabaseName = CurrentDatabaseName;
+		PendingSince = InCurrentTime;
+	}
+	if ((PendingServerURL == ScrapedServerURL && PendingDatabaseName == ScrapedDatabaseName) || InCurrentTime - PendingSince < RestartDelay)
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	ScrapedServerURL = PendingServerURL;
+	ScrapedDatabaseName = PendingDatabaseName;
+	Rows.Reset();
+	RowsByReducer.Reset();
+	bHasSnapshot = false;
+	List->RequestListRefresh();
+
+	if (ScrapedServerURL.IsEmpty() || ScrapedDatabaseName.IsEmpty())
+	{
+		Scraper->Stop();
+		return EActiveTimerReturnType::Continue;
+	}
+	Scraper->Start(ScrapedServerURL, ScrapedDatabaseName);
+	return EActiveTimerReturnType::Continue;
+}
+
+EActiveTimerReturnType SSpacetimeMetricsPanel::HandleScrapeTimer(const double InCurrentTime, const float InDeltaTime)
+{
+	Scraper->Scrape();
+	return EActiveTimerReturnType::Continue;
+}
+
+void SSpacetimeMetricsPanel::HandleUpdated(const FSpacetimeMetricsSnapshot& Snapshot)
+{
+	LastSnapshot = Snapshot;
+	bHasSnapshot = true;
+	if (!Snapshot.Error.IsEmpty())
+	{
+		return;
+	}
+
+	// Hottest first; reducers that dropped out of the metrics stay at the end
+	TArray<FRowPtr> Ordered;
+	Ordered.Reserve(FMath::Max(Rows.Num(), Snapshot.Reducers.Num()));
+	for (const FSpacetimeReducerMetrics& Metrics : Snapshot.Reducers)
+	{
+		FRowPtr& Row = RowsByReducer.FindOrAdd(Metrics.Reducer);
+		if (!Row.IsValid())
+		{
+			Row = MakeShared<FRow>();
+		}
+		Row->Metrics = Metrics;
+		Ordered.Add(Row);
+	}
+	for (const FRowPtr& Row : Rows)
+	{
+		if (!Ordered.Contains(Row))
+		{
+			Row->Metrics.CallsPerSecond = 0.0;
+			Ordered.Add(Row);
+		}
+	}
+
+	if (Ordered != Rows)
+	{
+		Rows = MoveTemp(Ordered);
+		List->RequestListRefresh();
+	}
+}
+
+TSharedRef<ITableRow> SSpacetimeMetricsPanel::MakeRow(FRowPtr Row, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SSpacetimeReducerRow, OwnerTable, Row);
+}
+
+FText SSpacetimeMetricsPanel::GetSummaryText() const
+{
+	if (ScrapedDatabaseName.IsEmpty())
+	{
+		return LOCTEXT("NoDatabase", "Enter a database name to see its reducers.");
+	}
+	if (!bHasSnapshot)
+	{
+		return LOCTEXT("Waiting", "Waiting for metrics...");
+	}
+	if (!LastSnapshot.Error.IsEmpty())
+	{
+		return FText::FromString(LastSnapshot.Error);
+	}
+	if (LastSnapshot.Interval <= 0.0)
+	{
+		return LOCTEXT("Measuring", "Measuring; percentiles so far cover everything since the server started");
+	}
+	return FText::Format(
+		LOCTEXT("Summary", "Subscription updates: {0}/s, {1} per update"),
+		FormatNumber(LastSnapshot.UpdatesPerSecond, 1),
+		FText::AsMemory(static_cast<uint64>(LastSnapshot.BytesPerUpdate)));
+}
+
+#undef LOCTEXT_NAMESPACE
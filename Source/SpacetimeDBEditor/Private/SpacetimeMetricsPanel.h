@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Metrics/SpacetimeMetricsScraper.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+/**
+ * The hottest reducers of a database, from its server's metrics: calls per second and execution
+ * time percentiles per reducer, and the size of subscription updates.
+ *
+ * Rows are kept per reducer and updated in place, and the list only rebuilds when reducers appear
+ * or change places, so a scrape does not recreate any widgets.
+ */
+class SSpacetimeMetricsPanel final : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SSpacetimeMetricsPanel) {}
+		SLATE_ATTRIBUTE(FString, ServerURL)
+		SLATE_ATTRIBUTE(FString, DatabaseName)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SSpacetimeMetricsPanel() override;
+
+	/** One reducer; the list items, kept across scrapes. */
+	struct FRow
+	{
+		FSpacetimeReducerMetrics Metrics;
+	};
+	using FRowPtr = TSharedPtr<FRow>;
+
+private:
+	/** Active timers; like painting, they stop while the panel is hidden, and so does scraping. */
+	EActiveTimerReturnType HandleTargetTimer(double InCurrentTime, float InDeltaTime);
+	EActiveTimerReturnType HandleScrapeTimer(double InCurrentTime, float InDeltaTime);
+
+	void HandleUpdated(const FSpacetimeMetricsSnapshot& Snapshot);
+	TSharedRef<ITableRow> MakeRow(FRowPtr Row, const TSharedRef<STableViewBase>& OwnerTable);
+	FText GetSummaryText() const;
+
+	/** Seconds the server URL or database name must stay unchanged before scraping restarts, as they are typed in. */
+	static constexpr double RestartDelay = 1.0;
+
+	TAttribute<FString> ServerURL;
+	TAttribute<FString> DatabaseName;
+
+	/** What the scraper runs for, and what it is about to run for once typing stopped. */
+	FString ScrapedServerURL;
+	FString ScrapedDatabaseName;
+	FString PendingServerURL;
+	FString PendingDatabaseName;
+	double PendingSince = 0.0;
+
+	TSharedPtr<FSpacetimeMetricsScraper> Scraper;
+	FSpacetimeMetricsSnapshot LastSnapshot;
+	bool bHasSnapshot = false;
+
+	TArray<FRowPtr> Rows;
+	TMap<FString, FRowPtr> RowsByReducer;
+	TSharedPtr<SListView<FRowPtr>> List;
+};
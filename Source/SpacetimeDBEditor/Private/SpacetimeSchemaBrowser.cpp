@@ -0,0 +1,267 @@
+#include "SpacetimeSchemaBrowser.h"
+
+#include "Async/Async.h"
+#include "CodeGen/SpacetimeCodegenCache.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/SExpanderArrow.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SpacetimeDBSchemaBrowser"
+
+namespace
+{
+	const FName NameColumn("Name");
+	const FName UnrealColumn("Unreal");
+	const FName DetailsColumn("Details");
+
+	class SSpacetimeSchemaRow final : public SMultiColumnTableRow<SSpacetimeSchemaBrowser::FItemPtr>
+	{
+	public:
+		SLATE_BEGIN_ARGS(SSpacetimeSchemaRow) {}
+			SLATE_ATTRIBUTE(FText, HighlightText)
+		SLATE_END_ARGS()
+
+		void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable, const SSpacetimeSchemaBrowser::FItemPtr& InItem)
+		{
+			Item = InItem;
+			HighlightText = InArgs._HighlightText;
+			SMultiColumnTableRow::Construct(FSuperRowType::FArguments(), OwnerTable);
+		}
+
+		virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+		{
+			if (ColumnName == NameColumn)
+			{
+				const bool bCategory = Item->Kind == FSpacetimeSchemaItem::EKind::Category;
+				return SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot().AutoWidth()
+					[
+						SNew(SExpanderArrow, SharedThis(this))
+					]
+					+ SHorizontalBox::Slot().FillWidth(1.f).VAlign(VAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text(FText::FromString(Item->Name))
+						.Font(FCoreStyle::GetDefaultFontStyle(bCategory ? "Bold" : "Regular", 9))
+						.HighlightText(HighlightText)
+					];
+			}
+			if (ColumnName == UnrealColumn)
+			{
+				return SNew(STextBlock)
+					.Text(FText::FromString(Item->UnrealName))
+					.HighlightText(HighlightText);
+			}
+			return SNew(STextBlock)
+				.Text(FText::FromString(Item->Details))
+				.ColorAndOpacity(FSlateColor::UseSubduedForeground());
+		}
+
+	private:
+		SSpacetimeSchemaBrowser::FItemPtr Item;
+		TAttribute<FText> HighlightText;
+	};
+}
+
+void SSpacetimeSchemaBrowser::Construct(const FArguments& InArgs)
+{
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+
+		+ SVerticalBox::Slot().AutoHeight().Padding(8.f, 8.f, 8.f, 4.f)
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center).Padding(0.f, 0.f, 4.f, 0.f)
+			[
+				SNew(STextBlock).Text(LOCTEXT("DatabaseLabel", "Database:"))
+			]
+
+			+ SHorizontalBox::Slot().AutoWidth().Padding(0.f, 0.f, 8.f, 0.f)
+			[
+				SAssignNew(DatabaseComboBox, SComboBox<TSharedPtr<FString>>)
+				.OptionsSource(&DatabaseOptions)
+				.OnGenerateWidget_Lambda([](const TSharedPtr<FString>& Item)
+				{
+					return SNew(STextBlock).Text(FText::FromString(*Item));
+				})
+				.OnSelectionChanged(this, &SSpacetimeSchemaBrowser::HandleDatabaseSelected)
+				[
+					SNew(STextBlock).Text_Lambda([this]
+					{
+						return DatabaseName.IsEmpty() ? LOCTEXT("NoDatabase", "(none)") : FText::FromString(DatabaseName);
+					})
+				]
+			]
+
+			+ SHorizontalBox::Slot().FillWidth(1.f)
+			[
+				SNew(SSearchBox)
+				.HintText(LOCTEXT("SearchHint", "Search tables, reducers, types and fields"))
+				.OnTextChanged(this, &SSpacetimeSchemaBrowser::HandleSearchTextChanged)
+			]
+		]
+
+		+ SVerticalBox::Slot().AutoHeight().Padding(8.f, 0.f, 8.f, 4.f)
+		[
+			SNew(STextBlock).Text(this, &SSpacetimeSchemaBrowser::GetSummaryText)
+		]
+
+		+ SVerticalBox::Slot().FillHeight(1.f).Padding(8.f, 0.f, 8.f, 8.f)
+		[
+			SAssignNew(Tree, STreeView<FItemPtr>)
+			.TreeItemsSource(&Roots)
+			.OnGenerateRow(this, &SSpacetimeSchemaBrowser::MakeRow)
+			.OnGetChildren(this, &SSpacetimeSchemaBrowser::GetChildren)
+			.SelectionMode(ESelectionMode::Single)
+			.HeaderRow
+			(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column(NameColumn).FillWidth(0.35f).DefaultLabel(LOCTEXT("NameColumn", "Name"))
+				+ SHeaderRow::Column(UnrealColumn).FillWidth(0.35f).DefaultLabel(LOCTEXT("UnrealColumn", "Generated Unreal name"))
+				+ SHeaderRow::Column(DetailsColumn).FillWidth(0.3f).DefaultLabel(LOCTEXT("DetailsColumn", "Details"))
+			)
+		]
+	];
+
+	FSpacetimeCodegenCache::OnModuleParsed.AddSP(this, &SSpacetimeSchemaBrowser::HandleModuleParsed);
+	RefreshDatabases();
+}
+
+void SSpacetimeSchemaBrowser::RefreshDatabases()
+{
+	DatabaseOptions.Reset();
+	TSharedPtr<FString> Selected;
+	for (const FString& Name : FSpacetimeCodegenCache::GetParsedDatabaseNames())
+	{
+		DatabaseOptions.Add(MakeShared<FString>(Name));
+		if (Name == DatabaseName)
+		{
+			Selected = DatabaseOptions.Last();
+		}
+	}
+	if (!Selected.IsValid() && !DatabaseOptions.IsEmpty())
+	{
+		Selected = DatabaseOptions[0];
+	}
+
+	DatabaseComboBox->RefreshOptions();
+	DatabaseComboBox->SetSelectedItem(Selected);
+}
+
+void SSpacetimeSchemaBrowser::HandleModuleParsed(const FString& ParsedDatabaseName)
+{
+	RefreshDatabases();
+
+	// Selecting another database shows it; the one shown already needs its new schema
+	if (ParsedDatabaseName == DatabaseName)
+	{
+		ShowDatabase(DatabaseName);
+	}
+}
+
+void SSpacetimeSchemaBrowser::HandleDatabaseSelected(const TSharedPtr<FString> Item, ESelectInfo::Type SelectInfo)
+{
+	if (Item.IsValid() && *Item != DatabaseName)
+	{
+		ShowDatabase(*Item);
+	}
+}
+
+void SSpacetimeSchemaBrowser::ShowDatabase(const FString& InDatabaseName)
+{
+	DatabaseName = InDatabaseName;
+	Module = FSpacetimeCodegenCache::FindParsedModule(DatabaseName);
+	++BuildGeneration;
+	if (!Module.IsValid())
+	{
+		bBuilding = false;
+		Model.Reset();
+		Roots.Reset();
+		Tree->RequestTreeRefresh();
+		return;
+	}
+
+	// Indexing a module with thousands of types is best kept off the game thread
+	bBuilding = true;
+	Async(EAsyncExecution::ThreadPool,
+		[WeakThis = TWeakPtr<SSpacetimeSchemaBrowser>(SharedThis(this)), Parsed = Module.ToSharedRef(), Generation = BuildGeneration]
+	{
+		TSharedRef<FSpacetimeSchemaModel> Built = FSpacetimeSchemaModel::Build(*Parsed);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Built, Generation]
+		{
+			if (const TSharedPtr<SSpacetimeSchemaBrowser> This = WeakThis.Pin(); This && Generation == This->BuildGeneration)
+			{
+				This->bBuilding = false;
+				This->Model = Built;
+				This->ApplyFilter();
+			}
+		});
+	});
+}
+
+void SSpacetimeSchemaBrowser::HandleSearchTextChanged(const FText& Text)
+{
+	SearchText = Text.ToString();
+	ApplyFilter();
+}
+
+void SSpacetimeSchemaBrowser::ApplyFilter()
+{
+	if (!Model.IsValid())
+	{
+		return;
+	}
+
+	TArray<FItemPtr> Expand;
+	NumMatches = Model->ApplyFilter(SearchText, Roots, Expand);
+	for (const FItemPtr& Root : Roots)
+	{
+		Tree->SetItemExpansion(Root, true);
+	}
+	for (const FItemPtr& Item : Expand)
+	{
+		Tree->SetItemExpansion(Item, true);
+	}
+	Tree->RequestTreeRefresh();
+}
+
+TSharedRef<ITableRow> SSpacetimeSchemaBrowser::MakeRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SSpacetimeSchemaRow, OwnerTable, Item)
+		.HighlightText_Lambda([this] { return FText::FromString(SearchText.TrimStartAndEnd()); });
+}
+
+void SSpacetimeSchemaBrowser::GetChildren(FItemPtr Item, TArray<FItemPtr>& OutChildren)
+{
+	OutChildren = Item->VisibleChildren;
+}
+
+FText SSpacetimeSchemaBrowser::GetSummaryText() const
+{
+	if (DatabaseOptions.IsEmpty())
+	{
+		return LOCTEXT("NoSchemas", "Generate code for a database to browse its schema here.");
+	}
+	if (bBuilding || !Model.IsValid())
+	{
+		return FText::Format(LOCTEXT("Indexing", "Indexing '{0}'..."), FText::FromString(DatabaseName));
+	}
+	if (!SearchText.TrimStartAndEnd().IsEmpty())
+	{
+		return FText::Format(LOCTEXT("Matches", "{0} {0}|plural(one=match,other=matches)"), NumMatches);
+	}
+	return FText::Format(
+		LOCTEXT("Summary", "{0} tables, {1} reducers, {2} types; parsed at {3}"),
+		Model->NumTables,
+		Model->NumReducers,
+		Model->NumTypes,
+		FText::AsTime(Module->ParseTime));
+}
+
+#undef LOCTEXT_NAMESPACE
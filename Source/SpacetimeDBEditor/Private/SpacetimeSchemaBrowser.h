@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SchemaBrowser/SpacetimeSchemaModel.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Input/SComboBox.h"
+#include "Widgets/Views/STreeView.h"
+
+struct FSpacetimeParsedModule;
+
+/**
+ * Every table, reducer and exported type of a database, with their fields and the Unreal names
+ * the generated code gives them.
+ *
+ * The schema comes from FSpacetimeCodegenCache, as the latest code generation parsed it, so
+ * browsing never describes a database again; a database shows up once code was generated for it,
+ * and is shown anew whenever that happens again. The tree is virtualized and the search box
+ * filters through the model's trigram index, so neither slows down with the size of the module.
+ */
+class SSpacetimeSchemaBrowser final : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SSpacetimeSchemaBrowser) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	using FItemPtr = FSpacetimeSchemaModel::FItemPtr;
+
+private:
+	/** Lists the databases with a parsed schema, showing the first unless one is shown already. */
+	void RefreshDatabases();
+	void HandleModuleParsed(const FString& ParsedDatabaseName);
+	void HandleDatabaseSelected(TSharedPtr<FString> Item, ESelectInfo::Type SelectInfo);
+
+	/** Builds the database's model on the thread pool, which indexes it, then shows it. */
+	void ShowDatabase(const FString& InDatabaseName);
+
+	void HandleSearchTextChanged(const FText& Text);
+	void ApplyFilter();
+
+	TSharedRef<ITableRow> MakeRow(FItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void GetChildren(FItemPtr Item, TArray<FItemPtr>& OutChildren);
+	FText GetSummaryText() const;
+
+	TArray<TSharedPtr<FString>> DatabaseOptions;
+	TSharedPtr<SComboBox<TSharedPtr<FString>>> DatabaseComboBox;
+
+	FString DatabaseName;
+	TSharedPtr<const FSpacetimeParsedModule> Module;
+	TSharedPtr<FSpacetimeSchemaModel> Model;
+
+	/** Models built for an earlier ShowDatabase are dropped. */
+	uint32 BuildGeneration = 0;
+	bool bBuilding = false;
+
+	FString SearchText;
+	int32 NumMatches = 0;
+
+	TArray<FItemPtr> Roots;
+	TSharedPtr<STreeView<FItemPtr>> Tree;
+};
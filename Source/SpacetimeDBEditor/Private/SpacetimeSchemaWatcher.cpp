@@ -0,0 +1,282 @@
+#include "SpacetimeSchemaWatcher.h"
+
+#include "Framework/Notifications/NotificationManager.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/Crc.h"
+#include "Modules/ModuleManager.h"
+#include "SpacetimeCodegenTask.h"
+#include "SpacetimeDBEditorSettings.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
+
+#define LOCTEXT_NAMESPACE "SpacetimeDBSchemaWatcher"
+
+namespace
+{
+	TSharedPtr<FSpacetimeSchemaWatcher> GSchemaWatcher;
+}
+
+FSpacetimeSchemaWatcher& FSpacetimeSchemaWatcher::Get()
+{
+	check(IsInGameThread());
+	if (!GSchemaWatcher.IsValid())
+	{
+		GSchemaWatcher = MakeShared<FSpacetimeSchemaWatcher>();
+	}
+	return *GSchemaWatcher;
+}
+
+void FSpacetimeSchemaWatcher::Shutdown()
+{
+	if (GSchemaWatcher.IsValid())
+	{
+		GSchemaWatcher->StopPolling();
+		if (UObjectInitialized())
+		{
+			GetMutableDefault<USpacetimeDBEditorSettings>()->OnSettingChanged().Remove(GSchemaWatcher->SettingsChangedHandle);
+		}
+		GSchemaWatcher.Reset();
+	}
+}
+
+FSpacetimeSchemaWatcher::~FSpacetimeSchemaWatcher()
+{
+	StopPolling();
+}
+
+void FSpacetimeSchemaWatcher::ApplySettings()
+{
+	USpacetimeDBEditorSettings* Settings = GetMutableDefault<USpacetimeDBEditorSettings>();
+	if (!SettingsChangedHandle.IsValid())
+	{
+		SettingsChangedHandle = Settings->OnSettingChanged().AddSP(this, &FSpacetimeSchemaWatcher::HandleSettingsChanged);
+	}
+
+	const float Interval = FMath::Max(1.f, Settings->SchemaPollInterval);
+	if (!Settings->bWatchSchemas)
+	{
+		StopPolling();
+		return;
+	}
+	if (TickerHandle.IsValid() && FMath::IsNearlyEqual(Interval, PollInterval))
+	{
+		return;
+	}
+
+	StopPolling();
+	PollInterval = Interval;
+	Backoff = FSpacetimeBackoff(PollInterval, MaxPollBackoff);
+	NextPollTime = 0.0;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FSpacetimeSchemaWatcher::Tick), PollInterval);
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Watching the selected databases for schema changes every %.0f seconds"), PollInterval);
+}
+
+void FSpacetimeSchemaWatcher::StopPolling()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Answers still on their way are dropped
+	++PollGeneration;
+	PendingResponses = 0;
+}
+
+void FSpacetimeSchemaWatcher::HandleSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	ApplySettings();
+}
+
+bool FSpacetimeSchemaWatcher::Tick(float DeltaTime)
+{
+	// A regeneration, ours or the status tab's, fetches the schemas anyway
+	if (PendingResponses == 0 && FPlatformTime::Seconds() >= NextPollTime && !FSpacetimeCodegenTask::IsAnyRunning())
+	{
+		Poll();
+	}
+	return true;
+}
+
+void FSpacetimeSchemaWatcher::Poll()
+{
+	const USpacetimeDBEditorSettings* Settings = GetDefault<USpacetimeDBEditorSettings>();
+	const TArray<FString> DatabaseNames = Settings->GetSelectedDatabases();
+	if (DatabaseNames.IsEmpty())
+	{
+		return;
+	}
+
+	++PollGeneration;
+	PollServerURL = Settings->WatchServerURL;
+	PolledFingerprints.Reset();
+	PendingResponses = DatabaseNames.Num();
+
+	FString BaseURL = PollServerURL;
+	BaseURL.RemoveFromEnd(TEXT("/"));
+	for (const FString& DatabaseName : DatabaseNames)
+	{
+		const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(BaseURL + TEXT("/v1/database/") + FGenericPlatformHttp::UrlEncode(DatabaseName));
+		Request->SetVerb(TEXT("GET"));
+		Request->SetTimeout(PollTimeout);
+		Request->OnProcessRequestComplete().BindSP(this, &FSpacetimeSchemaWatcher::HandleMetadata, DatabaseName, PollGeneration);
+		Request->ProcessRequest();
+	}
+}
+
+void FSpacetimeSchemaWatcher::HandleMetadata(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bConnectedSuccessfully, FString DatabaseName, const uint32 Generation)
+{
+	if (Generation != PollGeneration)
+	{
+		return;
+	}
+
+	if (bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		PolledFingerprints.Add(DatabaseName, FCrc::StrCrc32(*Response->GetContentAsString()));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[spacetime] No metadata for '%s' from %s"), *DatabaseName, *PollServerURL);
+	}
+
+	if (--PendingResponses == 0)
+	{
+		FinishPoll();
+	}
+}
+
+void FSpacetimeSchemaWatcher::FinishPoll()
+{
+	if (PolledFingerprints.IsEmpty())
+	{
+		Backoff.RecordFailure();
+		NextPollTime = FPlatformTime::Seconds() + Backoff.GetDelay();
+		UE_LOG(LogTemp, Verbose, TEXT("[spacetime] %s did not answer; polling again in %.0f seconds"), *PollServerURL, Backoff.GetDelay());
+		return;
+	}
+	Backoff.RecordSuccess();
+	NextPollTime = 0.0;
+
+	// Fingerprints from another server say nothing about this one
+	if (FingerprintServerURL != PollServerURL)
+	{
+		Fingerprints.Reset();
+		FingerprintServerURL = PollServerURL;
+	}
+
+	TSet<FString> ChangedDatabases;
+	for (const auto& [DatabaseName, Fingerprint] : PolledFingerprints)
+	{
+		if (const uint32* Known = Fingerprints.Find(DatabaseName); Known && *Known != Fingerprint)
+		{
+			ChangedDatabases.Add(DatabaseName);
+		}
+		else
+		{
+			Fingerprints.Add(DatabaseName, Fingerprint);
+		}
+	}
+	if (ChangedDatabases.IsEmpty())
+	{
+		return;
+	}
+
+	// A change is only taken once its regeneration starts; until then every poll finds it again
+	if (FSpacetimeCodegenTask::IsAnyRunning())
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Code generation is running; regenerating '%s' after it"), *FString::Join(ChangedDatabases.Array(), TEXT("', '")));
+		return;
+	}
+	for (const FString& DatabaseName : ChangedDatabases)
+	{
+		Fingerprints.Add(DatabaseName, PolledFingerprints[DatabaseName]);
+	}
+	Regenerate(ChangedDatabases);
+}
+
+void FSpacetimeSchemaWatcher::Regenerate(const TSet<FString>& ChangedDatabases)
+{
+	const USpacetimeDBEditorSettings* Settings = GetDefault<USpacetimeDBEditorSettings>();
+	const TArray<FString> DatabaseNames = Settings->GetSelectedDatabases();
+
+	// Types shared between databases need all of them, but only the changed ones are described again
+	TSet<FString> UnchangedDatabases(DatabaseNames);
+	UnchangedDatabases = UnchangedDatabases.Difference(ChangedDatabases);
+
+	Task = MakeShared<FSpacetimeCodegenTask>(PollServerURL, DatabaseNames);
+	Task->SetReusableSchemas(MoveTemp(UnchangedDatabases));
+
+	const FText ChangedText = FText::FromString(FString::Join(ChangedDatabases.Array(), TEXT("', '")));
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Module of '%s' changed, regenerating code"), *ChangedText.ToString());
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("Regenerating", "Module '{0}' changed\nRegenerating code"), ChangedText));
+	Info.bFireAndForget = false;
+	Info.ExpireDuration = 5.f;
+	const TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Notification.IsValid())
+	{
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	const bool bLiveCoding = Settings->bLiveCodingAfterRegeneration;
+	Task->OnCompleted.BindLambda([WeakThis = TWeakPtr<FSpacetimeSchemaWatcher>(AsShared()), Notification, ChangedText, bLiveCoding]
+		(const FSpacetimeCodegenSummary& Summary)
+	{
+		if (const TSharedPtr<FSpacetimeSchemaWatcher> This = WeakThis.Pin())
+		{
+			This->Task.Reset();
+		}
+
+		FText Text;
+		if (!Summary.Succeeded())
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Regenerating code after '%s' changed failed: %s"), *ChangedText.ToString(), *Summary.Error);
+			Text = FText::Format(LOCTEXT("RegenerateFailed", "🛑 Regenerating code for '{0}' failed\n{1}"), ChangedText, Summary.ToText());
+		}
+		else if (Summary.NumFilesWritten == 0)
+		{
+			Text = FText::Format(LOCTEXT("RegenerateUnchanged", "Module '{0}' changed, the generated code did not"), ChangedText);
+		}
+		else if (bLiveCoding && CompileWithLiveCoding())
+		{
+			Text = FText::Format(LOCTEXT("RegenerateLiveCoding", "✅ Regenerated {0} files for '{1}'\nCompiling with Live Coding"), Summary.NumFilesWritten, ChangedText);
+		}
+		else
+		{
+			Text = FText::Format(LOCTEXT("RegenerateRebuild", "✅ Regenerated {0} files for '{1}'\nRebuild to use them"), Summary.NumFilesWritten, ChangedText);
+		}
+
+		if (Notification.IsValid())
+		{
+			Notification->SetText(Text);
+			Notification->SetCompletionState(Summary.Succeeded() ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+			Notification->ExpireAndFadeout();
+		}
+	});
+	Task->Start();
+}
+
+bool FSpacetimeSchemaWatcher::CompileWithLiveCoding()
+{
+#if WITH_LIVE_CODING
+	// Patches changed files only; new files, such as a new database's, still take a rebuild
+	ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME);
+	if (LiveCoding && LiveCoding->IsEnabledForSession())
+	{
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Compiling the regenerated code with Live Coding"));
+		LiveCoding->Compile();
+		return true;
+	}
+#endif
+	return false;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -1,15 +1,32 @@
 #include "SpacetimeStatusTab.h"
 
+#include "Algo/AnyOf.h"
 #include "SpacetimeDBEditorHelpers.h"
 #include "Widgets/Text/STextBlock.h"
 
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Input/SButton.h"
-#include "Async/Async.h"
-#include "CLI/SpacetimeCLIHelper.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/MessageDialog.h"
+#include "SpacetimeCodegenTask.h"
+#include "SpacetimeDBEditorSettings.h"
+#include "SpacetimeMetricsPanel.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "Widgets/Views/STableRow.h"
 
 #define LOCTEXT_NAMESPACE "SpacetimeDBStatusTab"
 
+static FSpacetimeCodegenDatabase* FindCodegenDatabase(const FString& DatabaseName)
+{
+	return GetMutableDefault<USpacetimeDBEditorSettings>()->CodegenDatabases.FindByPredicate([&DatabaseName](const FSpacetimeCodegenDatabase& Database)
+	{
+		return Database.Name == DatabaseName;
+	});
+}
+
 void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
 {
 	RefreshInterval = InArgs._RefreshInterval;
@@ -59,13 +76,25 @@ void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
             SAssignNew(ServerComboBox, SComboBox<TSharedPtr<FSpacetimeServerConfig>>)
             .OptionsSource(&ServerOptions)
         	// .OnComboBoxOpening_Lambda([this] { /* ServerComboBox->RefreshOptions(); */ })
-            .OnGenerateWidget_Lambda([](FStdbServerComboBoxItem InItem)
+            .OnGenerateWidget_Lambda([this](FStdbServerComboBoxItem InItem)
             {
-                return SNew(STextBlock).Text(InItem.IsValid() ? FText::FromString(InItem->Nickname) : FText::GetEmpty());
+                if (!InItem.IsValid())
+                {
+                    return SNew(STextBlock);
+                }
+                // Bound rather than set, so each row follows its probe as results come in
+                return SNew(STextBlock)
+                    .Text_Lambda([this, InItem]() { return GetServerLabel(*InItem); })
+                    .ColorAndOpacity_Lambda([this, InItem]() { return GetServerColor(*InItem); });
             })
-            .OnSelectionChanged_Lambda([this](TSharedPtr<FSpacetimeServerConfig> NewValue, ESelectInfo::Type)
+            .OnSelectionChanged_Lambda([this](TSharedPtr<FSpacetimeServerConfig> NewValue, ESelectInfo::Type SelectInfo)
             {
-                if (NewValue.IsValid() && ServerURLTextBox.IsValid()) { ServerURLTextBox->SetText(FText::FromString(NewValue->GetURL())); }
+                // Selections made in code fill the URL box themselves, if the user did not type in it
+                if (SelectInfo != ESelectInfo::Direct && NewValue.IsValid())
+                {
+                    bUserPickedServer = true;
+                    SetServerURL(NewValue->GetURL());
+                }
             })
             [
                 // what’s shown when collapsed
@@ -74,8 +103,7 @@ void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
                 {
                     if (ServerComboBox.IsValid() && ServerComboBox->GetSelectedItem().IsValid())
                     {
-                    	const auto SelectedServer = ServerComboBox->GetSelectedItem();
-                        return FText::FromString(SelectedServer->Nickname);
+                        return GetServerLabel(*ServerComboBox->GetSelectedItem());
                     }
                     return LOCTEXT("NoServer", "No servers");
                 })
@@ -101,7 +129,33 @@ void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
         + SVerticalBox::Slot().AutoHeight().Padding(StandardPadding, StandardPadding)
         [ SNew(STextBlock).Text(LOCTEXT("DBNameLabel", "Database Name:")) ]
         + SVerticalBox::Slot().AutoHeight().Padding(StandardPadding, StandardPadding)
-        [ SAssignNew(DatabaseNameTextBox, SEditableTextBox).HintText(LOCTEXT("DBNameHint", "e.g. quickstart-chat")) ]
+        [
+            SNew(SHorizontalBox)
+            + SHorizontalBox::Slot().FillWidth(1.f)
+            [ SAssignNew(DatabaseNameTextBox, SEditableTextBox).HintText(LOCTEXT("DBNameHint", "e.g. quickstart-chat")) ]
+            + SHorizontalBox::Slot().AutoWidth().Padding(TightPadding, 0.f)
+            [
+                SNew(SButton)
+                .Text(LOCTEXT("AddDatabaseButton", "Add to List"))
+                .ToolTipText(LOCTEXT("AddDatabaseTooltip", "Keep the database in the project settings, to generate it with the others"))
+                .OnClicked_Lambda([this]() -> FReply
+                {
+                    AddDatabase(DatabaseNameTextBox->GetText().ToString().TrimStartAndEnd());
+                    return FReply::Handled();
+                })
+            ]
+        ]
+
+		// Databases generated together:
+        + SVerticalBox::Slot().AutoHeight().Padding(StandardPadding, StandardPadding)
+        [ SNew(STextBlock).Text(LOCTEXT("DBListLabel", "Databases:")) ]
+        + SVerticalBox::Slot().AutoHeight().MaxHeight(200.f).Padding(StandardPadding, TightPadding)
+        [
+            SAssignNew(DatabaseList, SListView<TSharedPtr<FString>>)
+            .ListItemsSource(&DatabaseItems)
+            .OnGenerateRow(this, &SSpacetimeStatusTab::MakeDatabaseRow)
+            .SelectionMode(ESelectionMode::None)
+        ]
 
 		// Buttons:
         + SVerticalBox::Slot().AutoHeight().Padding(StandardPadding, StandardPadding)
@@ -113,6 +167,7 @@ void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
 	        [
 	            SNew(SButton)
 	            .Text(LOCTEXT("GenerateButton", "Generate Code Reflection"))
+	            .IsEnabled_Lambda([]() { return !FSpacetimeCodegenTask::IsAnyRunning(); })
         		.OnClicked_Lambda([this]() -> FReply
         		{
         			// 1) Ensure the fields are valid
@@ -140,129 +195,482 @@ void SSpacetimeStatusTab::Construct(const FArguments& InArgs)
 					const FString ServerURL = ServerURLTextBox->GetText().ToString();
 					const FString DBName    = DatabaseNameTextBox->GetText().ToString();
 
-					// 3) Call into your code-gen helper
-					FString OutDir, ErrorMsg;
-					const bool bOK = USpacetimeDBEditorHelpers::GenerateCxxUnrealCodeFromSpacetimeDB(
-						ServerURL, DBName, OutDir, ErrorMsg
-					);
-
-					// 4) Show a dialog based on success or failure
-					if (!bOK)
+					// 3) Listed, so later runs know its files when they look for types the databases share
+					if (!FindCodegenDatabase(DBName))
 					{
-						FMessageDialog::Open(
-							EAppMsgCategory::Error,
-							EAppMsgType::Ok,
-							FText::Format(
-								LOCTEXT("GenerateFailedFmt", "🛑 Generate failed:\n{0}"),
-								FText::FromString(ErrorMsg)
-							)
-						);
-					}
-					else
-					{
-						FMessageDialog::Open(
-							EAppMsgCategory::Success,
-							EAppMsgType::Ok,
-							FText::Format(
-								LOCTEXT("GenerateSuccessFmt", "✅ Generate succeeded!\nFiles written to:\n{0}"),
-								FText::FromString(OutDir)
-							)
-						);
+						AddDatabase(DBName);
 					}
 
+					// 4) Generate in the background; the notification reports progress and the result
+					StartCodegen(ServerURL, {DBName});
+
 					return FReply::Handled();
 				})
 	        ]
 
+	        // Generate every selected database at once
+	        + SHorizontalBox::Slot().AutoWidth().Padding(StandardPadding)
+	        [
+	            SNew(SButton)
+	            .Text(LOCTEXT("GenerateSelectedButton", "Generate Selected"))
+	            .ToolTipText(LOCTEXT("GenerateSelectedTooltip", "Generate code for every checked database together; types they share are generated once"))
+	            .IsEnabled_Lambda([]()
+	            {
+	                return !FSpacetimeCodegenTask::IsAnyRunning() && !GetDefault<USpacetimeDBEditorSettings>()->GetSelectedDatabases().IsEmpty();
+	            })
+	            .OnClicked_Lambda([this]() -> FReply
+	            {
+	                if (!ServerURLTextBox.IsValid())
+	                {
+	                    FMessageDialog::Open(
+	                        EAppMsgCategory::Error,
+	                        EAppMsgType::Ok,
+	                        LOCTEXT("STDBGenerateMissedServerURL",
+	                            "🛑 Missing field: server URL"));
+	                    return FReply::Handled();
+	                }
+
+	                StartCodegen(ServerURLTextBox->GetText().ToString(), GetDefault<USpacetimeDBEditorSettings>()->GetSelectedDatabases());
+	                return FReply::Handled();
+	            })
+	        ]
+
         	+ SHorizontalBox::Slot().AutoWidth().Padding(StandardPadding)
 			[
 				SNew(SButton)
 				.Text(LOCTEXT("RefreshButton", "Refresh"))
-				.OnClicked_Lambda([this]() -> FReply
+				.OnClicked_Lambda([]() -> FReply
 				{
-					ScheduleAsyncRefresh();
+					FSpacetimeCliStatusService::Get().Refresh(/*bForce=*/ true);
 					return FReply::Handled();
 				})
 			]
+        ]
+
+		// Reducer metrics of the database named above:
+        + SVerticalBox::Slot().AutoHeight().Padding(StandardPadding, LoosePadding, StandardPadding, StandardPadding)
+        [ SNew(STextBlock).Text(LOCTEXT("MetricsLabel", "Reducer Metrics:")) ]
+        + SVerticalBox::Slot().FillHeight(1.f).Padding(StandardPadding, TightPadding)
+        [
+            SNew(SSpacetimeMetricsPanel)
+            .ServerURL_Lambda([this]() { return ServerURLTextBox.IsValid() ? ServerURLTextBox->GetText().ToString() : FString(); })
+            .DatabaseName_Lambda([this]() { return DatabaseNameTextBox.IsValid() ? DatabaseNameTextBox->GetText().ToString() : FString(); })
         ]
     ];
 
-    // Kick off the first check
-    ScheduleAsyncRefresh();
+    RefreshDatabaseList();
+    GetMutableDefault<USpacetimeDBEditorSettings>()->OnSettingChanged().AddSP(this, &SSpacetimeStatusTab::HandleSettingsChanged);
+
+    // Show what is known already, then refresh it if it went stale
+    FSpacetimeCliStatusService& StatusService = FSpacetimeCliStatusService::Get();
+    StatusService.OnStatusChanged.AddSP(this, &SSpacetimeStatusTab::HandleStatusChanged);
+    if (StatusService.HasStatus())
+    {
+        HandleStatusChanged(StatusService.GetStatus());
+    }
+    StatusService.Refresh();
+
+    RegisterActiveTimer(RefreshInterval, FWidgetActiveTimerDelegate::CreateSP(this, &SSpacetimeStatusTab::HandleRefreshTimer));
 }
 
-void SSpacetimeStatusTab::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+EActiveTimerReturnType SSpacetimeStatusTab::HandleRefreshTimer(const double InCurrentTime, const float InDeltaTime)
 {
-	AccumulatedTime += InDeltaTime;
-	if (AccumulatedTime >= RefreshInterval)
+	// Only probes once the shared status outlived its time to live, which grows while the CLI is missing
+	FSpacetimeCliStatusService::Get().Refresh();
+
+	if (FPlatformTime::Seconds() >= NextProbeTime)
 	{
-		AccumulatedTime = 0.f;
-		// ScheduleAsyncRefresh();
+		ProbeServers();
 	}
+	return EActiveTimerReturnType::Continue;
 }
 
-void SSpacetimeStatusTab::ScheduleAsyncRefresh() {
-	// Capture weak refs so we don’t keep widgets alive if the tab closes
-	TWeakPtr<STextBlock> CliWeak    = CliTextBlock;
-	TWeakPtr<STextBlock> StatusWeak = StatusTextBlock;
-
-	// Dispatch the blocking work to the thread-pool
-	Async(EAsyncExecution::ThreadPool, [this, CliWeak, StatusWeak]()
-	{		
-		// *** Blocking calls go here ***
-		const bool bCliAvailable = FSpacetimeCLIHelper::IsCliAvailable();
-		const bool bLoggedIn     = FSpacetimeCLIHelper::IsLoggedIn();
-		
-		// Then marshal back to the game (main) thread
-		// TODO: make all args weak
-		AsyncTask(ENamedThreads::GameThread, [this, CliWeak, StatusWeak, bCliAvailable, bLoggedIn]()
+void SSpacetimeStatusTab::StartCodegen(const FString& ServerURL, const TArray<FString>& DatabaseNames)
+{
+	const TSharedRef<FSpacetimeCodegenTask> Task = MakeShared<FSpacetimeCodegenTask>(ServerURL, DatabaseNames);
+	const FText DatabaseText = FText::FromString(FString::Join(DatabaseNames, TEXT("', '")));
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("CodegenStarted", "Generating code for '{0}'"), DatabaseText));
+	Info.bFireAndForget = false;
+	Info.ExpireDuration = 5.f;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("CodegenCancel", "Cancel"),
+		LOCTEXT("CodegenCancelTooltip", "Stop generating; no files are written"),
+		FSimpleDelegate::CreateLambda([WeakTask = TWeakPtr<FSpacetimeCodegenTask>(Task)]()
+		{
+			if (const TSharedPtr<FSpacetimeCodegenTask> CanceledTask = WeakTask.Pin())
+			{
+				CanceledTask->Cancel();
+			}
+		}),
+		SNotificationItem::CS_Pending));
+	const TSharedPtr<SNotificationItem> Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Notification.IsValid())
+	{
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	Task->OnPhase.BindLambda([Notification, DatabaseText](const ESpacetimeCodegenPhase Phase)
+	{
+		if (Notification.IsValid())
+		{
+			Notification->SetText(FText::Format(
+				LOCTEXT("CodegenPhase", "Generating code for '{0}'\n{1} ({2}/{3})"),
+				DatabaseText,
+				GetSpacetimeCodegenPhaseText(Phase),
+				static_cast<int32>(Phase) + 1,
+				static_cast<int32>(ESpacetimeCodegenPhase::Num)));
+		}
+	});
+
+	// Finishes the notification even if the tab was closed in the meantime
+	Task->OnCompleted.BindLambda(
+		[WeakThis = TWeakPtr<SSpacetimeStatusTab>(StaticCastSharedRef<SSpacetimeStatusTab>(AsShared())),
+		 WeakTask = TWeakPtr<FSpacetimeCodegenTask>(Task), Notification, DatabaseText]
+		(const FSpacetimeCodegenSummary& Summary)
+	{
+		const TSharedPtr<FSpacetimeCodegenTask> FinishedTask = WeakTask.Pin();
+		const bool bSucceeded = Summary.Succeeded();
+		const bool bCanceled = FinishedTask.IsValid() && FinishedTask->IsCanceled() && !bSucceeded;
+		if (Notification.IsValid())
 		{
-			if (const auto CliBlock = CliWeak.Pin())
+			if (bSucceeded)
 			{
-				CliBlock->SetText(FText::FromString(bCliAvailable ? TEXT("available")   : TEXT("unavailable")));
-				CliBlock->SetColorAndOpacity(bCliAvailable
-					? FSlateColor(FLinearColor::Green)
-					: FSlateColor(FLinearColor::Red)
-				);
+				Notification->SetText(FText::Format(LOCTEXT("CodegenSucceeded", "✅ Generated code for '{0}'\n{1}"), DatabaseText, Summary.ToText()));
+				Notification->SetCompletionState(SNotificationItem::CS_Success);
 			}
-			if (const auto StatusBlock = StatusWeak.Pin())
+			else if (bCanceled)
 			{
-				StatusBlock->SetText(FText::FromString(bLoggedIn ? TEXT("logged in") : TEXT("offline")));
-				StatusBlock->SetColorAndOpacity(bLoggedIn
-					? FSlateColor(FLinearColor::Green)
-					: FSlateColor(FLinearColor::Red)
-				);
+				Notification->SetText(FText::Format(LOCTEXT("CodegenCanceled", "Canceled code generation for '{0}'"), DatabaseText));
+				Notification->SetCompletionState(SNotificationItem::CS_None);
 			}
-
-			ServerOptions.Empty();
-			ServerURLTextBox->SetText(FText::FromString(TEXT("(no servers)")));
-			
-			// --- 1) load CLI config and build combo‐list ---
-			if (bCliAvailable && bLoggedIn)
+			else
 			{
-				if (FString ConfigError; FSpacetimeCLIHelper::GetCliConfig(Config, ConfigError))
-				{
-					for (const auto& ServerConfig : Config.ServerConfigs)
-					{
-						ServerOptions.Add(MakeShared<FSpacetimeServerConfig>(ServerConfig));
-					}
+				Notification->SetText(FText::Format(LOCTEXT("CodegenFailed", "🛑 Code generation for '{0}' failed"), DatabaseText));
+				Notification->SetCompletionState(SNotificationItem::CS_Fail);
+			}
+			Notification->ExpireAndFadeout();
+		}
 
-					if (ServerOptions.Num() > 0)
-					{
-						// TODO: select default server from 'cli.toml'
-						SelectedServer = ServerOptions[0];
-						ServerURLTextBox->SetText(FText::FromString(SelectedServer->GetURL()));
-					}
-				}
-				else
+		if (const TSharedPtr<SSpacetimeStatusTab> This = WeakThis.Pin())
+		{
+			This->CodegenTask.Reset();
+		}
+
+		if (!bSucceeded && !bCanceled)
+		{
+			FMessageDialog::Open(
+				EAppMsgCategory::Error,
+				EAppMsgType::Ok,
+				FText::Format(
+					LOCTEXT("GenerateFailedFmt", "🛑 Generate failed:\n{0}"),
+					Summary.ToText()
+				)
+			);
+		}
+	});
+
+	CodegenTask = Task;
+	Task->Start();
+}
+
+void SSpacetimeStatusTab::RefreshDatabaseList()
+{
+	DatabaseItems.Reset();
+	for (const FSpacetimeCodegenDatabase& Database : GetDefault<USpacetimeDBEditorSettings>()->CodegenDatabases)
+	{
+		DatabaseItems.Add(MakeShared<FString>(Database.Name));
+	}
+	if (DatabaseList.IsValid())
+	{
+		DatabaseList->RequestListRefresh();
+	}
+}
+
+void SSpacetimeStatusTab::HandleSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	RefreshDatabaseList();
+}
+
+TSharedRef<ITableRow> SSpacetimeStatusTab::MakeDatabaseRow(TSharedPtr<FString> DatabaseName, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<TSharedPtr<FString>>, OwnerTable)
+	[
+		SNew(SHorizontalBox)
+		+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center)
+		[
+			SNew(SCheckBox)
+			.IsChecked_Lambda([DatabaseName]()
+			{
+				const FSpacetimeCodegenDatabase* Database = FindCodegenDatabase(*DatabaseName);
+				return Database && Database->bSelected ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+			})
+			.OnCheckStateChanged_Lambda([DatabaseName](const ECheckBoxState State)
+			{
+				if (FSpacetimeCodegenDatabase* Database = FindCodegenDatabase(*DatabaseName))
 				{
-					// optional: log or show ConfigError
-					UE_LOG(LogTemp, Warning, TEXT("Failed to load cli.toml: %s"), *ConfigError);
+					Database->bSelected = State == ECheckBoxState::Checked;
+					GetMutableDefault<USpacetimeDBEditorSettings>()->Save();
 				}
-			}
+			})
+		]
+		+ SHorizontalBox::Slot().FillWidth(1.f).VAlign(VAlign_Center).Padding(4.f, 0.f)
+		[
+			SNew(STextBlock).Text(FText::FromString(*DatabaseName))
+		]
+		+ SHorizontalBox::Slot().AutoWidth().VAlign(VAlign_Center)
+		[
+			SNew(SButton)
+			.Text(LOCTEXT("RemoveDatabaseButton", "Remove"))
+			.OnClicked_Lambda([this, DatabaseName]() -> FReply
+			{
+				RemoveDatabase(*DatabaseName);
+				return FReply::Handled();
+			})
+		]
+	];
+}
+
+void SSpacetimeStatusTab::AddDatabase(const FString& DatabaseName)
+{
+	if (DatabaseName.IsEmpty())
+	{
+		return;
+	}
 
-			ServerComboBox->RefreshOptions();
-			ServerComboBox->SetSelectedItem(SelectedServer);
+	USpacetimeDBEditorSettings* Settings = GetMutableDefault<USpacetimeDBEditorSettings>();
+	if (FSpacetimeCodegenDatabase* Database = FindCodegenDatabase(DatabaseName))
+	{
+		Database->bSelected = true;
+	}
+	else
+	{
+		FSpacetimeCodegenDatabase& Added = Settings->CodegenDatabases.AddDefaulted_GetRef();
+		Added.Name = DatabaseName;
+	}
+	Settings->Save();
+	RefreshDatabaseList();
+}
+
+void SSpacetimeStatusTab::RemoveDatabase(const FString& DatabaseName)
+{
+	USpacetimeDBEditorSettings* Settings = GetMutableDefault<USpacetimeDBEditorSettings>();
+	Settings->CodegenDatabases.RemoveAll([&DatabaseName](const FSpacetimeCodegenDatabase& Database)
+	{
+		return Database.Name == DatabaseName;
+	});
+	Settings->Save();
+	RefreshDatabaseList();
+}
+
+void SSpacetimeStatusTab::HandleStatusChanged(const FSpacetimeCliStatus& Status)
+{
+	const bool bCliAvailable = Status.bCliAvailable;
+	const bool bLoggedIn = Status.bLoggedIn;
+
+	CliTextBlock->SetText(FText::FromString(bCliAvailable ? TEXT("available")   : TEXT("unavailable")));
+	CliTextBlock->SetColorAndOpacity(bCliAvailable
+		? FSlateColor(FLinearColor::Green)
+		: FSlateColor(FLinearColor::Red)
+	);
+	StatusTextBlock->SetText(FText::FromString(bLoggedIn ? TEXT("logged in") : TEXT("offline")));
+	StatusTextBlock->SetColorAndOpacity(bLoggedIn
+		? FSlateColor(FLinearColor::Green)
+		: FSlateColor(FLinearColor::Red)
+	);
+
+	// Every probe of the CLI lands here; the servers only need pinging right away if the list changed
+	auto DescribeServers = [](const FSpacetimeCliConfig& ServerList)
+	{
+		FString Description;
+		for (const FSpacetimeServerConfig& Server : ServerList.ServerConfigs)
+		{
+			Description += Server.Nickname + TEXT("=") + Server.GetURL() + TEXT(";");
+		}
+		return Description;
+	};
+	const bool bServerListChanged = DescribeServers(Config) != DescribeServers(Status.Config);
+	const bool bServersChanged = ServerOptions.IsEmpty() || bServerListChanged;
+
+	// Keep the user's pick across refreshes as long as the server still exists
+	const FStdbServerComboBoxItem Selected = ServerComboBox->GetSelectedItem();
+	const FString SelectedNickname = Selected.IsValid() ? Selected->Nickname : FString();
+	ServerOptions.Empty();
+	SelectedServer.Reset();
+
+	Config = Status.Config;
+	for (const auto& ServerConfig : Config.ServerConfigs)
+	{
+		ServerOptions.Add(MakeShared<FSpacetimeServerConfig>(ServerConfig));
+		if (ServerConfig.Nickname == SelectedNickname)
+		{
+			SelectedServer = ServerOptions.Last();
+		}
+	}
+
+	// Until the probes tell which server is fastest, the CLI's default
+	if (!SelectedServer.IsValid())
+	{
+		const FStdbServerComboBoxItem* DefaultServer = ServerOptions.FindByPredicate([this](const FStdbServerComboBoxItem& Item)
+		{
+			return Item->Nickname == Config.DefaultServer;
 		});
+		SelectedServer = DefaultServer ? *DefaultServer : ServerOptions.IsEmpty() ? FStdbServerComboBoxItem() : ServerOptions[0];
+	}
+
+	// A URL the user typed stays until the server list itself changes
+	if (bServerListChanged || !IsServerURLEdited())
+	{
+		SetServerURL(SelectedServer.IsValid() ? SelectedServer->GetURL() : TEXT("(no servers)"));
+	}
+
+	ServerComboBox->RefreshOptions();
+	ServerComboBox->SetSelectedItem(SelectedServer);
+
+	// Whatever was learned about other servers does not apply to these
+	if (bServersChanged)
+	{
+		ServerProbes.Reset();
+		ServerBackoff.RecordSuccess();
+		ProbeServers();
+	}
+}
+
+void SSpacetimeStatusTab::ProbeServers()
+{
+	++ProbeGeneration;
+	NumPendingProbes = ServerOptions.Num();
+	NextProbeTime = TNumericLimits<double>::Max();
+	if (ServerOptions.IsEmpty())
+	{
+		FinishServerProbes();
+		return;
+	}
+
+	// All requests go out together, so the slowest server, not their sum, bounds the wait.
+	// Servers probed before keep showing their last state until the new answer arrives.
+	for (const FStdbServerComboBoxItem& Server : ServerOptions)
+	{
+		ServerProbes.FindOrAdd(Server->Nickname);
+
+		const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(Server->GetURL() / TEXT("v1/ping"));
+		Request->SetVerb(TEXT("GET"));
+		Request->SetTimeout(ProbeTimeout);
+		Request->OnProcessRequestComplete().BindSP(this, &SSpacetimeStatusTab::HandleProbeCompleted, Server->Nickname, ProbeGeneration);
+		Request->ProcessRequest();
+	}
+}
+
+void SSpacetimeStatusTab::HandleProbeCompleted(
+	FHttpRequestPtr Request,
+	FHttpResponsePtr Response,
+	const bool bConnectedSuccessfully,
+	FString Nickname,
+	const uint32 Generation)
+{
+	FServerProbe* Probe = ServerProbes.Find(Nickname);
+	if (Generation != ProbeGeneration || !Probe)
+	{
+		return;
+	}
+
+	// Any answer means the server is up, even from one without a ping route
+	if (bConnectedSuccessfully && Response.IsValid())
+	{
+		Probe->State = FServerProbe::EState::Up;
+		Probe->RoundTripMs = Request->GetElapsedTime() * 1000.f;
+	}
+	else
+	{
+		Probe->State = FServerProbe::EState::Down;
+	}
+
+	SelectFastestServer();
+
+	if (--NumPendingProbes == 0)
+	{
+		FinishServerProbes();
+	}
+}
+
+void SSpacetimeStatusTab::FinishServerProbes()
+{
+	const bool bAnyUp = Algo::AnyOf(ServerProbes, [](const TPair<FString, FServerProbe>& Entry)
+	{
+		return Entry.Value.State == FServerProbe::EState::Up;
 	});
+	if (bAnyUp)
+	{
+		ServerBackoff.RecordSuccess();
+	}
+	else
+	{
+		ServerBackoff.RecordFailure();
+	}
+	NextProbeTime = FPlatformTime::Seconds() + (bAnyUp ? ServerProbeInterval : ServerBackoff.GetDelay());
+}
+
+void SSpacetimeStatusTab::SelectFastestServer()
+{
+	if (bUserPickedServer || IsServerURLEdited())
+	{
+		return;
+	}
+
+	FStdbServerComboBoxItem Fastest;
+	float FastestMs = TNumericLimits<float>::Max();
+	for (const FStdbServerComboBoxItem& Server : ServerOptions)
+	{
+		const FServerProbe* Probe = ServerProbes.Find(Server->Nickname);
+		if (Probe && Probe->State == FServerProbe::EState::Up && Probe->RoundTripMs < FastestMs)
+		{
+			Fastest = Server;
+			FastestMs = Probe->RoundTripMs;
+		}
+	}
+
+	if (Fastest.IsValid() && Fastest != ServerComboBox->GetSelectedItem())
+	{
+		SelectedServer = Fastest;
+		ServerComboBox->SetSelectedItem(Fastest);
+		SetServerURL(Fastest->GetURL());
+	}
+}
+
+void SSpacetimeStatusTab::SetServerURL(const FString& URL)
+{
+	ProgrammaticServerURL = URL;
+	ServerURLTextBox->SetText(FText::FromString(URL));
+}
+
+bool SSpacetimeStatusTab::IsServerURLEdited() const
+{
+	return ServerURLTextBox->GetText().ToString() != ProgrammaticServerURL;
+}
+
+FText SSpacetimeStatusTab::GetServerLabel(const FSpacetimeServerConfig& Server) const
+{
+	const FServerProbe* Probe = ServerProbes.Find(Server.Nickname);
+	if (!Probe || Probe->State == FServerProbe::EState::Probing)
+	{
+		return FText::Format(LOCTEXT("ServerProbing", "{0} (probing...)"), FText::FromString(Server.Nickname));
+	}
+	if (Probe->State == FServerProbe::EState::Down)
+	{
+		return FText::Format(LOCTEXT("ServerDown", "{0} (unreachable)"), FText::FromString(Server.Nickname));
+	}
+	return FText::Format(LOCTEXT("ServerUp", "{0} ({1} ms)"), FText::FromString(Server.Nickname), FText::AsNumber(FMath::RoundToInt32(Probe->RoundTripMs)));
+}
+
+FSlateColor SSpacetimeStatusTab::GetServerColor(const FSpacetimeServerConfig& Server) const
+{
+	const FServerProbe* Probe = ServerProbes.Find(Server.Nickname);
+	if (!Probe || Probe->State == FServerProbe::EState::Probing)
+	{
+		return FSlateColor::UseSubduedForeground();
+	}
+	return Probe->State == FServerProbe::EState::Up
+		? FSlateColor(FLinearColor::Green)
+		: FSlateColor(FLinearColor::Red);
 }
@@ -2,9 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "CLI/SpacetimeCliConfig.h"
+#include "CLI/SpacetimeCliStatusService.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
 #include "Framework/SlateDelegates.h"
-#include "Containers/Ticker.h"
+#include "Interfaces/IHttpRequest.h"
+#include "SpacetimeBackoff.h"
 
 class SSpacetimeStatusTab final : public SCompoundWidget
 {
@@ -17,13 +20,49 @@ public:
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs);
-	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
 
 private:
-	void ScheduleAsyncRefresh();
+	/**
+	 * Active timer, every RefreshInterval: refreshes the CLI status once it outlived its time to live
+	 * and pings the servers once due. Slate only fires it while the tab is shown.
+	 */
+	EActiveTimerReturnType HandleRefreshTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Shows a status probed by FSpacetimeCliStatusService. */
+	void HandleStatusChanged(const FSpacetimeCliStatus& Status);
+
+	/** Pings every server in ServerOptions at once; results arrive one by one. */
+	void ProbeServers();
+	void HandleProbeCompleted(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString Nickname, uint32 Generation);
+
+	/** Every server answered or timed out; schedules the next pings, later while all of them are down. */
+	void FinishServerProbes();
+
+	/** Selects the reachable server with the lowest round trip, unless the user picked one or typed a URL. */
+	void SelectFastestServer();
+
+	/** Puts a URL in ServerURLTextBox on the user's behalf. */
+	void SetServerURL(const FString& URL);
+
+	/** The user typed in ServerURLTextBox since SetServerURL last filled it. */
+	bool IsServerURLEdited() const;
+
+	/** Runs code generation for the databases in the background, reporting through an editor notification. */
+	void StartCodegen(const FString& ServerURL, const TArray<FString>& DatabaseNames);
+
+	/** Shows USpacetimeDBEditorSettings::CodegenDatabases in DatabaseList. */
+	void RefreshDatabaseList();
+	void HandleSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent);
+	TSharedRef<ITableRow> MakeDatabaseRow(TSharedPtr<FString> DatabaseName, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Adds a database to the project settings, selected; or selects it if listed already. */
+	void AddDatabase(const FString& DatabaseName);
+	void RemoveDatabase(const FString& DatabaseName);
+
+	FText GetServerLabel(const FSpacetimeServerConfig& Server) const;
+	FSlateColor GetServerColor(const FSpacetimeServerConfig& Server) const;
 	
 	float RefreshInterval= 1.f;
-	float AccumulatedTime = 0.f;
 
 	FSpacetimeCliConfig Config;
 	
@@ -41,6 +80,51 @@ private:
 	// The combo-box itself
 	TSharedPtr<FStdbServerComboBox> ServerComboBox;
 
+	/** Seconds before a server that does not answer counts as down. */
+	static constexpr float ProbeTimeout = 3.f;
+
+	struct FServerProbe
+	{
+		enum class EState : uint8 { Probing, Up, Down };
+
+		EState State = EState::Probing;
+		float RoundTripMs = 0.f;
+	};
+
+	/** Seconds between pings while some server is up. */
+	static constexpr double ServerProbeInterval = 30.0;
+
+	/** While every server is down, pings wait this long, doubling after each round up to MaxServerBackoff. */
+	static constexpr double MinServerBackoff = 5.0;
+	static constexpr double MaxServerBackoff = 5.0 * 60.0;
+
+	/** Latest probe of each server in ServerOptions, by nickname. */
+	TMap<FString, FServerProbe> ServerProbes;
+
+	/** Answers of older probes are ignored. */
+	uint32 ProbeGeneration = 0;
+
+	/** Pings of the current generation still on their way. */
+	int32 NumPendingProbes = 0;
+
+	/** FPlatformTime::Seconds() of the next pings; none are due while some are on their way. */
+	double NextProbeTime = TNumericLimits<double>::Max();
+
+	FSpacetimeBackoff ServerBackoff{MinServerBackoff, MaxServerBackoff};
+
+	/** The user chose a server themselves, which the fastest server no longer overrides. */
+	bool bUserPickedServer = false;
+
+	/** What SetServerURL last put in ServerURLTextBox. */
+	FString ProgrammaticServerURL;
+
+	/** Databases of the project settings, in their order. */
+	TArray<TSharedPtr<FString>> DatabaseItems;
+	TSharedPtr<SListView<TSharedPtr<FString>>> DatabaseList;
+
+	/** The running code generation, if any; one at a time. */
+	TSharedPtr<class FSpacetimeCodegenTask> CodegenTask;
+
 	// Other stuff
 	TSharedPtr<SEditableTextBox> DatabaseNameTextBox;
 	TSharedPtr<SEditableTextBox> ServerURLTextBox;
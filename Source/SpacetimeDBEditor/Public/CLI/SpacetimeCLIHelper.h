@@ -12,6 +12,10 @@ public:
 
 	static bool IsCliAvailable();
 
+	/**
+	 * Whether cli.toml holds a token that has not expired. Decided in process from the token's
+	 * claims; only runs `spacetime login show` if cli.toml cannot be read or its token decoded.
+	 */
 	static bool IsLoggedIn();
 
 	struct FSpacetimeCredentials
@@ -19,14 +23,37 @@ public:
 		FString Identity;
 		FString Token;
 
+		/** The token's "exp" claim; FDateTime::MaxValue() if it never expires or is unknown. */
+		FDateTime ExpiresAt = FDateTime::MaxValue();
+
 		bool IsValid() const
 		{
 			return !Identity.IsEmpty() && !Token.IsEmpty();
 		}
+
+		bool IsExpired() const
+		{
+			return FDateTime::UtcNow() >= ExpiresAt;
+		}
 	};
 	
 	static bool TryParseSpacetimeLogin(const FString& CliOutput, FSpacetimeCredentials& OutCredentials);
 
+	/**
+	 * Decodes the claims of a SpacetimeDB token (a JWT) without verifying its signature.
+	 * @param Token           The token, as stored in cli.toml's spacetimedb_token.
+	 * @param OutCredentials  The token, its hex identity and its expiry on success.
+	 * @param OutError        Error message on failure.
+	 * @return true if the token is a well-formed JWT with an identity claim.
+	 */
+	static bool DecodeToken(const FString& Token, FSpacetimeCredentials& OutCredentials, FString& OutError);
+
+	/**
+	 * Reads the credentials of the logged in user from cli.toml, without running the CLI.
+	 * Fails if the file is missing or holds no token; the token may have expired.
+	 */
+	static bool ResolveCredentials(FSpacetimeCredentials& OutCredentials, FString& OutError);
+
 	/**
 	 * Returns the default path for cli.toml (calls GetDefaultCliTomlPath internally).
 	 * If the file exists and is non-empty, returns true and sets OutPath.
@@ -35,24 +62,23 @@ public:
 	static bool GetCliTomlPath(FString& OutPath, FString& OutError);
 
 	/**
-	 * Finds and parses the user's cli.toml into OutConfig.
+	 * Finds and parses the user's cli.toml into OutConfig. Any thread; the parsed file is cached
+	 * process-wide and only parsed again once its timestamp or size changed.
 	 * @param OutConfig Parsed contents on success.
 	 * @param OutError  Error message on failure.
 	 * @return true if the file was found, valid TOML, and correctly parsed.
 	 */
 	static bool GetCliConfig(FSpacetimeCliConfig& OutConfig, FString& OutError);
 
-private:
-	/** Validates existence and non-emptiness of a given path. */
-	static bool ValidateFile(const FString& InPath, FString& OutError);
-
-	/** Reads and parses the TOML at InPath, then fills OutConfig. */
-	static bool ParseToml(const FString& InPath, FSpacetimeCliConfig& OutConfig, FString& OutError);
-	
 	/** 
 	 * @return Absolute path to the default ~/.config/spacetime/cli.toml  (Linux/macOS)
 	 *         or %LOCALAPPDATA%\SpacetimeDB\cli.toml (Windows), 
 	 *         or empty if neither could be determined.
 	 */
 	static FString GetDefaultCliTomlPath();
+
+private:
+	/** Reads and parses the TOML at InPath, then fills OutConfig. Defined next to toml.hpp, in SpacetimeCliConfig.cpp. */
+	static bool ParseToml(const FString& InPath, FSpacetimeCliConfig& OutConfig, FString& OutError);
+	
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpacetimeBackoff.h"
+#include "SpacetimeCliConfig.h"
+
+struct FFileChangeData;
+
+/** What the editor knows about the local SpacetimeDB CLI. */
+struct FSpacetimeCliStatus
+{
+	bool bCliAvailable = false;
+	bool bLoggedIn = false;
+
+	/** Parsed cli.toml; only read when logged in, and left empty if ConfigError is set. */
+	FSpacetimeCliConfig Config;
+	FString ConfigError;
+
+	/** FPlatformTime::Seconds() when the probe finished. */
+	double ProbeTime = 0.0;
+};
+
+/**
+ * Shared, cached answer to whether the CLI is installed, whether the user is logged in, and what
+ * cli.toml says.
+ *
+ * Probing forks the CLI twice, so a result is kept for a time to live and every widget reads the
+ * same copy. Refreshes requested while a probe runs join it instead of starting another. Logging
+ * in or out from a terminal rewrites cli.toml, which a directory watcher picks up to probe again
+ * right away; listeners hear about every finished probe through OnStatusChanged. While the CLI
+ * is missing, each failed probe doubles the time to live, so nobody keeps forking a process that
+ * is not there.
+ *
+ * Game thread only.
+ */
+class FSpacetimeCliStatusService : public TSharedFromThis<FSpacetimeCliStatusService>
+{
+public:
+	static constexpr double DefaultTimeToLive = 60.0;
+
+	/** Forced refreshes closer together than this reuse the last probe. */
+	static constexpr double MinProbeInterval = 2.0;
+
+	/** Longest time to live while the CLI cannot be found. */
+	static constexpr double MaxBackoff = 15.0 * 60.0;
+
+	static FSpacetimeCliStatusService& Get();
+
+	/** Stops watching cli.toml and releases the service; called when the editor module shuts down. */
+	static void Shutdown();
+
+	~FSpacetimeCliStatusService();
+
+	/** Probes unless the cached status is fresh; bForce only skips the time to live. */
+	void Refresh(bool bForce = false);
+
+	bool HasStatus() const { return bHasStatus; }
+	const FSpacetimeCliStatus& GetStatus() const { return Status; }
+	bool IsProbing() const { return bProbing; }
+
+	void SetTimeToLive(const double Seconds) { TimeToLive = Seconds; }
+
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnStatusChanged, const FSpacetimeCliStatus& /*Status*/);
+
+	/** Broadcast after every probe, whether or not anything changed. */
+	FOnStatusChanged OnStatusChanged;
+
+private:
+	void StartProbe();
+	void FinishProbe(FSpacetimeCliStatus&& NewStatus);
+
+	void WatchConfigDirectory();
+	void StopWatching();
+	void HandleDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+	/** Whether cli.toml differs from when the last probe finished. */
+	bool HasConfigChanged() const;
+
+	FSpacetimeCliStatus Status;
+	bool bHasStatus = false;
+	bool bProbing = false;
+	double TimeToLive = DefaultTimeToLive;
+	FSpacetimeBackoff Backoff{DefaultTimeToLive, MaxBackoff};
+
+	FString ConfigPath;
+	FString WatchedDirectory;
+	FDelegateHandle WatchHandle;
+
+	/** cli.toml as of the last finished probe; the CLI may rewrite it while being probed. */
+	FDateTime ConfigTimeStamp;
+	int64 ConfigSize = -1;
+};
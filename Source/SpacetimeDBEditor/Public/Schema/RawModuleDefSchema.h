@@ -322,7 +322,7 @@ namespace SATS
     struct FTableDef {
         FString                       Name;
         int                           ProductTypeRef;
-        TArray<FString>               PrimaryKey;
+        TArray<FString>               PrimaryKey;     // column names
         TArray<struct FIndexDef>      Indexes;
         TArray<struct FConstraintDef> Constraints;
         TArray<struct FSequenceDef>   Sequences;
@@ -341,7 +341,21 @@ namespace SATS
         FSumType            Lifecycle;
     };
 
-    struct FIndexDef { FString Name; TArray<FString> Columns; };
+    enum class EIndexAlgorithm : uint8
+    {
+        BTree,  // { "BTree": [col, ...] }
+        Hash,   // { "Hash": [col, ...] }
+        Direct, // { "Direct": col }
+        Invalid
+    };
+
+    struct FIndexDef {
+        FString             Name;
+        FOptionalString     AccessorName;
+        EIndexAlgorithm     Algorithm = EIndexAlgorithm::Invalid;
+        TArray<uint16>      ColumnIds;   // positions in the table's row Product
+        TArray<FString>     Columns;     // names of the columns above, resolved against the typespace
+    };
     struct FConstraintDef { FString Expr; };
     struct FSequenceDef { FString Name; int Start; };
 
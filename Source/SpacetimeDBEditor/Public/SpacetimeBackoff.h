@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Exponential backoff for probing something that may be down, such as a server or the CLI: every
+ * failure in a row doubles the wait before the next attempt, from InitialDelay up to MaxDelay,
+ * and a success resets it.
+ */
+struct FSpacetimeBackoff
+{
+	FSpacetimeBackoff(const double InInitialDelay, const double InMaxDelay)
+		: InitialDelay(InInitialDelay)
+		, MaxDelay(InMaxDelay)
+	{
+	}
+
+	void RecordSuccess() { Failures = 0; }
+	void RecordFailure() { ++Failures; }
+
+	int32 GetFailures() const { return Failures; }
+
+	/** Seconds to wait after the last attempt; 0 if it succeeded. */
+	double GetDelay() const
+	{
+		return Failures == 0 ? 0.0 : FMath::Min(MaxDelay, InitialDelay * FMath::Pow(2.0, static_cast<double>(FMath::Min(Failures - 1, 30))));
+	}
+
+private:
+	double InitialDelay;
+	double MaxDelay;
+	int32 Failures = 0;
+};
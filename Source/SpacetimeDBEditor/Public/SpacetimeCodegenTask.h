@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+class FSpacetimeProcessRunner;
+
+/** Steps of USpacetimeDBEditorHelpers::GenerateCode, in order; with several databases each step covers all of them. */
+enum class ESpacetimeCodegenPhase : uint8
+{
+	Fetching,
+	Parsing,
+	Generating,
+	Writing,
+	Num
+};
+
+SPACETIMEDBEDITOR_API FText GetSpacetimeCodegenPhaseText(ESpacetimeCodegenPhase Phase);
+
+/** Outcome of code generation for one or more databases. */
+struct SPACETIMEDBEDITOR_API FSpacetimeCodegenSummary
+{
+	struct FDatabase
+	{
+		FString Name;
+
+		/** Empty if the database's code was generated. */
+		FString Error;
+
+		int32 NumTables = 0;
+		int32 NumReducers = 0;
+
+		/** Generated types, not counting shared ones. */
+		int32 NumTypes = 0;
+
+		/** Spent fetching, parsing and generating this database; databases overlap. */
+		double Seconds = 0.0;
+
+		/** Not asked for, but generated again so the types it shares with the others stay consistent; skipped if it has an Error. */
+		bool bCompanion = false;
+	};
+
+	TArray<FDatabase> Databases;
+
+	/** Types several databases define identically, generated once for all of them. */
+	TArray<FString> SharedTypes;
+
+	/** Why nothing was written; empty on success. */
+	FString Error;
+
+	FString OutputPath;
+	double Seconds = 0.0;
+
+	/** Generated files, and those of them whose contents changed and were written. */
+	int32 NumFiles = 0;
+	int32 NumFilesWritten = 0;
+
+	bool Succeeded() const { return Error.IsEmpty(); }
+
+	/** Multi-line report for dialogs and the log. */
+	FText ToText() const;
+};
+
+/**
+ * Code generation for one or more databases, run in the background.
+ *
+ * The databases are fetched, parsed and generated side by side on the task graph, and written
+ * together once all of them succeeded; types they share are generated once. The other databases
+ * of the project settings are generated along with them, from the schemas fetched earlier where
+ * possible, as their files would otherwise define the shared types a second time. Everything up to
+ * writing happens in memory, so a canceled run leaves the previously generated files untouched;
+ * canceling while schemas are fetched kills the CLI. Progress and the result are reported on the
+ * game thread.
+ */
+class SPACETIMEDBEDITOR_API FSpacetimeCodegenTask : public TSharedFromThis<FSpacetimeCodegenTask>
+{
+public:
+	/** Game thread, as it reads the other databases from the project settings. */
+	FSpacetimeCodegenTask(const FString& InServerURL, TArray<FString> InDatabaseNames);
+
+	/** Runs the generation on a thread of its own; at most once per task. */
+	void Start();
+
+	/** Any thread. Stops before the next step, and before anything was written. */
+	void Cancel();
+
+	bool IsCanceled() const { return bCanceled; }
+	bool IsRunning() const { return bRunning; }
+
+	const TArray<FString>& GetDatabaseNames() const { return DatabaseNames; }
+	const TArray<FString>& GetCompanionDatabaseNames() const { return CompanionDatabaseNames; }
+
+	/** Before Start. Databases known not to have changed, whose schemas fetched by an earlier run are used if there are any. */
+	void SetReusableSchemas(TSet<FString> InDatabaseNames) { ReusableSchemas = MoveTemp(InDatabaseNames); }
+	bool CanReuseSchema(const FString& DatabaseName) const { return ReusableSchemas.Contains(DatabaseName); }
+
+	/** Game thread. Whether any task is generating, such as the schema watcher's; they would write the same files. */
+	static bool IsAnyRunning() { return NumRunning > 0; }
+
+	DECLARE_DELEGATE_OneParam(FOnPhase, ESpacetimeCodegenPhase /*Phase*/);
+	DECLARE_DELEGATE_OneParam(FOnCompleted, const FSpacetimeCodegenSummary& /*Summary*/);
+
+	/** Game thread. Bind before Start. */
+	FOnPhase OnPhase;
+
+	/** Game thread. Also fires for a canceled task, with a failed summary. */
+	FOnCompleted OnCompleted;
+
+	/** Generation thread. Called at the start of each step. */
+	void EnterPhase(ESpacetimeCodegenPhase Phase);
+
+	/** Any generation thread. Lets Cancel stop the process, or stops it right away if already canceled. */
+	void AttachProcess(const TSharedRef<FSpacetimeProcessRunner>& Runner);
+
+private:
+	const FString ServerURL;
+	const TArray<FString> DatabaseNames;
+	TArray<FString> CompanionDatabaseNames;
+	TSet<FString> ReusableSchemas;
+
+	static int32 NumRunning;
+
+	std::atomic<bool> bCanceled{false};
+	std::atomic<bool> bRunning{false};
+
+	FCriticalSection ProcessLock;
+	TArray<TSharedRef<FSpacetimeProcessRunner>> Processes;
+};
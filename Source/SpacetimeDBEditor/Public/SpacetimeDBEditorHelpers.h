@@ -6,6 +6,9 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "SpacetimeDBEditorHelpers.generated.h"
 
+class FSpacetimeCodegenTask;
+struct FSpacetimeCodegenSummary;
+
 /**
  * 
  */
@@ -27,4 +30,31 @@ public:
 		FString& OutFullPath,
 		FString& OutError);
 
+	/**
+	 * GenerateCxxUnrealCodeFromSpacetimeDB, reporting its progress to Task and stopping once it
+	 * was canceled. Goes through GenerateCodeForDatabases, with the other databases of the project
+	 * settings as companions. Task may be null. Game thread without a task, as the settings are read.
+	 */
+	static bool GenerateCode(
+		const FString& ServerURL,
+		const FString& DatabaseName,
+		FString& OutFullPath,
+		FString& OutError,
+		FSpacetimeCodegenTask* Task);
+
+	/**
+	 * GenerateCode for several databases at once: each step runs for all of them side by side on
+	 * the task graph, types they share are generated once into a header of their own, and the
+	 * files are written only once every database succeeded. Task may be null. Any thread.
+	 * @param CompanionDatabaseNames Databases whose files were generated before and are generated again with the
+	 *                               others, so shared types are detected against all of them; their cached schemas are reused
+	 * @return Whether the files were written; OutSummary has the details either way
+	 */
+	static bool GenerateCodeForDatabases(
+		const FString& ServerURL,
+		const TArray<FString>& DatabaseNames,
+		const TArray<FString>& CompanionDatabaseNames,
+		FSpacetimeCodegenSummary& OutSummary,
+		FSpacetimeCodegenTask* Task);
+
 };
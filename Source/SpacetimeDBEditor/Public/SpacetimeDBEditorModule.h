@@ -12,5 +12,6 @@ public:
 
 private:
     TSharedRef<SDockTab> SpawnGeneralTab(const class FSpawnTabArgs& Args);
+    TSharedRef<SDockTab> SpawnSchemaTab(const class FSpawnTabArgs& Args);
     
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "SpacetimeDBEditorSettings.generated.h"
+
+/** A database the editor generates code for. */
+USTRUCT()
+struct FSpacetimeCodegenDatabase
+{
+	GENERATED_BODY()
+
+	/** The database's name as present in the Spacetime server. */
+	UPROPERTY(EditAnywhere, Category="SpacetimeDB")
+	FString Name;
+
+	/** Whether 'Generate Selected' includes the database. */
+	UPROPERTY(EditAnywhere, Category="SpacetimeDB")
+	bool bSelected = true;
+};
+
+/**
+ * Project settings of the SpacetimeDB editor tools, under Project Settings > Plugins > SpacetimeDB.
+ * Saved to DefaultEditor.ini, so the whole team shares the list of databases.
+ */
+UCLASS(config=Editor, defaultconfig, meta=(DisplayName="SpacetimeDB"))
+class SPACETIMEDBEDITOR_API USpacetimeDBEditorSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	/** Databases listed in the status tab, which generates the selected ones together. */
+	UPROPERTY(config, EditAnywhere, Category="Code Generation")
+	TArray<FSpacetimeCodegenDatabase> CodegenDatabases;
+
+	/** Regenerates the selected databases in the background whenever their module is published again. */
+	UPROPERTY(config, EditAnywhere, Category="Schema Watcher")
+	bool bWatchSchemas = false;
+
+	/** Server the selected databases' metadata is polled from. */
+	UPROPERTY(config, EditAnywhere, Category="Schema Watcher", meta=(EditCondition="bWatchSchemas"))
+	FString WatchServerURL = TEXT("http://localhost:3000");
+
+	/** Seconds between polls; each poll is one small HTTP request per database. */
+	UPROPERTY(config, EditAnywhere, Category="Schema Watcher", meta=(EditCondition="bWatchSchemas", ClampMin="1", Units="s"))
+	float SchemaPollInterval = 5.f;
+
+	/** Compiles regenerated code with Live Coding where it is enabled; otherwise the editor has to be rebuilt. */
+	UPROPERTY(config, EditAnywhere, Category="Schema Watcher", meta=(EditCondition="bWatchSchemas"))
+	bool bLiveCodingAfterRegeneration = true;
+
+	/** Seconds between scrapes of the server's metrics by the status tab's reducer panel. */
+	UPROPERTY(config, EditAnywhere, Category="Metrics", meta=(ClampMin="0.5", Units="s"))
+	float MetricsScrapeInterval = 2.f;
+
+	TArray<FString> GetSelectedDatabases() const;
+
+	/** Every listed database, selected or not; their generated files all share the same output directory. */
+	TArray<FString> GetAllDatabases() const;
+
+	/** Writes changes made outside the settings editor, such as the status tab's, to the config file. */
+	void Save();
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Interfaces/IHttpRequest.h"
+#include "SpacetimeBackoff.h"
+
+class FSpacetimeCodegenTask;
+struct FSpacetimeCodegenSummary;
+struct FPropertyChangedEvent;
+
+/**
+ * Regenerates code once a watched database's module was published again, as configured in
+ * USpacetimeDBEditorSettings.
+ *
+ * Every poll asks the server for each selected database's metadata, a small JSON document that
+ * carries the hash of the module's program, instead of describing the whole schema. Once a
+ * fingerprint changes, the selected databases are regenerated in the background: only the changed
+ * ones are described again, only files whose contents changed are written, and Live Coding
+ * compiles them where it is enabled. The first poll of a database only learns its fingerprint.
+ *
+ * A regeneration that fails is reported and not retried until the module changes again. While
+ * the server answers none of the polls, they back off up to MaxPollBackoff. Game thread only.
+ */
+class SPACETIMEDBEDITOR_API FSpacetimeSchemaWatcher : public TSharedFromThis<FSpacetimeSchemaWatcher>
+{
+public:
+	/** Seconds before a server that does not answer a poll is skipped until the next one. */
+	static constexpr float PollTimeout = 3.f;
+
+	/** Longest wait between polls of a server that is down. */
+	static constexpr double MaxPollBackoff = 5.0 * 60.0;
+
+	static FSpacetimeSchemaWatcher& Get();
+
+	/** Stops polling and releases the watcher; called when the editor module shuts down. */
+	static void Shutdown();
+
+	~FSpacetimeSchemaWatcher();
+
+	/** Starts or stops polling as the settings say; runs again whenever they change. */
+	void ApplySettings();
+
+	bool IsWatching() const { return TickerHandle.IsValid(); }
+
+private:
+	bool Tick(float DeltaTime);
+
+	/** Requests the metadata of every selected database at once. */
+	void Poll();
+	void HandleMetadata(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString DatabaseName, uint32 Generation);
+	void FinishPoll();
+
+	void Regenerate(const TSet<FString>& ChangedDatabases);
+
+	/** Whether Live Coding took the regenerated code. */
+	static bool CompileWithLiveCoding();
+
+	void StopPolling();
+	void HandleSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent);
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	float PollInterval = 0.f;
+	FDelegateHandle SettingsChangedHandle;
+
+	/**
+	 * Fingerprint of every database's metadata as of the last poll that reached it, on FingerprintServerURL.
+	 * A changed fingerprint replaces the known one only once the regeneration it calls for started.
+	 */
+	TMap<FString, uint32> Fingerprints;
+	FString FingerprintServerURL;
+
+	/** The poll in flight; answers of older polls are ignored. */
+	FString PollServerURL;
+	TMap<FString, uint32> PolledFingerprints;
+	int32 PendingResponses = 0;
+	uint32 PollGeneration = 0;
+
+	/** Starts at PollInterval once a poll went unanswered; polls wait until NextPollTime. */
+	FSpacetimeBackoff Backoff{0.0, MaxPollBackoff};
+	double NextPollTime = 0.0;
+
+	TSharedPtr<FSpacetimeCodegenTask> Task;
+};
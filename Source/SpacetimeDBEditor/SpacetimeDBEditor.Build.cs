@@ -16,7 +16,8 @@ public class SpacetimeDBEditor : ModuleRules
             "Json",
             "JsonUtilities",
             "SpacetimeDBRuntime",
-            "Blutility"
+            "Blutility",
+            "DeveloperSettings"
         };
         PublicDependencyModuleNames.AddRange(list.AsReadOnly());
 
@@ -29,8 +30,16 @@ public class SpacetimeDBEditor : ModuleRules
             "LevelEditor",
             "ToolMenus",
             "PropertyEditor",
-            "Projects"
+            "Projects",
+            "DirectoryWatcher",
+            "HTTP"
         };
         PrivateDependencyModuleNames.AddRange(list1.AsReadOnly());
+
+        // Compiles code the schema watcher regenerated, see FSpacetimeSchemaWatcher
+        if (target.Platform == UnrealTargetPlatform.Win64)
+        {
+            PrivateDependencyModuleNames.Add("LiveCoding");
+        }
     }
 }
@@ -0,0 +1,272 @@
+#include "Cache/SpacetimeCacheSnapshot.h"
+
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "Codec/SpacetimeBsatnReader.h"
+#include "Codec/SpacetimeBsatnWriter.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/** "STDBSNAP", little-endian */
+static constexpr uint64 SnapshotMagic = 0x50414E5342445453ull;
+static constexpr uint32 SnapshotVersion = 1;
+
+/** A snapshot file mapped read-only; unmapped with the last row that refers into it. */
+class FSpacetimeMappedPage : public FSpacetimeBsatnPage
+{
+public:
+	FSpacetimeMappedPage(TUniquePtr<IMappedFileHandle> InHandle, TUniquePtr<IMappedFileRegion> InRegion)
+		: FSpacetimeBsatnPage(TConstArrayView<uint8>(InRegion->GetMappedPtr(), InRegion->GetMappedSize()))
+		, Handle(MoveTemp(InHandle))
+		, Region(MoveTemp(InRegion))
+	{
+	}
+
+private:
+	// The region goes before the handle it was mapped from
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+};
+
+FSpacetimeCacheSnapshot::~FSpacetimeCacheSnapshot()
+{
+	Release();
+}
+
+FString FSpacetimeCacheSnapshot::GetDefaultPath(const FString& DatabaseName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("SpacetimeDB") / DatabaseName + TEXT(".stdbcache");
+}
+
+void FSpacetimeCacheSnapshot::Serialize(const FSpacetimeClientCache& Cache, const uint32 SchemaFingerprint, TArray<uint8>& OutData)
+{
+	// Header, then per table its name, row count and length-prefixed rows; a row is stored once per
+	// reference, so releasing the snapshot takes back exactly the references it stands for
+	FSpacetimeBsatnWriter Writer(OutData);
+	Writer.WriteScalar(SnapshotMagic);
+	Writer.WriteScalar(SnapshotVersion);
+	Writer.WriteScalar(SchemaFingerprint);
+
+	int32 NumTables = 0;
+	const int32 NumTablesOffset = OutData.Num();
+	Writer.WriteLength(0);
+
+	Cache.ForEachTable([&](const ISpacetimeTableCache& Table)
+	{
+		Writer.WriteString(Table.GetTableName());
+		int32 NumRows = 0;
+		const int32 NumRowsOffset = OutData.Num();
+		Writer.WriteLength(0);
+		Table.ForEachRowBytes([&](const TConstArrayView<uint8> Row, const int32 RefCount)
+		{
+			for (int32 i = 0; i < RefCount; ++i)
+			{
+				Writer.WriteBytes(Row);
+			}
+			NumRows += RefCount;
+		});
+		FMemory::Memcpy(OutData.GetData() + NumRowsOffset, &NumRows, sizeof(uint32));
+		++NumTables;
+	});
+	FMemory::Memcpy(OutData.GetData() + NumTablesOffset, &NumTables, sizeof(uint32));
+}
+
+TFuture<bool> FSpacetimeCacheSnapshot::SaveAsync(const FSpacetimeClientCache& Cache, const FString& Path, const uint32 SchemaFingerprint)
+{
+	check(IsInGameThread());
+
+	// Only copying happens on the game thread
+	TArray<uint8> Data;
+	Serialize(Cache, SchemaFingerprint, Data);
+
+	return Async(EAsyncExecution::ThreadPool, [Data = MoveTemp(Data), Path]
+	{
+		// Written aside and moved into place, so a crash never leaves a truncated snapshot behind
+		const FString TempPath = Path + TEXT(".tmp");
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		if (!FFileHelper::SaveArrayToFile(Data, *TempPath)
+			|| (PlatformFile.FileExists(*Path) && !PlatformFile.DeleteFile(*Path))
+			|| !PlatformFile.MoveFile(*Path, *TempPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Failed to save cache snapshot '%s'"), *Path);
+			PlatformFile.DeleteFile(*TempPath);
+			return false;
+		}
+		UE_LOG(LogTemp, Log, TEXT("[spacetime] Saved cache snapshot '%s' (%d bytes)"), *Path, Data.Num());
+		return true;
+	});
+}
+
+bool FSpacetimeCacheSnapshot::Parse(
+	const FSpacetimeBsatnPagePtr& Page,
+	const uint32 SchemaFingerprint,
+	TArray<FSpacetimeTableDelta>& OutTables,
+	FString& OutError)
+{
+	FSpacetimeBsatnReader Reader(Page->GetBytes());
+
+	uint64 Magic;
+	uint32 Version;
+	uint32 Fingerprint;
+	if (!Reader.ReadScalar(Magic) || !Reader.ReadScalar(Version) || !Reader.ReadScalar(Fingerprint)
+		|| Magic != SnapshotMagic || Version != SnapshotVersion)
+	{
+		OutError = TEXT("Not a cache snapshot, or one of another version");
+		return false;
+	}
+	if (Fingerprint != SchemaFingerprint)
+	{
+		OutError = FString::Printf(TEXT("Snapshot was saved with schema %08x, not %08x"), Fingerprint, SchemaFingerprint);
+		return false;
+	}
+
+	uint32 NumTables;
+	if (!Reader.ReadLength(NumTables))
+	{
+		OutError = TEXT("Truncated snapshot");
+		return false;
+	}
+	for (uint32 i = 0; i < NumTables; ++i)
+	{
+		FSpacetimeTableDelta& Delta = OutTables.AddDefaulted_GetRef();
+		uint32 NumRows;
+		if (!Reader.ReadString(Delta.TableName) || !Reader.ReadLength(NumRows)
+			|| NumRows > static_cast<uint32>(Reader.GetRemaining() / sizeof(uint32)))
+		{
+			OutError = TEXT("Truncated snapshot");
+			return false;
+		}
+
+		// Rows stay where they are; the deltas refer into the page
+		Delta.Inserts.Reserve(NumRows);
+		for (uint32 Row = 0; Row < NumRows; ++Row)
+		{
+			TConstArrayView<uint8> Bytes;
+			if (!Reader.ReadBytesView(Bytes))
+			{
+				OutError = FString::Printf(TEXT("Truncated snapshot in table '%s'"), *Delta.TableName);
+				return false;
+			}
+			Delta.Inserts.Add({Page, Reader.GetOffset() - Bytes.Num(), Bytes.Num()});
+		}
+	}
+	return true;
+}
+
+TSharedPtr<FSpacetimeCacheSnapshot> FSpacetimeCacheSnapshot::Load(
+	const FString& Path,
+	const uint32 SchemaFingerprint,
+	const TSharedRef<FSpacetimeClientCache>& Cache,
+	FString& OutError)
+{
+	check(IsInGameThread());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		OutError = FString::Printf(TEXT("No cache snapshot at '%s'"), *Path);
+		return nullptr;
+	}
+
+	FSpacetimeBsatnPagePtr Page;
+	if (TUniquePtr<IMappedFileHandle> Handle(PlatformFile.OpenMapped(*Path)); Handle.IsValid() && Handle->GetFileSize() > 0)
+	{
+		TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion());
+		if (Region.IsValid())
+		{
+			Page = MakeShared<const FSpacetimeMappedPage, ESPMode::ThreadSafe>(MoveTemp(Handle), MoveTemp(Region));
+		}
+	}
+	if (!Page.IsValid())
+	{
+		// Platforms without mapped files read it instead
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *Path))
+		{
+			OutError = FString::Printf(TEXT("Failed to read cache snapshot '%s'"), *Path);
+			return nullptr;
+		}
+		Page = MakeShared<const FSpacetimeBsatnPage, ESPMode::ThreadSafe>(MoveTemp(Data));
+	}
+
+	if (Page->GetBytes().Num() > MAX_int32)
+	{
+		OutError = FString::Printf(TEXT("Cache snapshot '%s' is too large"), *Path);
+		return nullptr;
+	}
+
+	TSharedRef<FSpacetimeCacheSnapshot> Snapshot = MakeShareable(new FSpacetimeCacheSnapshot());
+	if (!Parse(Page, SchemaFingerprint, Snapshot->Tables, OutError))
+	{
+		// Outdated or damaged; unmapped before it is deleted, and the next save replaces it
+		Snapshot->Tables.Empty();
+		Snapshot->bReleased = true;
+		Page.Reset();
+		PlatformFile.DeleteFile(*Path);
+		OutError = FString::Printf(TEXT("Discarding cache snapshot '%s': %s"), *Path, *OutError);
+		return nullptr;
+	}
+
+	Snapshot->Cache = Cache;
+	FSpacetimeTransactionUpdate Update;
+	Update.Tables = Snapshot->Tables;
+	Cache->EnqueueTransaction(MoveTemp(Update));
+
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Loaded %d rows from cache snapshot '%s'"), Snapshot->GetNumRows(), *Path);
+	return Snapshot;
+}
+
+TSharedRef<FSpacetimeCacheSnapshot> FSpacetimeCacheSnapshot::Capture(const TSharedRef<FSpacetimeClientCache>& Cache)
+{
+	check(IsInGameThread());
+
+	TArray<uint8> Data;
+	Serialize(*Cache, 0, Data);
+	const FSpacetimeBsatnPagePtr Page = MakeShared<const FSpacetimeBsatnPage, ESPMode::ThreadSafe>(MoveTemp(Data));
+
+	TSharedRef<FSpacetimeCacheSnapshot> Snapshot = MakeShareable(new FSpacetimeCacheSnapshot());
+	FString Error;
+	verify(Parse(Page, 0, Snapshot->Tables, Error));
+	Snapshot->Cache = Cache;
+	return Snapshot;
+}
+
+void FSpacetimeCacheSnapshot::Release()
+{
+	if (bReleased)
+	{
+		return;
+	}
+	bReleased = true;
+
+	const TSharedPtr<FSpacetimeClientCache> PinnedCache = Cache.Pin();
+	if (!PinnedCache.IsValid())
+	{
+		return;
+	}
+
+	FSpacetimeTransactionUpdate Update;
+	Update.Tables = MoveTemp(Tables);
+	for (FSpacetimeTableDelta& Delta : Update.Tables)
+	{
+		Swap(Delta.Inserts, Delta.Deletes);
+	}
+	PinnedCache->EnqueueTransaction(MoveTemp(Update));
+}
+
+void FSpacetimeCacheSnapshot::Discard()
+{
+	bReleased = true;
+	Tables.Empty();
+}
+
+int32 FSpacetimeCacheSnapshot::GetNumRows() const
+{
+	int32 NumRows = 0;
+	for (const FSpacetimeTableDelta& Delta : Tables)
+	{
+		NumRows += Delta.Inserts.Num();
+	}
+	return NumRows;
+}
@@ -0,0 +1,326 @@
+#include "Cache/SpacetimeClientCache.h"
+
+#include "Algo/StableSort.h"
+#include "SpacetimeStats.h"
+
+TRACE_DECLARE_INT_COUNTER(SpacetimeDispatchBacklog, TEXT("SpacetimeDB/Dispatch Backlog"));
+TRACE_DECLARE_INT_COUNTER(SpacetimeCachedRows, TEXT("SpacetimeDB/Cached Rows"));
+TRACE_DECLARE_MEMORY_COUNTER(SpacetimeCacheMemory, TEXT("SpacetimeDB/Cache Memory"));
+
+FSpacetimeClientCache::~FSpacetimeClientCache()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+}
+
+void FSpacetimeClientCache::RegisterTable(const TSharedRef<ISpacetimeTableCache>& Table, const int32 Priority)
+{
+	check(IsInGameThread());
+
+	if (!TickHandle.IsValid())
+	{
+		// Registered here rather than in the constructor, where AsShared is not available yet
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateSP(this, &FSpacetimeClientCache::Tick));
+	}
+
+	FScopeLock Lock(&StagingLock);
+	if (const TSharedRef<ISpacetimeTableCache>* Replaced = Tables.Find(Table->GetTableName()))
+	{
+		PublishOrder.RemoveAll([Replaced](const TPair<int32, TSharedRef<ISpacetimeTableCache>>& Entry)
+		{
+			return Entry.Value == *Replaced;
+		});
+	}
+	Tables.Add(Table->GetTableName(), Table);
+	PublishOrder.Emplace(Priority, Table);
+	Algo::StableSortBy(PublishOrder, [](const TPair<int32, TSharedRef<ISpacetimeTableCache>>& Entry)
+	{
+		return -Entry.Key;
+	});
+}
+
+TSharedPtr<ISpacetimeTableCache> FSpacetimeClientCache::FindTable(const FString& TableName) const
+{
+	FScopeLock Lock(&StagingLock);
+	if (const TSharedRef<ISpacetimeTableCache>* Table = Tables.Find(TableName))
+	{
+		return *Table;
+	}
+	return nullptr;
+}
+
+/** Transactions queued for decoding before TryEnqueueTransaction refuses more. */
+static constexpr int32 DecodeQueueCapacity = 64;
+
+void FSpacetimeClientCache::EnqueueTransaction(FSpacetimeTransactionUpdate&& Update)
+{
+	GetDecodeStage().Push(MoveTemp(Update));
+}
+
+bool FSpacetimeClientCache::TryEnqueueTransaction(FSpacetimeTransactionUpdate& Update)
+{
+	return GetDecodeStage().TryPush(Update);
+}
+
+FSpacetimeClientCache::FDecodeStage& FSpacetimeClientCache::GetDecodeStage()
+{
+	FScopeLock Lock(&StagingLock);
+	if (!DecodeStage.IsValid())
+	{
+		// The stage holds the cache weakly; its task keeps it alive while a transaction is decoded
+		DecodeStage = MakeShared<FDecodeStage, ESPMode::ThreadSafe>(TEXT("Stage"), DecodeQueueCapacity,
+			[WeakThis = TWeakPtr<FSpacetimeClientCache>(AsShared())](FSpacetimeTransactionUpdate& Update)
+			{
+				const TSharedPtr<FSpacetimeClientCache> This = WeakThis.Pin();
+				return !This.IsValid() || This->TryDecodeAndStage(Update);
+			});
+		DecodeStage->OnRoom = [WeakThis = TWeakPtr<FSpacetimeClientCache>(AsShared())]
+		{
+			const TSharedPtr<FSpacetimeClientCache> This = WeakThis.Pin();
+			if (This.IsValid() && This->OnRoom)
+			{
+				This->OnRoom();
+			}
+		};
+	}
+	return *DecodeStage;
+}
+
+bool FSpacetimeClientCache::TryDecodeAndStage(const FSpacetimeTransactionUpdate& Update)
+{
+	// Resumed by the tick once publishing brought the backlog down
+	const int32 Limit = MaxBacklog.load();
+	if (Limit > 0 && GetBacklog() > Limit)
+	{
+		return false;
+	}
+
+	DecodeAndStage(Update);
+	return true;
+}
+
+void FSpacetimeClientCache::DecodeAndStage(const FSpacetimeTransactionUpdate& Update)
+{
+	SPACETIME_SCOPED_TIMING(DecodeRows);
+
+	// A predicted table the answer does not touch still gets an empty change, which rolls its prediction back
+	static const FSpacetimeTableDelta NoChanges;
+
+	TArray<TPair<TSharedRef<ISpacetimeTableCache>, const FSpacetimeTableDelta*>> Targets;
+	TArray<TSharedRef<ISpacetimeTableCache>> Predicted;
+	{
+		FScopeLock Lock(&StagingLock);
+		for (const FSpacetimeTableDelta& Delta : Update.Tables)
+		{
+			if (const TSharedRef<ISpacetimeTableCache>* Table = Tables.Find(Delta.TableName))
+			{
+				Targets.Emplace(*Table, &Delta);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Ignoring update for unregistered table '%s'"), *Delta.TableName);
+			}
+		}
+
+		if (Update.RequestId != 0 && PredictedTables.RemoveAndCopyValue(Update.RequestId, Predicted))
+		{
+			for (const TSharedRef<ISpacetimeTableCache>& Table : Predicted)
+			{
+				if (!Targets.ContainsByPredicate([&Table](const auto& Target) { return Target.Key == Table; }))
+				{
+					Targets.Emplace(Table, &NoChanges);
+				}
+			}
+		}
+	}
+
+	// Decoding is the expensive part and runs unlocked
+	TArray<TPair<TSharedRef<ISpacetimeTableCache>, TUniquePtr<FSpacetimeStagedChanges>>> Decoded;
+	Decoded.Reserve(Targets.Num());
+	for (const auto& [Table, Delta] : Targets)
+	{
+		FString Error;
+		TUniquePtr<FSpacetimeStagedChanges> Changes = Table->DecodeDelta(*Delta, Error);
+		if (!Changes.IsValid())
+		{
+			// Half a transaction would leave the tables disagreeing with each other; none of it is applied
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] %s; dropping the transaction"), *Error);
+			break;
+		}
+		Changes->RequestId = Update.RequestId;
+		Decoded.Emplace(Table, MoveTemp(Changes));
+	}
+
+	// The predictions are already forgotten, so a dropped transaction still has to roll them back
+	if (Decoded.Num() < Targets.Num())
+	{
+		Decoded.Reset();
+		for (const TSharedRef<ISpacetimeTableCache>& Table : Predicted)
+		{
+			FString Error;
+			if (TUniquePtr<FSpacetimeStagedChanges> Changes = Table->DecodeDelta(NoChanges, Error))
+			{
+				Changes->RequestId = Update.RequestId;
+				Decoded.Emplace(Table, MoveTemp(Changes));
+			}
+		}
+	}
+
+	FScopeLock Lock(&StagingLock);
+	for (auto& [Table, Changes] : Decoded)
+	{
+		Table->Stage(MoveTemp(Changes));
+	}
+}
+
+void FSpacetimeClientCache::PublishStagedChanges()
+{
+	check(IsInGameThread());
+
+	TArray<TSharedRef<ISpacetimeTableCache>> Ready;
+	{
+		FScopeLock Lock(&StagingLock);
+		for (const auto& [Priority, Table] : PublishOrder)
+		{
+			if (Table->SwapStaged())
+			{
+				Ready.Add(Table);
+			}
+		}
+	}
+
+	{
+		SPACETIME_SCOPED_TIMING(Dispatch);
+
+		const double Deadline = FrameBudgetMs > 0.0
+			? FPlatformTime::Seconds() + FrameBudgetMs / 1000.0
+			: TNumericLimits<double>::Max();
+		for (const TSharedRef<ISpacetimeTableCache>& Table : Ready)
+		{
+			// Lower priorities wait for the next frame once the budget is spent; every call applies some rows
+			if (!Table->Publish(Deadline))
+			{
+				break;
+			}
+		}
+	}
+
+	ReportStats();
+
+	// Decoding waits for the backlog to come down, and only the game thread brings it down
+	TSharedPtr<FDecodeStage, ESPMode::ThreadSafe> Stage;
+	{
+		FScopeLock Lock(&StagingLock);
+		Stage = DecodeStage;
+	}
+	if (Stage.IsValid() && Stage->IsBlocked())
+	{
+		Stage->Kick();
+	}
+}
+
+int32 FSpacetimeClientCache::GetBacklog() const
+{
+	FScopeLock Lock(&StagingLock);
+	int32 Backlog = 0;
+	for (const auto& [Name, Table] : Tables)
+	{
+		Backlog += Table->GetBacklog();
+	}
+	return Backlog;
+}
+
+void FSpacetimeClientCache::Predict(const uint32 RequestId, const TFunctionRef<void()> Predictor)
+{
+	check(IsInGameThread());
+
+	Predictor();
+
+	FScopeLock Lock(&StagingLock);
+	TArray<TSharedRef<ISpacetimeTableCache>> Predicted;
+	for (const auto& [Name, Table] : Tables)
+	{
+		if (Table->HasPrediction(RequestId))
+		{
+			Predicted.Add(Table);
+		}
+	}
+	if (!Predicted.IsEmpty())
+	{
+		PredictedTables.Add(RequestId, MoveTemp(Predicted));
+	}
+}
+
+void FSpacetimeClientCache::RollBackPredictions()
+{
+	check(IsInGameThread());
+
+	TArray<uint32> RequestIds;
+	{
+		FScopeLock Lock(&StagingLock);
+		PredictedTables.GetKeys(RequestIds);
+	}
+
+	// Queued like answers without changes, so they stay in order with transactions still being decoded
+	for (const uint32 RequestId : RequestIds)
+	{
+		FSpacetimeTransactionUpdate Update;
+		Update.RequestId = RequestId;
+		EnqueueTransaction(MoveTemp(Update));
+	}
+}
+
+void FSpacetimeClientCache::ForEachTable(const TFunctionRef<void(const ISpacetimeTableCache&)> Functor) const
+{
+	check(IsInGameThread());
+
+	FScopeLock Lock(&StagingLock);
+	for (const auto& [Name, Table] : Tables)
+	{
+		Functor(*Table);
+	}
+}
+
+void FSpacetimeClientCache::ReportStats() const
+{
+	[[maybe_unused]] const int32 Backlog = GetBacklog();
+	[[maybe_unused]] int32 Rows = 0;
+	[[maybe_unused]] SIZE_T Memory = 0;
+	{
+		FScopeLock Lock(&StagingLock);
+		for (const auto& [Name, Table] : Tables)
+		{
+			const int32 TableRows = Table->GetNumRows();
+			const SIZE_T TableMemory = Table->GetAllocatedSize();
+			Rows += TableRows;
+			Memory += TableMemory;
+
+#if CSV_PROFILER
+			// Per table only in CSV captures, which take stat names made at runtime
+			if (FCsvProfiler::Get()->IsCapturing())
+			{
+				FCsvProfiler::RecordCustomStat(FName(*(TEXT("Rows_") + Name)), CSV_CATEGORY_INDEX(SpacetimeDB), TableRows, ECsvCustomStatOp::Set);
+				FCsvProfiler::RecordCustomStat(FName(*(TEXT("MemoryKB_") + Name)), CSV_CATEGORY_INDEX(SpacetimeDB), static_cast<float>(TableMemory / 1024.0), ECsvCustomStatOp::Set);
+			}
+#endif
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SpacetimeDispatchBacklog, Backlog);
+	SET_DWORD_STAT(STAT_SpacetimeCachedRows, Rows);
+	SET_MEMORY_STAT(STAT_SpacetimeCacheMemory, Memory);
+
+	TRACE_COUNTER_SET(SpacetimeDispatchBacklog, Backlog);
+	TRACE_COUNTER_SET(SpacetimeCachedRows, Rows);
+	TRACE_COUNTER_SET(SpacetimeCacheMemory, static_cast<int64>(Memory));
+
+	CSV_CUSTOM_STAT(SpacetimeDB, DispatchBacklog, Backlog, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, CachedRows, Rows, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, CacheMemoryKB, static_cast<float>(Memory / 1024.0), ECsvCustomStatOp::Set);
+}
+
+bool FSpacetimeClientCache::Tick(float DeltaTime)
+{
+	PublishStagedChanges();
+	return true;
+}
@@ -0,0 +1,545 @@
+#include "Client/SpacetimeDBClient.h"
+
+#include "Async/Async.h"
+#include "Cache/SpacetimeCacheSnapshot.h"
+#include "Misc/CoreDelegates.h"
+#include "SpacetimeStats.h"
+
+/** Messages each receive stage holds before it stops the one before it. */
+static constexpr int32 ReceiveStageCapacity = 64;
+
+/** Seconds between samples of the rates, and covered by each round trip histogram. */
+static constexpr double MetricsSampleInterval = 1.0;
+static constexpr double RoundTripWindow = 10.0;
+
+TRACE_DECLARE_INT_COUNTER(SpacetimeBytesIn, TEXT("SpacetimeDB/Bytes In per Second"));
+TRACE_DECLARE_INT_COUNTER(SpacetimeBytesOut, TEXT("SpacetimeDB/Bytes Out per Second"));
+TRACE_DECLARE_INT_COUNTER(SpacetimeMessagesIn, TEXT("SpacetimeDB/Messages In per Second"));
+TRACE_DECLARE_INT_COUNTER(SpacetimeMessagesOut, TEXT("SpacetimeDB/Messages Out per Second"));
+TRACE_DECLARE_FLOAT_COUNTER(SpacetimeReducerRttP50, TEXT("SpacetimeDB/Reducer Round Trip p50 (ms)"));
+TRACE_DECLARE_FLOAT_COUNTER(SpacetimeReducerRttP99, TEXT("SpacetimeDB/Reducer Round Trip p99 (ms)"));
+TRACE_DECLARE_INT_COUNTER(SpacetimeReceiveBacklog, TEXT("SpacetimeDB/Receive Backlog"));
+
+FSpacetimeDBClient::FSpacetimeDBClient(TSharedRef<ISpacetimeTransport> InTransport, TSharedRef<FSpacetimeClientCache> InCache)
+	: Transport(MoveTemp(InTransport))
+	, Cache(MoveTemp(InCache))
+{
+}
+
+FSpacetimeDBClient::~FSpacetimeDBClient()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	Transport->OnConnected.Unbind();
+	Transport->OnConnectionError.Unbind();
+	Transport->OnClosed.Unbind();
+	Transport->OnMessage.Unbind();
+	Transport->Close();
+}
+
+FString FSpacetimeDBClient::MakeSubscribeUrl(const FSpacetimeConnectionParams& Params)
+{
+	FString Host = Params.Host;
+	bool bUseSsl = Params.bUseSsl;
+	if (Host.RemoveFromStart(TEXT("https://")))
+	{
+		bUseSsl = true;
+	}
+	Host.RemoveFromStart(TEXT("http://"));
+	Host.RemoveFromEnd(TEXT("/"));
+
+	ESpacetimeCompression Compression = Params.Compression;
+	if (Compression == ESpacetimeCompression::Brotli)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Brotli is not supported, requesting gzip compression instead"));
+		Compression = ESpacetimeCompression::Gzip;
+	}
+
+	return FString::Printf(TEXT("%s://%s/v1/database/%s/subscribe?compression=%s"),
+		bUseSsl ? TEXT("wss") : TEXT("ws"), *Host, *Params.DatabaseName, LexToString(Compression));
+}
+
+void FSpacetimeDBClient::Connect(const FSpacetimeConnectionParams& Params)
+{
+	check(IsInGameThread());
+
+	NegotiatedCompression = static_cast<uint8>(Params.Compression == ESpacetimeCompression::None
+		? ESpacetimeCompression::None
+		: ESpacetimeCompression::Gzip);
+	Messages = 0;
+	CompressedMessages = 0;
+	ReceivedBytes = 0;
+	DecompressedBytes = 0;
+	DecodeCycles = 0;
+	DecodedMessages = 0;
+	SentBytes = 0;
+	SentMessages = 0;
+	LastSample = {};
+	LastSample.Time = FPlatformTime::Seconds();
+	Metrics = {};
+
+	Transport->OnConnected.BindSPLambda(this, [this]
+	{
+		RunOnGameThread([](FSpacetimeDBClient& Client) { Client.OnConnected.Broadcast(); });
+	});
+	// Calls in flight are never answered on another connection, so their predictions are rolled back
+	Transport->OnConnectionError.BindSPLambda(this, [this](const FString& Error)
+	{
+		RunOnGameThread([Error](FSpacetimeDBClient& Client)
+		{
+			Client.Cache->RollBackPredictions();
+			Client.CallStartTimes.Empty();
+			Client.OnDisconnected.Broadcast(Error);
+		});
+	});
+	Transport->OnClosed.BindSPLambda(this, [this](const int32 StatusCode, const FString& Reason)
+	{
+		RunOnGameThread([Reason](FSpacetimeDBClient& Client)
+		{
+			Client.Cache->RollBackPredictions();
+			Client.CallStartTimes.Empty();
+			Client.OnDisconnected.Broadcast(Reason);
+		});
+	});
+	Transport->OnMessage.BindSP(this, &FSpacetimeDBClient::HandleFrame);
+	CreatePipeline();
+	if (!EndFrameHandle.IsValid())
+	{
+		// After the frame's gameplay, so messages queued during the frame still leave within it
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddSP(this, &FSpacetimeDBClient::HandleEndFrame);
+	}
+
+	// Rows from the last session, readable while the subscriptions are on their way
+	if (Params.bLoadCacheSnapshot && !LoadedSnapshot.IsValid() && Cache->GetBacklog() == 0)
+	{
+		int32 NumCachedRows = 0;
+		Cache->ForEachTable([&NumCachedRows](const ISpacetimeTableCache& Table) { NumCachedRows += Table.GetNumRows(); });
+		if (NumCachedRows == 0)
+		{
+			FString Error;
+			LoadedSnapshot = FSpacetimeCacheSnapshot::Load(
+				FSpacetimeCacheSnapshot::GetDefaultPath(Params.DatabaseName), Params.SchemaFingerprint, Cache, Error);
+			if (!LoadedSnapshot.IsValid())
+			{
+				UE_LOG(LogTemp, Log, TEXT("[spacetime] %s"), *Error);
+			}
+		}
+	}
+
+	TMap<FString, FString> Headers;
+	if (!Params.Token.IsEmpty())
+	{
+		Headers.Add(TEXT("Authorization"), TEXT("Bearer ") + Params.Token);
+	}
+
+	const FString Url = MakeSubscribeUrl(Params);
+	UE_LOG(LogTemp, Log, TEXT("[spacetime] Connecting to %s"), *Url);
+	Transport->Connect(Url, SPACETIMEDB_WS_PROTOCOL, Headers);
+}
+
+void FSpacetimeDBClient::Disconnect()
+{
+	FlushSends();
+	Transport->Close();
+}
+
+bool FSpacetimeDBClient::IsConnected() const
+{
+	return Transport->IsConnected();
+}
+
+void FSpacetimeDBClient::Send(TArray<uint8>&& Message)
+{
+	Outgoing.Push(MoveTemp(Message));
+}
+
+void FSpacetimeDBClient::FlushSends()
+{
+	check(IsInGameThread());
+	SPACETIME_SCOPED_TIMING(Send);
+
+	TArray<uint8> Message;
+	while (Outgoing.Dequeue(Message))
+	{
+		SentBytes += Message.Num();
+		++SentMessages;
+		Transport->Send(MoveTemp(Message));
+	}
+}
+
+void FSpacetimeDBClient::HandleEndFrame()
+{
+	FlushSends();
+	UpdateMetrics();
+}
+
+void FSpacetimeDBClient::CompleteCall(const uint32 RequestId)
+{
+	double StartTime;
+	if (CallStartTimes.RemoveAndCopyValue(RequestId, StartTime))
+	{
+		RoundTrips.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+}
+
+void FSpacetimeDBClient::UpdateMetrics()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - LastSample.Time;
+	if (Elapsed >= MetricsSampleInterval)
+	{
+		FMetricsSample Sample;
+		Sample.Time = Now;
+		Sample.ReceivedBytes = ReceivedBytes;
+		Sample.Messages = Messages;
+		Sample.SentBytes = SentBytes;
+		Sample.SentMessages = SentMessages;
+		Sample.DecodeCycles = DecodeCycles;
+		Sample.DecodedMessages = DecodedMessages;
+
+		Metrics.BytesInPerSecond = (Sample.ReceivedBytes - LastSample.ReceivedBytes) / Elapsed;
+		Metrics.MessagesInPerSecond = (Sample.Messages - LastSample.Messages) / Elapsed;
+		Metrics.BytesOutPerSecond = (Sample.SentBytes - LastSample.SentBytes) / Elapsed;
+		Metrics.MessagesOutPerSecond = (Sample.SentMessages - LastSample.SentMessages) / Elapsed;
+		const uint64 Decoded = Sample.DecodedMessages - LastSample.DecodedMessages;
+		Metrics.DecodeMicrosecondsPerMessage = Decoded > 0
+			? FPlatformTime::ToSeconds64(Sample.DecodeCycles - LastSample.DecodeCycles) * 1e6 / Decoded
+			: 0.0;
+
+		// Percentiles over one to two windows, so they neither jump on every sample nor remember old spikes for long
+		if (Now - RoundTripWindowStart >= RoundTripWindow)
+		{
+			PreviousRoundTrips = RoundTrips;
+			RoundTrips.Reset();
+			RoundTripWindowStart = Now;
+		}
+		FSpacetimeLatencyHistogram Recent = PreviousRoundTrips;
+		Recent.Merge(RoundTrips);
+		Metrics.ReducerRttP50Ms = Recent.GetPercentile(0.5);
+		Metrics.ReducerRttP99Ms = Recent.GetPercentile(0.99);
+
+		LastSample = Sample;
+	}
+	Metrics.ReducerCallsInFlight = CallStartTimes.Num();
+
+	[[maybe_unused]] const int32 ReceiveBacklog = GetReceiveBacklog();
+	[[maybe_unused]] const int32 SendQueue = Outgoing.Num();
+
+	// Counter stats and CSV custom stats only hold per frame, so the latest sample is reported on every one
+	SET_DWORD_STAT(STAT_SpacetimeBytesIn, static_cast<uint32>(Metrics.BytesInPerSecond));
+	SET_DWORD_STAT(STAT_SpacetimeBytesOut, static_cast<uint32>(Metrics.BytesOutPerSecond));
+	SET_DWORD_STAT(STAT_SpacetimeMessagesIn, static_cast<uint32>(Metrics.MessagesInPerSecond));
+	SET_DWORD_STAT(STAT_SpacetimeMessagesOut, static_cast<uint32>(Metrics.MessagesOutPerSecond));
+	SET_FLOAT_STAT(STAT_SpacetimeDecodeTimePerMessage, Metrics.DecodeMicrosecondsPerMessage);
+	SET_FLOAT_STAT(STAT_SpacetimeReducerRttP50, Metrics.ReducerRttP50Ms);
+	SET_FLOAT_STAT(STAT_SpacetimeReducerRttP99, Metrics.ReducerRttP99Ms);
+	SET_DWORD_STAT(STAT_SpacetimeReducerCallsInFlight, Metrics.ReducerCallsInFlight);
+	SET_DWORD_STAT(STAT_SpacetimeReceiveBacklog, ReceiveBacklog);
+	SET_DWORD_STAT(STAT_SpacetimeSendQueue, SendQueue);
+
+	TRACE_COUNTER_SET(SpacetimeBytesIn, static_cast<int64>(Metrics.BytesInPerSecond));
+	TRACE_COUNTER_SET(SpacetimeBytesOut, static_cast<int64>(Metrics.BytesOutPerSecond));
+	TRACE_COUNTER_SET(SpacetimeMessagesIn, static_cast<int64>(Metrics.MessagesInPerSecond));
+	TRACE_COUNTER_SET(SpacetimeMessagesOut, static_cast<int64>(Metrics.MessagesOutPerSecond));
+	TRACE_COUNTER_SET(SpacetimeReducerRttP50, Metrics.ReducerRttP50Ms);
+	TRACE_COUNTER_SET(SpacetimeReducerRttP99, Metrics.ReducerRttP99Ms);
+	TRACE_COUNTER_SET(SpacetimeReceiveBacklog, ReceiveBacklog);
+
+	CSV_CUSTOM_STAT(SpacetimeDB, BytesInPerSecond, static_cast<float>(Metrics.BytesInPerSecond), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, BytesOutPerSecond, static_cast<float>(Metrics.BytesOutPerSecond), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, MessagesInPerSecond, static_cast<float>(Metrics.MessagesInPerSecond), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, MessagesOutPerSecond, static_cast<float>(Metrics.MessagesOutPerSecond), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, DecodeMicrosecondsPerMessage, static_cast<float>(Metrics.DecodeMicrosecondsPerMessage), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, ReducerRttP50Ms, static_cast<float>(Metrics.ReducerRttP50Ms), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, ReducerRttP99Ms, static_cast<float>(Metrics.ReducerRttP99Ms), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, ReceiveBacklog, ReceiveBacklog, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SpacetimeDB, SendQueue, SendQueue, ECsvCustomStatOp::Set);
+}
+
+uint32 FSpacetimeDBClient::CallReducer(const FString& ReducerName, const TConstArrayView<uint8> Args)
+{
+	const uint32 RequestId = NextRequestId();
+	if (const FReducerPredictor* Predictor = Predictors.Find(ReducerName))
+	{
+		// Before sending, so the answer cannot overtake its prediction
+		Cache->Predict(RequestId, [Predictor, RequestId, Args] { (*Predictor)(RequestId, Args); });
+	}
+	Send(FSpacetimeProtocol::EncodeCallReducer(ReducerName, Args, RequestId));
+	CallStartTimes.Add(RequestId, FPlatformTime::Seconds());
+	return RequestId;
+}
+
+void FSpacetimeDBClient::SetReducerPredictor(const FString& ReducerName, FReducerPredictor Predictor)
+{
+	check(IsInGameThread());
+	if (Predictor)
+	{
+		Predictors.Add(ReducerName, MoveTemp(Predictor));
+	}
+	else
+	{
+		Predictors.Remove(ReducerName);
+	}
+}
+
+void FSpacetimeDBClient::CreatePipeline()
+{
+	if (DecompressStage.IsValid())
+	{
+		return;
+	}
+
+	// Stages only hold the client weakly, and keep it alive while they work on a message
+	const TWeakPtr<FSpacetimeDBClient> WeakThis = AsShared();
+	auto Bind = [WeakThis](bool (FSpacetimeDBClient::*Process)(FInboundMessage&))
+	{
+		return [WeakThis, Process](FInboundMessage& Message)
+		{
+			const TSharedPtr<FSpacetimeDBClient> This = WeakThis.Pin();
+			return !This.IsValid() || (This.Get()->*Process)(Message);
+		};
+	};
+
+	DecompressStage = MakeShared<FReceiveStage, ESPMode::ThreadSafe>(TEXT("Decompress"), ReceiveStageCapacity, Bind(&FSpacetimeDBClient::Decompress));
+	DecodeStage = MakeShared<FReceiveStage, ESPMode::ThreadSafe>(TEXT("Decode"), ReceiveStageCapacity, Bind(&FSpacetimeDBClient::Decode));
+
+	// Each stage resumes the one before it once it has room again
+	DecodeStage->OnRoom = [WeakStage = TWeakPtr<FReceiveStage, ESPMode::ThreadSafe>(DecompressStage)]
+	{
+		if (const auto Stage = WeakStage.Pin())
+		{
+			Stage->Kick();
+		}
+	};
+	Cache->OnRoom = [WeakStage = TWeakPtr<FReceiveStage, ESPMode::ThreadSafe>(DecodeStage)]
+	{
+		if (const auto Stage = WeakStage.Pin())
+		{
+			Stage->Kick();
+		}
+	};
+}
+
+FSpacetimeCompressionStats FSpacetimeDBClient::GetCompressionStats() const
+{
+	FSpacetimeCompressionStats Stats;
+	Stats.Negotiated = static_cast<ESpacetimeCompression>(NegotiatedCompression.load());
+	Stats.Messages = Messages;
+	Stats.CompressedMessages = CompressedMessages;
+	Stats.ReceivedBytes = ReceivedBytes;
+	Stats.DecompressedBytes = DecompressedBytes;
+	return Stats;
+}
+
+int32 FSpacetimeDBClient::GetReceiveBacklog() const
+{
+	return DecompressStage.IsValid() ? DecompressStage->Num() + DecodeStage->Num() : 0;
+}
+
+FSpacetimeRingStats FSpacetimeDBClient::GetDecompressQueueStats() const
+{
+	return DecompressStage.IsValid() ? DecompressStage->GetStats() : FSpacetimeRingStats();
+}
+
+FSpacetimeRingStats FSpacetimeDBClient::GetDecodeQueueStats() const
+{
+	return DecodeStage.IsValid() ? DecodeStage->GetStats() : FSpacetimeRingStats();
+}
+
+void FSpacetimeDBClient::HandleFrame(TArray<uint8>&& Frame)
+{
+	// Never decompress on the socket's thread, which is usually the game thread; a socket cannot
+	// wait either, so the first stage takes every frame
+	FInboundMessage Message;
+	Message.Bytes = MoveTemp(Frame);
+	DecompressStage->Push(MoveTemp(Message));
+}
+
+bool FSpacetimeDBClient::Decompress(FInboundMessage& Message)
+{
+	if (Message.MessageOffset == INDEX_NONE)
+	{
+		SPACETIME_SCOPED_TIMING(Decompress);
+
+		FString Error;
+		TConstArrayView<uint8> Payload;
+		ESpacetimeCompression Compression;
+		TArray<uint8> Buffer;
+		if (SpareBuffers.Dequeue(Buffer))
+		{
+			--NumSpareBuffers;
+		}
+		if (!FSpacetimeDecompressor::DecompressServerMessage(Message.Bytes, Buffer, Payload, Compression, Error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Dropping server message: %s"), *Error);
+			return true;
+		}
+
+		++Messages;
+		ReceivedBytes += Message.Bytes.Num();
+		DecompressedBytes += Payload.Num() + 1;		// counting the tag, so uncompressed messages have a ratio of 1
+		if (Compression != ESpacetimeCompression::None)
+		{
+			// The message now owns the spare buffer; the compressed frame is released with Buffer
+			++CompressedMessages;
+			Swap(Message.Bytes, Buffer);
+			Message.MessageOffset = 0;
+			Message.bSpareBuffer = true;
+		}
+		else
+		{
+			// The frame is the message; the spare was not needed
+			Message.MessageOffset = 1;
+			RecycleBuffer(MoveTemp(Buffer));
+		}
+	}
+
+	return DecodeStage->TryPush(Message);
+}
+
+bool FSpacetimeDBClient::Decode(FInboundMessage& Message)
+{
+	if (!Message.Decoded.IsSet())
+	{
+		SPACETIME_SCOPED_TIMING(Decode);
+
+		FString Error;
+		FSpacetimeServerMessage& Decoded = Message.Decoded.Emplace();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const bool bDecoded = FSpacetimeProtocol::DecodeServerMessage(TConstArrayView<uint8>(Message.Bytes).RightChop(Message.MessageOffset), Decoded, QueryUpdateBuffer, Error);
+		DecodeCycles += FPlatformTime::Cycles64() - StartCycles;
+		++DecodedMessages;
+		if (!bDecoded)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Dropping server message: %s"), *Error);
+			return true;
+		}
+
+		// Rows were copied out into pages, so the buffer can take another message; frames from the
+		// transport are released instead, or every message would add one to the pool
+		if (Message.bSpareBuffer)
+		{
+			Message.bSpareBuffer = false;
+			RecycleBuffer(MoveTemp(Message.Bytes));
+		}
+		Message.Bytes.Empty();
+	}
+
+	return Dispatch(Message.Decoded.GetValue());
+}
+
+void FSpacetimeDBClient::RecycleBuffer(TArray<uint8>&& Buffer)
+{
+	if (Buffer.GetAllocatedSize() == 0 || Buffer.GetAllocatedSize() > MaxSpareBufferBytes)
+	{
+		return;
+	}
+	// Reserving a slot first keeps concurrent producers from overshooting the cap
+	if (++NumSpareBuffers > MaxSpareBuffers)
+	{
+		--NumSpareBuffers;
+		return;
+	}
+	Buffer.Reset();
+	SpareBuffers.Enqueue(MoveTemp(Buffer));
+}
+
+bool FSpacetimeDBClient::Dispatch(FSpacetimeServerMessage& Message)
+{
+	if (Message.Type == ESpacetimeServerMessage::IdentityToken)
+	{
+		WorkerConnectionId = Message.ConnectionId;
+	}
+	if (Message.Type == ESpacetimeServerMessage::TransactionUpdate && Message.ConnectionId == WorkerConnectionId)
+	{
+		// Tags the answer for reconciling the call's prediction, if any; a failed call rolls it back
+		Message.Update.RequestId = Message.RequestId;
+	}
+
+	// The only step that can be refused, so it goes first and a retry repeats nothing
+	if ((!Message.Update.Tables.IsEmpty() || Message.Update.RequestId != 0) && !Cache->TryEnqueueTransaction(Message.Update))
+	{
+		return false;
+	}
+
+	Notify(MoveTemp(Message));
+	return true;
+}
+
+void FSpacetimeDBClient::Notify(FSpacetimeServerMessage&& Message)
+{
+	switch (Message.Type)
+	{
+	case ESpacetimeServerMessage::IdentityToken:
+		RunOnGameThread([Identity = MoveTemp(Message.Identity), Token = MoveTemp(Message.Token), ConnectionId = MoveTemp(Message.ConnectionId)]
+			(FSpacetimeDBClient& Client)
+		{
+			Client.Identity = Identity;
+			Client.ConnectionId = ConnectionId;
+			Client.OnIdentityReceived.Broadcast(Identity, Token, ConnectionId);
+		});
+		return;
+
+	case ESpacetimeServerMessage::TransactionUpdate:
+		if (Message.Status != ESpacetimeUpdateStatus::Committed)
+		{
+			if (Message.Status == ESpacetimeUpdateStatus::OutOfEnergy)
+			{
+				Message.Error = TEXT("Out of energy");
+			}
+			RunOnGameThread([ReducerName = MoveTemp(Message.ReducerName), RequestId = Message.RequestId, Error = MoveTemp(Message.Error)]
+				(FSpacetimeDBClient& Client)
+			{
+				Client.CompleteCall(RequestId);
+				Client.OnReducerFailed.Broadcast(ReducerName, RequestId, Error);
+			});
+			return;
+		}
+
+		// Every subscriber gets the transactions of other clients too; only our own calls are acknowledged
+		RunOnGameThread([ReducerName = MoveTemp(Message.ReducerName), RequestId = Message.RequestId, CallerId = MoveTemp(Message.ConnectionId)]
+			(FSpacetimeDBClient& Client)
+		{
+			if (CallerId == Client.ConnectionId)
+			{
+				Client.CompleteCall(RequestId);
+				Client.OnReducerCommitted.Broadcast(ReducerName, RequestId);
+			}
+		});
+		break;
+
+	case ESpacetimeServerMessage::SubscriptionError:
+		RunOnGameThread([QueryId = Message.QueryId, Error = MoveTemp(Message.Error)](FSpacetimeDBClient& Client)
+		{
+			Client.OnSubscriptionError.Broadcast(QueryId, Error);
+		});
+		return;
+
+	case ESpacetimeServerMessage::SubscribeMultiApplied:
+		RunOnGameThread([QueryId = Message.QueryId](FSpacetimeDBClient& Client)
+		{
+			Client.OnSubscriptionApplied.Broadcast(QueryId);
+		});
+		break;
+
+	case ESpacetimeServerMessage::UnsubscribeMultiApplied:
+		RunOnGameThread([QueryId = Message.QueryId](FSpacetimeDBClient& Client)
+		{
+			Client.OnUnsubscriptionApplied.Broadcast(QueryId);
+		});
+		break;
+
+	default:
+		break;
+	}
+}
+
+void FSpacetimeDBClient::RunOnGameThread(TUniqueFunction<void(FSpacetimeDBClient&)>&& Function)
+{
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakPtr<FSpacetimeDBClient>(AsShared()), Function = MoveTemp(Function)]
+	{
+		if (const TSharedPtr<FSpacetimeDBClient> This = WeakThis.Pin())
+		{
+			Function(*This);
+		}
+	});
+}
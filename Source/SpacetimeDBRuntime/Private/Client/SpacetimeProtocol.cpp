@@ -0,0 +1,334 @@
+#include "Client/SpacetimeProtocol.h"
+
+#include "Codec/SpacetimeBsatnReader.h"
+#include "Codec/SpacetimeBsatnWriter.h"
+#include "Codec/SpacetimeCompression.h"
+
+static constexpr int32 IdentityBytes = 32;
+static constexpr int32 ConnectionIdBytes = 16;
+
+TArray<uint8> FSpacetimeProtocol::EncodeSubscribeMulti(const TArray<FString>& Queries, const uint32 RequestId, const uint32 QueryId)
+{
+	TArray<uint8> Message;
+	FSpacetimeBsatnWriter Writer(Message);
+	Writer.WriteTag(static_cast<uint8>(ESpacetimeClientMessage::SubscribeMulti));
+	Writer.WriteLength(Queries.Num());
+	for (const FString& Query : Queries)
+	{
+		Writer.WriteString(Query);
+	}
+	Writer.WriteScalar(RequestId);
+	Writer.WriteScalar(QueryId);
+	return Message;
+}
+
+TArray<uint8> FSpacetimeProtocol::EncodeUnsubscribeMulti(const uint32 RequestId, const uint32 QueryId)
+{
+	TArray<uint8> Message;
+	FSpacetimeBsatnWriter Writer(Message);
+	Writer.WriteTag(static_cast<uint8>(ESpacetimeClientMessage::UnsubscribeMulti));
+	Writer.WriteScalar(RequestId);
+	Writer.WriteScalar(QueryId);
+	return Message;
+}
+
+TArray<uint8> FSpacetimeProtocol::EncodeCallReducer(const FString& ReducerName, const TConstArrayView<uint8> Args, const uint32 RequestId)
+{
+	// CallReducer flags: 0 = FullUpdate, so the caller is always told how its call ended
+	constexpr uint8 FullUpdate = 0;
+
+	TArray<uint8> Message;
+	FSpacetimeBsatnWriter Writer(Message);
+	Writer.WriteTag(static_cast<uint8>(ESpacetimeClientMessage::CallReducer));
+	Writer.WriteString(ReducerName);
+	Writer.WriteBytes(Args);
+	Writer.WriteScalar(RequestId);
+	Writer.WriteScalar(FullUpdate);
+	return Message;
+}
+
+// Reads an Option<u32>, leaving Out untouched when it is None
+static bool ReadOptionalU32(FSpacetimeBsatnReader& Reader, uint32& Out)
+{
+	uint8 Tag;
+	if (!Reader.ReadTag(Tag))
+	{
+		return false;
+	}
+	switch (Tag)
+	{
+	case 0:  return Reader.ReadScalar(Out);
+	case 1:  return true;
+	default: return Reader.Fail();
+	}
+}
+
+bool FSpacetimeProtocol::ReadRowList(FSpacetimeBsatnReader& Reader, TArray<FSpacetimeRowRef>& OutRows)
+{
+	uint8 SizeHint;
+	if (!Reader.ReadTag(SizeHint))
+	{
+		return false;
+	}
+
+	// FixedSize(u16): every row has the same size; RowOffsets(Vec<u64>): start of each row
+	uint16 FixedSize = 0;
+	TArray<uint64> Offsets;
+	if (SizeHint == 0)
+	{
+		if (!Reader.ReadScalar(FixedSize))
+		{
+			return false;
+		}
+	}
+	else if (SizeHint == 1)
+	{
+		uint32 NumOffsets;
+		if (!Reader.ReadLength(NumOffsets) || NumOffsets > static_cast<uint32>(Reader.GetRemaining() / sizeof(uint64)))
+		{
+			return Reader.Fail();
+		}
+		Offsets.SetNumUninitialized(NumOffsets);
+		for (uint64& Offset : Offsets)
+		{
+			if (!Reader.ReadScalar(Offset))
+			{
+				return false;
+			}
+		}
+	}
+	else
+	{
+		return Reader.Fail();
+	}
+
+	TConstArrayView<uint8> RowsData;
+	if (!Reader.ReadBytesView(RowsData))
+	{
+		return false;
+	}
+	if (RowsData.IsEmpty() && Offsets.IsEmpty())
+	{
+		return true;
+	}
+
+	// One copy per row list, out of the reusable message buffer; rows refer into it from then on
+	const FSpacetimeBsatnPagePtr Page = MakeShared<const FSpacetimeBsatnPage, ESPMode::ThreadSafe>(TArray<uint8>(RowsData));
+
+	if (SizeHint == 0)
+	{
+		if (FixedSize == 0 || RowsData.Num() % FixedSize != 0)
+		{
+			return Reader.Fail();
+		}
+		OutRows.Reserve(OutRows.Num() + RowsData.Num() / FixedSize);
+		for (int32 Start = 0; Start < RowsData.Num(); Start += FixedSize)
+		{
+			OutRows.Add({Page, Start, FixedSize});
+		}
+		return true;
+	}
+
+	OutRows.Reserve(OutRows.Num() + Offsets.Num());
+	for (int32 i = 0; i < Offsets.Num(); ++i)
+	{
+		const uint64 Start = Offsets[i];
+		const uint64 End = i + 1 < Offsets.Num() ? Offsets[i + 1] : RowsData.Num();
+		if (Start > End || End > static_cast<uint64>(RowsData.Num()))
+		{
+			return Reader.Fail();
+		}
+		OutRows.Add({Page, static_cast<int32>(Start), static_cast<int32>(End - Start)});
+	}
+	return true;
+}
+
+bool FSpacetimeProtocol::ReadQueryUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTableDelta& OutDelta)
+{
+	return ReadRowList(Reader, OutDelta.Deletes)
+		&& ReadRowList(Reader, OutDelta.Inserts);
+}
+
+bool FSpacetimeProtocol::ReadTableUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTableDelta& OutDelta, TArray<uint8>& Scratch)
+{
+	// table_id, table_name, num_rows and one or more query updates, each possibly compressed
+	uint32 TableId;
+	uint64 NumRows;
+	uint32 NumUpdates;
+	if (!Reader.ReadScalar(TableId)
+		|| !Reader.ReadString(OutDelta.TableName)
+		|| !Reader.ReadScalar(NumRows)
+		|| !Reader.ReadLength(NumUpdates))
+	{
+		return false;
+	}
+
+	for (uint32 i = 0; i < NumUpdates; ++i)
+	{
+		uint8 Compression;
+		if (!Reader.ReadTag(Compression))
+		{
+			return false;
+		}
+		if (Compression == static_cast<uint8>(ESpacetimeCompression::None))
+		{
+			if (!ReadQueryUpdate(Reader, OutDelta))
+			{
+				return false;
+			}
+			continue;
+		}
+
+		TConstArrayView<uint8> Compressed;
+		FString Error;
+		if (!Reader.ReadBytesView(Compressed)
+			|| !FSpacetimeDecompressor::Decompress(static_cast<ESpacetimeCompression>(Compression), Compressed, Scratch, Error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[spacetime] Query update of table '%s': %s"), *OutDelta.TableName, *Error);
+			return Reader.Fail();
+		}
+
+		// Rows are copied out, so Scratch can be reused by the next query update
+		FSpacetimeBsatnReader Inner(Scratch);
+		if (!ReadQueryUpdate(Inner, OutDelta) || !Inner.IsAtEnd())
+		{
+			return Reader.Fail();
+		}
+	}
+	return true;
+}
+
+bool FSpacetimeProtocol::ReadDatabaseUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTransactionUpdate& OutUpdate, TArray<uint8>& Scratch)
+{
+	uint32 NumTables;
+	if (!Reader.ReadLength(NumTables))
+	{
+		return false;
+	}
+
+	OutUpdate.Tables.Reserve(FMath::Min<uint32>(NumTables, Reader.GetRemaining()));
+	for (uint32 i = 0; i < NumTables; ++i)
+	{
+		if (!ReadTableUpdate(Reader, OutUpdate.Tables.AddDefaulted_GetRef(), Scratch))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FSpacetimeProtocol::DecodeServerMessage(
+	const TConstArrayView<uint8> Message,
+	FSpacetimeServerMessage& OutMessage,
+	TArray<uint8>& Scratch,
+	FString& OutError)
+{
+	FSpacetimeBsatnReader Reader(Message);
+
+	uint8 Tag;
+	if (!Reader.ReadTag(Tag))
+	{
+		OutError = TEXT("Empty server message");
+		return false;
+	}
+	OutMessage.Type = static_cast<ESpacetimeServerMessage>(Tag);
+
+	bool bOk;
+	switch (OutMessage.Type)
+	{
+	case ESpacetimeServerMessage::InitialSubscription:
+		bOk = ReadDatabaseUpdate(Reader, OutMessage.Update, Scratch)
+			&& Reader.ReadScalar(OutMessage.RequestId)
+			&& Reader.Skip(sizeof(int64));		// total_host_execution_duration
+		break;
+
+	case ESpacetimeServerMessage::TransactionUpdate:
+	{
+		uint8 Status;
+		bOk = Reader.ReadTag(Status);
+		OutMessage.Status = static_cast<ESpacetimeUpdateStatus>(Status);
+		switch (OutMessage.Status)
+		{
+		case ESpacetimeUpdateStatus::Committed:   bOk = bOk && ReadDatabaseUpdate(Reader, OutMessage.Update, Scratch); break;
+		case ESpacetimeUpdateStatus::Failed:      bOk = bOk && Reader.ReadString(OutMessage.Error); break;
+		case ESpacetimeUpdateStatus::OutOfEnergy: break;
+		default:                                  bOk = Reader.Fail(); break;
+		}
+
+		uint32 ReducerId;
+		TConstArrayView<uint8> Args;
+		bOk = bOk
+			&& Reader.Skip(sizeof(int64))					// timestamp
+			&& Reader.ReadWideInt(OutMessage.Identity, IdentityBytes)
+			&& Reader.ReadWideInt(OutMessage.ConnectionId, ConnectionIdBytes)
+			&& Reader.ReadString(OutMessage.ReducerName)
+			&& Reader.ReadScalar(ReducerId)
+			&& Reader.ReadBytesView(Args)
+			&& Reader.ReadScalar(OutMessage.RequestId)
+			&& Reader.Skip(16)								// energy_quanta_used
+			&& Reader.Skip(sizeof(int64));					// total_host_execution_duration
+		break;
+	}
+
+	case ESpacetimeServerMessage::TransactionUpdateLight:
+		bOk = Reader.ReadScalar(OutMessage.RequestId)
+			&& ReadDatabaseUpdate(Reader, OutMessage.Update, Scratch);
+		break;
+
+	case ESpacetimeServerMessage::IdentityToken:
+		bOk = Reader.ReadWideInt(OutMessage.Identity, IdentityBytes)
+			&& Reader.ReadString(OutMessage.Token)
+			&& Reader.ReadWideInt(OutMessage.ConnectionId, ConnectionIdBytes);
+		break;
+
+	case ESpacetimeServerMessage::SubscribeApplied:
+	case ESpacetimeServerMessage::UnsubscribeApplied:
+	{
+		// SubscribeRows: table_id and table_name, then a TableUpdate repeating them
+		uint32 TableId;
+		FString TableName;
+		bOk = Reader.ReadScalar(OutMessage.RequestId)
+			&& Reader.Skip(sizeof(uint64))					// total_host_execution_duration_micros
+			&& Reader.ReadScalar(OutMessage.QueryId)
+			&& Reader.ReadScalar(TableId)
+			&& Reader.ReadString(TableName)
+			&& ReadTableUpdate(Reader, OutMessage.Update.Tables.AddDefaulted_GetRef(), Scratch);
+		break;
+	}
+
+	case ESpacetimeServerMessage::SubscriptionError:
+	{
+		uint32 TableId;
+		bOk = Reader.Skip(sizeof(uint64))					// total_host_execution_duration_micros
+			&& ReadOptionalU32(Reader, OutMessage.RequestId)
+			&& ReadOptionalU32(Reader, OutMessage.QueryId)
+			&& ReadOptionalU32(Reader, TableId)
+			&& Reader.ReadString(OutMessage.Error);
+		break;
+	}
+
+	case ESpacetimeServerMessage::SubscribeMultiApplied:
+	case ESpacetimeServerMessage::UnsubscribeMultiApplied:
+		bOk = Reader.ReadScalar(OutMessage.RequestId)
+			&& Reader.Skip(sizeof(uint64))					// total_host_execution_duration_micros
+			&& Reader.ReadScalar(OutMessage.QueryId)
+			&& ReadDatabaseUpdate(Reader, OutMessage.Update, Scratch);
+		break;
+
+	case ESpacetimeServerMessage::OneOffQueryResponse:
+		// Not issued by this client; acknowledged without decoding
+		return true;
+
+	default:
+		OutError = FString::Printf(TEXT("Unknown server message tag %d"), Tag);
+		return false;
+	}
+
+	if (!bOk || !Reader.IsAtEnd())
+	{
+		OutError = FString::Printf(TEXT("Malformed server message (tag %d) at offset %d of %d"),
+			Tag, Reader.GetOffset(), Message.Num());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,373 @@
+#include "Client/SpacetimeSubscriptionManager.h"
+
+#include "Algo/AllOf.h"
+#include "Cache/SpacetimeCacheSnapshot.h"
+#include "Client/SpacetimeDBClient.h"
+#include "Client/SpacetimeProtocol.h"
+
+FSpacetimeSubscriptionManager::FSpacetimeSubscriptionManager(TSharedRef<FSpacetimeDBClient> InClient)
+	: Client(MoveTemp(InClient))
+{
+}
+
+FSpacetimeSubscriptionManager::~FSpacetimeSubscriptionManager()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Client->OnConnected.Remove(ConnectedHandle);
+	Client->OnSubscriptionApplied.Remove(AppliedHandle);
+	Client->OnSubscriptionError.Remove(ErrorHandle);
+}
+
+FString FSpacetimeSubscriptionManager::CanonicalizeQuery(const FString& Query)
+{
+	static const TSet<FString> Keywords = {
+		TEXT("SELECT"), TEXT("FROM"), TEXT("WHERE"), TEXT("AND"), TEXT("OR"), TEXT("NOT"),
+		TEXT("JOIN"), TEXT("INNER"), TEXT("LEFT"), TEXT("ON"), TEXT("AS"), TEXT("IS"),
+		TEXT("NULL"), TEXT("TRUE"), TEXT("FALSE"), TEXT("LIMIT"), TEXT("ORDER"), TEXT("BY"),
+		TEXT("ASC"), TEXT("DESC"), TEXT("COUNT"),
+	};
+
+	auto IsWordChar = [](const TCHAR Ch) { return FChar::IsAlnum(Ch) || Ch == TEXT('_'); };
+
+	TArray<FString> Tokens;
+	const int32 Len = Query.Len();
+	for (int32 i = 0; i < Len;)
+	{
+		const TCHAR Ch = Query[i];
+		if (FChar::IsWhitespace(Ch))
+		{
+			++i;
+			continue;
+		}
+
+		const int32 Start = i;
+		if (Ch == TEXT('\'') || Ch == TEXT('"'))
+		{
+			// Literals and quoted identifiers are kept verbatim; a doubled quote is an escaped one
+			for (++i; i < Len; ++i)
+			{
+				if (Query[i] == Ch)
+				{
+					if (i + 1 < Len && Query[i + 1] == Ch)
+					{
+						++i;
+						continue;
+					}
+					++i;
+					break;
+				}
+			}
+			Tokens.Add(Query.Mid(Start, i - Start));
+		}
+		else if (IsWordChar(Ch))
+		{
+			while (i < Len && IsWordChar(Query[i]))
+			{
+				++i;
+			}
+			FString Word = Query.Mid(Start, i - Start);
+			const FString Upper = Word.ToUpper();
+			Tokens.Add(Keywords.Contains(Upper) ? Upper : MoveTemp(Word));
+		}
+		else
+		{
+			const FString Pair = Query.Mid(i, 2);
+			const bool bTwoChars = Pair == TEXT("<=") || Pair == TEXT(">=") || Pair == TEXT("<>") || Pair == TEXT("!=");
+			i += bTwoChars ? 2 : 1;
+			Tokens.Add(Query.Mid(Start, i - Start));
+		}
+	}
+
+	while (!Tokens.IsEmpty() && Tokens.Last() == TEXT(";"))
+	{
+		Tokens.Pop();
+	}
+	return FString::Join(Tokens, TEXT(" "));
+}
+
+FSpacetimeSubscriptionHandle FSpacetimeSubscriptionManager::Subscribe(const FString& Query)
+{
+	check(IsInGameThread());
+
+	if (!TickHandle.IsValid())
+	{
+		// Registered here rather than in the constructor, where AsShared is not available yet
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateSP(this, &FSpacetimeSubscriptionManager::Tick));
+		ConnectedHandle = Client->OnConnected.AddSP(this, &FSpacetimeSubscriptionManager::HandleConnected);
+		AppliedHandle = Client->OnSubscriptionApplied.AddSP(this, &FSpacetimeSubscriptionManager::HandleApplied);
+		ErrorHandle = Client->OnSubscriptionError.AddSP(this, &FSpacetimeSubscriptionManager::HandleError);
+	}
+
+	const FString Canonical = CanonicalizeQuery(Query);
+	if (Canonical.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Ignoring empty subscription query"));
+		return {};
+	}
+
+	FQuery& Entry = Queries.FindOrAdd(Canonical);
+	if (Entry.Text.IsEmpty())
+	{
+		Entry.Text = Query.TrimStartAndEnd();
+	}
+	if (Entry.RefCount++ == 0)
+	{
+		// A query that failed for its earlier subscribers is tried again for the new ones
+		if (Entry.State == EQueryState::Failed)
+		{
+			Entry.State = EQueryState::Pending;
+		}
+		if (Entry.State == EQueryState::Pending)
+		{
+			bDirty = true;
+		}
+	}
+
+	const FSpacetimeSubscriptionHandle Handle{++LastHandleId};
+	HandleQueries.Add(Handle.Id, Canonical);
+	return Handle;
+}
+
+void FSpacetimeSubscriptionManager::Unsubscribe(FSpacetimeSubscriptionHandle& Handle)
+{
+	check(IsInGameThread());
+
+	FString Canonical;
+	if (!HandleQueries.RemoveAndCopyValue(Handle.Id, Canonical))
+	{
+		return;
+	}
+	Handle = {};
+
+	FQuery& Entry = Queries.FindChecked(Canonical);
+	if (--Entry.RefCount == 0)
+	{
+		// Only batched here; the flush decides what actually leaves
+		bDirty = true;
+	}
+}
+
+void FSpacetimeSubscriptionManager::Flush()
+{
+	check(IsInGameThread());
+
+	if (!bDirty || !Client->IsConnected())
+	{
+		return;
+	}
+	bDirty = false;
+
+	// Sets whose queries were all released
+	TArray<uint32> Released;
+	for (const auto& [QueryId, Members] : QuerySets)
+	{
+		const bool bUnused = Algo::AllOf(Members, [this](const FString& Canonical)
+		{
+			return Queries.FindChecked(Canonical).RefCount == 0;
+		});
+		if (bUnused)
+		{
+			Released.Add(QueryId);
+		}
+	}
+
+	// Queries that were never sent, or were dropped with a set, and still have subscribers
+	TArray<FString> Added;
+	TArray<FString> AddedTexts;
+	for (auto It = Queries.CreateIterator(); It; ++It)
+	{
+		FQuery& Entry = It->Value;
+		if (Entry.RefCount == 0 && Entry.QueryId == 0)
+		{
+			It.RemoveCurrent();
+		}
+		else if (Entry.RefCount > 0 && Entry.State == EQueryState::Pending)
+		{
+			Added.Add(It->Key);
+			AddedTexts.Add(Entry.Text);
+		}
+	}
+
+	if (!Added.IsEmpty())
+	{
+		const uint32 QueryId = ++LastQueryId;
+		for (const FString& Canonical : Added)
+		{
+			FQuery& Entry = Queries.FindChecked(Canonical);
+			Entry.QueryId = QueryId;
+			Entry.State = EQueryState::Sent;
+		}
+		QuerySets.Add(QueryId, Added);
+		if (Resync.IsValid() && !bResyncSent)
+		{
+			ResyncQueryIds.Add(QueryId);
+		}
+
+		UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Subscribing %d queries as set %u"), Added.Num(), QueryId);
+		Client->Send(FSpacetimeProtocol::EncodeSubscribeMulti(AddedTexts, Client->NextRequestId(), QueryId));
+	}
+	if (Resync.IsValid() && !bResyncSent)
+	{
+		bResyncSent = true;
+		ReleaseResyncIfDone();
+	}
+
+	// Unsubscribe after subscribing, so rows shared with a new set stay cached in between
+	for (const uint32 QueryId : Released)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Unsubscribing set %u"), QueryId);
+		Client->Send(FSpacetimeProtocol::EncodeUnsubscribeMulti(Client->NextRequestId(), QueryId));
+		RemoveQuerySet(QueryId);
+	}
+}
+
+int32 FSpacetimeSubscriptionManager::GetNumActiveQueries() const
+{
+	int32 Count = 0;
+	for (const auto& [Canonical, Entry] : Queries)
+	{
+		Count += Entry.RefCount > 0 ? 1 : 0;
+	}
+	return Count;
+}
+
+bool FSpacetimeSubscriptionManager::IsApplied(const FSpacetimeSubscriptionHandle Handle) const
+{
+	const FString* Canonical = HandleQueries.Find(Handle.Id);
+	return Canonical && Queries.FindChecked(*Canonical).State == EQueryState::Applied;
+}
+
+bool FSpacetimeSubscriptionManager::Tick(float DeltaTime)
+{
+	Flush();
+	return true;
+}
+
+void FSpacetimeSubscriptionManager::HandleConnected()
+{
+	// Rows cached so far stay until the server sent what it still has again
+	if (Resync.IsValid() && bResyncSent)
+	{
+		// Dropped before every set was applied; its rows are still cached, so the capture below holds them too
+		Resync->Discard();
+		Resync.Reset();
+	}
+	if (!Resync.IsValid())
+	{
+		// Rows loaded on Connect may still be on their way to the tables, so they are not captured
+		Resync = Client->TakeLoadedSnapshot();
+	}
+	if (!Resync.IsValid())
+	{
+		Resync = FSpacetimeCacheSnapshot::Capture(Client->GetCache());
+		if (Resync->GetNumRows() == 0)
+		{
+			Resync.Reset();
+		}
+	}
+	ResyncQueryIds.Reset();
+	bResyncSent = false;
+
+	// A new connection starts without subscriptions; everything still wanted is sent again
+	QuerySets.Empty();
+	for (auto It = Queries.CreateIterator(); It; ++It)
+	{
+		if (It->Value.RefCount == 0)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		It->Value.QueryId = 0;
+		It->Value.State = EQueryState::Pending;
+	}
+	bDirty = true;
+}
+
+void FSpacetimeSubscriptionManager::HandleApplied(const uint32 QueryId)
+{
+	const TArray<FString>* Members = QuerySets.Find(QueryId);
+	if (!Members)
+	{
+		return;
+	}
+
+	TArray<FString> Texts;
+	for (const FString& Canonical : *Members)
+	{
+		FQuery& Entry = Queries.FindChecked(Canonical);
+		Entry.State = EQueryState::Applied;
+		Texts.Add(Entry.Text);
+	}
+	if (ResyncQueryIds.Remove(QueryId) > 0)
+	{
+		ReleaseResyncIfDone();
+	}
+	OnQueriesApplied.Broadcast(Texts);
+}
+
+void FSpacetimeSubscriptionManager::HandleError(const uint32 QueryId, const FString& Error)
+{
+	const TArray<FString>* Found = QuerySets.Find(QueryId);
+	if (!Found)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] Subscription error: %s"), *Error);
+		return;
+	}
+
+	// The server dropped the whole set
+	const TArray<FString> Members = *Found;
+	TArray<FString> Texts;
+	for (const FString& Canonical : Members)
+	{
+		Texts.Add(Queries.FindChecked(Canonical).Text);
+	}
+	RemoveQuerySet(QueryId);
+	for (const FString& Canonical : Members)
+	{
+		if (FQuery* Entry = Queries.Find(Canonical))
+		{
+			Entry->State = EQueryState::Failed;
+		}
+	}
+	if (ResyncQueryIds.Remove(QueryId) > 0)
+	{
+		ReleaseResyncIfDone();
+	}
+
+	UE_LOG(LogTemp, Error, TEXT("[spacetime] Subscription of %d queries failed: %s"), Texts.Num(), *Error);
+	OnQueriesFailed.Broadcast(Texts, Error);
+}
+
+void FSpacetimeSubscriptionManager::RemoveQuerySet(const uint32 QueryId)
+{
+	TArray<FString> Members;
+	if (!QuerySets.RemoveAndCopyValue(QueryId, Members))
+	{
+		return;
+	}
+
+	for (const FString& Canonical : Members)
+	{
+		FQuery& Entry = Queries.FindChecked(Canonical);
+		Entry.QueryId = 0;
+		Entry.State = EQueryState::Pending;
+		if (Entry.RefCount == 0)
+		{
+			Queries.Remove(Canonical);
+		}
+	}
+}
+
+void FSpacetimeSubscriptionManager::ReleaseResyncIfDone()
+{
+	if (!Resync.IsValid() || !bResyncSent || !ResyncQueryIds.IsEmpty())
+	{
+		return;
+	}
+
+	// Queued after the sets' initial rows, so only the references the server did not renew are dropped
+	UE_LOG(LogTemp, Verbose, TEXT("[spacetime] Resubscribed; releasing %d rows cached before"), Resync->GetNumRows());
+	Resync->Release();
+	Resync.Reset();
+}
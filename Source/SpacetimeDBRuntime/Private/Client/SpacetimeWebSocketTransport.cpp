@@ -0,0 +1,80 @@
+#include "Client/SpacetimeWebSocketTransport.h"
+
+#include "IWebSocket.h"
+#include "WebSocketsModule.h"
+
+FSpacetimeWebSocketTransport::~FSpacetimeWebSocketTransport()
+{
+	Close();
+}
+
+void FSpacetimeWebSocketTransport::Connect(const FString& Url, const FString& Protocol, const TMap<FString, FString>& Headers)
+{
+	Close();
+
+	Socket = FModuleManager::LoadModuleChecked<FWebSocketsModule>(TEXT("WebSockets")).CreateWebSocket(Url, Protocol, Headers);
+
+	// The socket is owned by this transport and unbound in Close, so raw captures are safe
+	Socket->OnConnected().AddLambda([this]
+	{
+		OnConnected.ExecuteIfBound();
+	});
+	Socket->OnConnectionError().AddLambda([this](const FString& Error)
+	{
+		OnConnectionError.ExecuteIfBound(Error);
+	});
+	Socket->OnClosed().AddLambda([this](const int32 StatusCode, const FString& Reason, bool /*bWasClean*/)
+	{
+		OnClosed.ExecuteIfBound(StatusCode, Reason);
+	});
+	Socket->OnRawMessage().AddRaw(this, &FSpacetimeWebSocketTransport::HandleRawMessage);
+
+	Socket->Connect();
+}
+
+void FSpacetimeWebSocketTransport::Close()
+{
+	if (!Socket.IsValid())
+	{
+		return;
+	}
+
+	Socket->OnConnected().Clear();
+	Socket->OnConnectionError().Clear();
+	Socket->OnClosed().Clear();
+	Socket->OnRawMessage().Clear();
+	if (Socket->IsConnected())
+	{
+		Socket->Close();
+	}
+	Socket.Reset();
+	Partial.Empty();
+}
+
+bool FSpacetimeWebSocketTransport::IsConnected() const
+{
+	return Socket.IsValid() && Socket->IsConnected();
+}
+
+void FSpacetimeWebSocketTransport::Send(TArray<uint8>&& Message)
+{
+	if (!IsConnected())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Dropping %d byte message; not connected"), Message.Num());
+		return;
+	}
+	Socket->Send(Message.GetData(), Message.Num(), /*bIsBinary=*/ true);
+}
+
+void FSpacetimeWebSocketTransport::HandleRawMessage(const void* Data, const SIZE_T Size, const SIZE_T BytesRemaining)
+{
+	Partial.Append(static_cast<const uint8*>(Data), Size);
+	if (BytesRemaining > 0)
+	{
+		return;
+	}
+
+	// Hand over the buffer; decompression and decoding happen wherever the listener queues them
+	OnMessage.ExecuteIfBound(MoveTemp(Partial));
+	Partial.Reset();
+}
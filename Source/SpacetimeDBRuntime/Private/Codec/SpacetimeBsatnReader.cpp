@@ -0,0 +1,84 @@
+#include "Codec/SpacetimeBsatnReader.h"
+
+bool FSpacetimeBsatnReader::ReadBool(bool& Out)
+{
+	uint8 Value;
+	if (!ReadScalar(Value) || Value > 1)
+	{
+		return Fail();
+	}
+	Out = Value != 0;
+	return true;
+}
+
+bool FSpacetimeBsatnReader::ReadLength(uint32& Out)
+{
+	return ReadScalar(Out);
+}
+
+bool FSpacetimeBsatnReader::ReadString(FString& Out)
+{
+	TConstArrayView<uint8> Utf8;
+	if (!ReadBytesView(Utf8))
+	{
+		return false;
+	}
+
+	// Converted into the existing allocation, so recycled rows keep their string capacity
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Utf8.GetData()), Utf8.Num());
+	Out.Reset(Converted.Length());
+	Out.AppendChars(Converted.Get(), Converted.Length());
+	return true;
+}
+
+bool FSpacetimeBsatnReader::ReadBytes(TArray<uint8>& Out)
+{
+	TConstArrayView<uint8> Bytes;
+	if (!ReadBytesView(Bytes))
+	{
+		return false;
+	}
+	Out.Reset(Bytes.Num());
+	Out.Append(Bytes.GetData(), Bytes.Num());
+	return true;
+}
+
+bool FSpacetimeBsatnReader::ReadBytesView(TConstArrayView<uint8>& Out)
+{
+	uint32 Length;
+	if (!ReadLength(Length) || !Require(Length))
+	{
+		return false;
+	}
+	Out = Data.Slice(Offset, Length);
+	Offset += Length;
+	return true;
+}
+
+bool FSpacetimeBsatnReader::ReadWideInt(FString& Out, const int32 NumBytes)
+{
+	if (!Require(NumBytes))
+	{
+		return false;
+	}
+
+	// Little-endian on the wire, printed most significant byte first
+	Out.Reset(2 + NumBytes * 2);
+	Out += TEXT("0x");
+	for (int32 i = NumBytes - 1; i >= 0; --i)
+	{
+		ByteToHex(Data[Offset + i], Out);
+	}
+	Offset += NumBytes;
+	return true;
+}
+
+bool FSpacetimeBsatnReader::Skip(const int32 NumBytes)
+{
+	if (!Require(NumBytes))
+	{
+		return false;
+	}
+	Offset += NumBytes;
+	return true;
+}
@@ -0,0 +1,44 @@
+#include "Codec/SpacetimeBsatnWriter.h"
+
+#include "Misc/Parse.h"
+
+void FSpacetimeBsatnWriter::WriteString(const FString& Value)
+{
+	const FTCHARToUTF8 Utf8(*Value, Value.Len());
+	WriteBytes(TConstArrayView<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()));
+}
+
+void FSpacetimeBsatnWriter::WriteBytes(const TConstArrayView<uint8> Bytes)
+{
+	WriteLength(Bytes.Num());
+	Buffer.Append(Bytes.GetData(), Bytes.Num());
+}
+
+bool FSpacetimeBsatnWriter::WriteWideInt(const FString& Hex, const int32 NumBytes)
+{
+	FStringView Digits = Hex;
+	if (Digits.StartsWith(TEXT("0x"), ESearchCase::IgnoreCase))
+	{
+		Digits.RightChopInline(2);
+	}
+	if (Digits.IsEmpty() || Digits.Len() > NumBytes * 2)
+	{
+		return false;
+	}
+	for (const TCHAR Ch : Digits)
+	{
+		if (!FChar::IsHexDigit(Ch))
+		{
+			return false;
+		}
+	}
+
+	// Little-endian on the wire: the last digits are the first byte
+	const int32 Start = Buffer.AddZeroed(NumBytes);
+	for (int32 Digit = 0; Digit < Digits.Len(); ++Digit)
+	{
+		const int32 FromEnd = Digits.Len() - 1 - Digit;
+		Buffer[Start + FromEnd / 2] |= static_cast<uint8>(FParse::HexDigit(Digits[Digit]) << (FromEnd % 2 * 4));
+	}
+	return true;
+}
@@ -0,0 +1,97 @@
+#include "Codec/SpacetimeCompression.h"
+
+#include "Misc/Compression.h"
+
+// Refuse to allocate more than this for a single message, whatever its gzip trailer claims
+static constexpr uint32 MaxDecompressedSize = 512 * 1024 * 1024;
+
+const TCHAR* LexToString(const ESpacetimeCompression Compression)
+{
+	switch (Compression)
+	{
+	case ESpacetimeCompression::None:   return TEXT("None");
+	case ESpacetimeCompression::Brotli: return TEXT("Brotli");
+	case ESpacetimeCompression::Gzip:   return TEXT("Gzip");
+	}
+	return TEXT("Unknown");
+}
+
+bool FSpacetimeDecompressor::Decompress(
+	const ESpacetimeCompression Compression,
+	const TConstArrayView<uint8> Payload,
+	TArray<uint8>& OutBuffer,
+	FString& OutError)
+{
+	switch (Compression)
+	{
+	case ESpacetimeCompression::None:
+		OutBuffer.Reset(Payload.Num());
+		OutBuffer.Append(Payload.GetData(), Payload.Num());
+		return true;
+
+	case ESpacetimeCompression::Gzip:
+	{
+		// A gzip member ends with the uncompressed size modulo 2^32, little-endian
+		if (Payload.Num() < 18)
+		{
+			OutError = FString::Printf(TEXT("Gzip payload of %d bytes is truncated"), Payload.Num());
+			return false;
+		}
+		uint32 UncompressedSize;
+		FMemory::Memcpy(&UncompressedSize, Payload.GetData() + Payload.Num() - sizeof(uint32), sizeof(uint32));
+		if (UncompressedSize > MaxDecompressedSize)
+		{
+			OutError = FString::Printf(TEXT("Gzip payload claims %u uncompressed bytes"), UncompressedSize);
+			return false;
+		}
+
+		// Reset keeps the allocation, so steady-state messages decompress without allocating
+		OutBuffer.Reset(UncompressedSize);
+		OutBuffer.AddUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(NAME_Gzip, OutBuffer.GetData(), UncompressedSize, Payload.GetData(), Payload.Num()))
+		{
+			OutError = TEXT("Failed to inflate gzip payload");
+			return false;
+		}
+		return true;
+	}
+
+	case ESpacetimeCompression::Brotli:
+		OutError = TEXT("Brotli-compressed messages are not supported; connect with gzip compression");
+		return false;
+	}
+
+	OutError = FString::Printf(TEXT("Unknown compression tag %d"), static_cast<int32>(Compression));
+	return false;
+}
+
+bool FSpacetimeDecompressor::DecompressServerMessage(
+	const TConstArrayView<uint8> Frame,
+	TArray<uint8>& Buffer,
+	TConstArrayView<uint8>& OutMessage,
+	ESpacetimeCompression& OutCompression,
+	FString& OutError)
+{
+	if (Frame.IsEmpty())
+	{
+		OutError = TEXT("Empty server message");
+		return false;
+	}
+
+	OutCompression = static_cast<ESpacetimeCompression>(Frame[0]);
+	const TConstArrayView<uint8> Payload = Frame.RightChop(1);
+
+	if (OutCompression == ESpacetimeCompression::None)
+	{
+		// Uncompressed messages are decoded in place
+		OutMessage = Payload;
+		return true;
+	}
+
+	if (!Decompress(OutCompression, Payload, Buffer, OutError))
+	{
+		return false;
+	}
+	OutMessage = Buffer;
+	return true;
+}
@@ -0,0 +1,115 @@
+#include "SpacetimeAsyncActions.h"
+
+#include "Async/Async.h"
+#include "Client/SpacetimeDBClient.h"
+#include "SpacetimeBlueprintLibrary.h"
+#include "SpacetimeDBSubsystem.h"
+
+USpacetimeReducerCallAction* USpacetimeReducerCallAction::CallReducer(
+	UObject* WorldContextObject,
+	const FString& ReducerName,
+	TOptional<TArray<uint8>>&& Args)
+{
+	USpacetimeReducerCallAction* Action = NewObject<USpacetimeReducerCallAction>();
+	Action->ReducerName = ReducerName;
+	Action->Args = MoveTemp(Args);
+	if (const USpacetimeDBSubsystem* Subsystem = USpacetimeDBSubsystem::Get(WorldContextObject))
+	{
+		Action->Client = Subsystem->GetClient();
+	}
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void USpacetimeReducerCallAction::Activate()
+{
+	if (!Args.IsSet())
+	{
+		Finish(false, FString::Printf(TEXT("Invalid arguments for reducer '%s'"), *ReducerName));
+		return;
+	}
+	if (!Client.IsValid() || !Client->IsConnected())
+	{
+		Finish(false, TEXT("Not connected to SpacetimeDB"));
+		return;
+	}
+
+	CommittedHandle = Client->OnReducerCommitted.AddUObject(this, &USpacetimeReducerCallAction::HandleCommitted);
+	FailedHandle = Client->OnReducerFailed.AddUObject(this, &USpacetimeReducerCallAction::HandleFailed);
+	DisconnectedHandle = Client->OnDisconnected.AddUObject(this, &USpacetimeReducerCallAction::HandleDisconnected);
+	RequestId = Client->CallReducer(ReducerName, Args.GetValue());
+	Args.Reset();
+}
+
+void USpacetimeReducerCallAction::HandleCommitted(const FString& InReducerName, const uint32 InRequestId)
+{
+	if (InRequestId == RequestId)
+	{
+		Finish(true, FString());
+	}
+}
+
+void USpacetimeReducerCallAction::HandleFailed(const FString& InReducerName, const uint32 InRequestId, const FString& Error)
+{
+	if (InRequestId == RequestId)
+	{
+		Finish(false, Error);
+	}
+}
+
+void USpacetimeReducerCallAction::HandleDisconnected(const FString& Reason)
+{
+	// The outcome is unknown: the reducer may still have run
+	Finish(false, FString::Printf(TEXT("Disconnected before '%s' was acknowledged: %s"), *ReducerName, *Reason));
+}
+
+void USpacetimeReducerCallAction::Finish(const bool bSucceeded, const FString& Error)
+{
+	if (Client.IsValid())
+	{
+		Client->OnReducerCommitted.Remove(CommittedHandle);
+		Client->OnReducerFailed.Remove(FailedHandle);
+		Client->OnDisconnected.Remove(DisconnectedHandle);
+		Client.Reset();
+	}
+
+	if (bSucceeded)
+	{
+		OnSuccess.Broadcast(Error);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[spacetime] Reducer '%s' failed: %s"), *ReducerName, *Error);
+		OnFailure.Broadcast(Error);
+	}
+	SetReadyToDestroy();
+}
+
+USpacetimeDescribeDatabaseAction* USpacetimeDescribeDatabaseAction::DescribeDatabaseAsync(const FString& DatabaseName)
+{
+	USpacetimeDescribeDatabaseAction* Action = NewObject<USpacetimeDescribeDatabaseAction>();
+	Action->DatabaseName = DatabaseName;
+
+	// Kept alive by the root set until the result is back, whatever the calling graph does meanwhile
+	Action->AddToRoot();
+	return Action;
+}
+
+void USpacetimeDescribeDatabaseAction::Activate()
+{
+	USpacetimeBlueprintLibrary::DescribeDatabaseAsync(DatabaseName).Next(
+		[WeakThis = TWeakObjectPtr<USpacetimeDescribeDatabaseAction>(this)](FSpacetimeDatabaseDescription Description)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Description = MoveTemp(Description)]
+		{
+			USpacetimeDescribeDatabaseAction* This = WeakThis.Get();
+			if (!This)
+			{
+				return;
+			}
+			This->RemoveFromRoot();
+			(Description.bSucceeded ? This->OnSuccess : This->OnFailure).Broadcast(Description.Tables, Description.Reducers, Description.Error);
+			This->SetReadyToDestroy();
+		});
+	});
+}
@@ -3,37 +3,40 @@
 
 #include "SpacetimeBlueprintLibrary.h"
 
-#include "HAL/PlatformProcess.h" // for launching external (stdb cli, in this case) processes
+#include "Async/Async.h"
+#include "SpacetimeProcessRunner.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonReader.h"
 #include "Dom/JsonValue.h"
 
-static bool RunSpacetimeDB(const FString& Args, FString& OutFullOutput, int32& OutReturnCode)
+/** Fills Tables and Reducers from the JSON of `spacetime describe --json`. */
+static bool ParseDescription(
+	const TSharedPtr<FJsonObject>& JsonObj,
+	TArray<FString>& Tables,
+	TArray<FString>& Reducers,
+	FString& OutError)
 {
-	FString StdOut, StdErr;
-	if (!FPlatformProcess::ExecProcess(
-		TEXT("spacetime"), *Args, &OutReturnCode, &StdOut, &StdErr))
+	if (!JsonObj->HasField(TEXT("tables")))
+	{
+		OutError = TEXT("JSON output from CLI does not contain 'tables' field");
+		return false;
+	}
+	if (!JsonObj->HasField(TEXT("reducers")))
 	{
-		OutFullOutput = StdErr.IsEmpty() ? TEXT("Failed to launch CLI.") : StdErr;
-		OutFullOutput += TEXT("\n") + StdOut;
+		OutError = TEXT("JSON output from CLI does not contain 'reducers' field");
 		return false;
 	}
 
-	if (OutReturnCode != 0)
+	for (auto TablesArray = JsonObj->GetArrayField(TEXT("tables"));
+		 const auto& Table : TablesArray)
 	{
-		if (!StdErr.IsEmpty())
-		{
-			OutFullOutput = StdErr + TEXT("\n") + StdOut;
-			return false;			
-		}
+		Tables.Add(Table->AsObject()->GetStringField(TEXT("name")));
 	}
 
-	if (!StdErr.IsEmpty())
+	for (auto& Reducer : JsonObj->GetArrayField(TEXT("reducers")))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[Spacetime] CLI output:\n%s"), *StdOut);
+		Reducers.Add(Reducer->AsObject()->GetStringField(TEXT("name")));
 	}
-	
-	OutFullOutput = StdOut;
 	return true;
 }
 
@@ -43,80 +46,78 @@ bool USpacetimeBlueprintLibrary::DescribeDatabase(
 	TArray<FString>& Reducers,
 	FString& OutError)
 {
-	if (DatabaseName.IsEmpty())
-	{
-		OutError = TEXT("Database name is empty");
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] %s"), *OutError);
-		
-		return false;
-	}
-	
-	// TODO: check if 'spacetime' binary available
-	// TODO: check if server running, logged, etc.	
-	
-	int32 ReturnCode;
-	FString FullOutput;
-	if (!RunSpacetimeDB(TEXT("describe --json ") + DatabaseName, FullOutput, ReturnCode))
-	{
-		OutError = FullOutput;
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] %s"), *OutError);
-		return false;
-	}
+	FSpacetimeDatabaseDescription Description = DescribeDatabaseAsync(DatabaseName).Get();
+	Tables = MoveTemp(Description.Tables);
+	Reducers = MoveTemp(Description.Reducers);
+	OutError = MoveTemp(Description.Error);
+	return Description.bSucceeded;
+}
 
-	// 3. Parse JSON object
-	// Filter out any warning lines
-	auto JsonText = FullOutput;
-	TSharedPtr<FJsonObject> JsonObj;
-	if (auto Reader = TJsonReaderFactory<>::Create(JsonText);
-		!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
+TFuture<FSpacetimeDatabaseDescription> USpacetimeBlueprintLibrary::DescribeDatabaseAsync(
+	const FString& DatabaseName,
+	const double Timeout,
+	TSharedPtr<FSpacetimeProcessRunner>* OutRunner)
+{
+	if (DatabaseName.IsEmpty())
 	{
-		// Grab parser error info;
-		const FString ErrorMessage = Reader->GetErrorMessage();
-		OutError = FString::Printf(
-			TEXT("JSON parse failed: %s"), *ErrorMessage);
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] %s"), *OutError);
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] While parsing JSON output from CLI:\n%s"), *JsonText);
-		return false;
+		FSpacetimeDatabaseDescription Description;
+		Description.Error = TEXT("Database name is empty");
+		UE_LOG(LogTemp, Error, TEXT("[Spacetime] %s"), *Description.Error);
+		return MakeFulfilledPromise<FSpacetimeDatabaseDescription>(MoveTemp(Description)).GetFuture();
 	}
 
-	for (const auto& Entry : JsonObj->Values)
+	FSpacetimeProcessParams Params;
+	Params.Arguments = TEXT("describe --json ") + DatabaseName;
+	Params.Timeout = Timeout;
+	Params.bCaptureStdOut = false;
+	const TSharedRef<FSpacetimeProcessRunner> Runner = MakeShared<FSpacetimeProcessRunner>(Params);
+	if (OutRunner)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[Spacetime] DB entry: %s"), *Entry.Key);
-	}
-	
-	if (!JsonObj->HasField(TEXT("tables")))
-	{
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] JSON output from CLI does not contain 'tables' field"));
-		return false;
-	}
-	if (!JsonObj->HasField(TEXT("reducers")))
-	{
-		UE_LOG(LogTemp, Error, TEXT("[Spacetime] JSON output from CLI does not contain 'reducers' field"));
-		return false;
+		*OutRunner = Runner;
 	}
 
-	for (auto TablesArray = JsonObj->GetArrayField(TEXT("tables"));
-		 const auto& Table : TablesArray)
+	// The JSON reader consumes stdout as the runner receives it, and sees its end once the CLI exited
+	const TSharedRef<FSpacetimeTextStream> Stream = MakeShared<FSpacetimeTextStream>();
+	Runner->OnStdOut.BindThreadSafeSP(Stream, &FSpacetimeTextStream::Append);
+	TFuture<FSpacetimeProcessResult> Exited = Runner->Launch().Next([Stream](const FSpacetimeProcessResult& Result)
 	{
-		Tables.Add(Table->AsObject()->GetStringField(TEXT("name")));
-	}
+		Stream->Close();
+		return Result;
+	});
 
-	for (auto& Reducer : JsonObj->GetArrayField(TEXT("reducers")))
+	return Async(EAsyncExecution::Thread, [Stream, Exited = MoveTemp(Exited), Params]() mutable
 	{
-		Reducers.Add(Reducer->AsObject()->GetStringField(TEXT("name")));
-	}
+		FSpacetimeDatabaseDescription Description;
 
-	//UE_LOG(LogTemp, Warning, TEXT("SpacetimeCLI initialized"));
-	//UE_LOG(LogTemp, Warning, TEXT("Something	` might be wrong: %s"), *MyStringVar);
-	//UE_LOG(LogTemp, Error, TEXT("Failed to run describe --json"));
+		TSharedPtr<FJsonObject> JsonObj;
+		const auto Reader = TJsonReaderFactory<>::Create(&Stream.Get());
+		const bool bParsed = FJsonSerializer::Deserialize(Reader, JsonObj) && JsonObj.IsValid();
 
-	// for (auto &ReducersList = JsonObj->GetArrayField(TEXT("reducers"));
-	// 	auto &Reducer : ReducersList)
-	// {
-	// 	Reducers.Add(Reducer->AsString());
-	// }
-	
+		// Whatever the reader left is not needed, but the CLI has to finish before its result is known
+		const FSpacetimeProcessResult Result = Exited.Get();
+		if (!Result.Succeeded())
+		{
+			Description.Error = Result.DescribeFailure(Params);
+		}
+		else if (!bParsed)
+		{
+			// Grab parser error info;
+			Description.Error = FString::Printf(
+				TEXT("JSON parse failed: %s"), *Reader->GetErrorMessage());
+		}
+		else
+		{
+			Description.bSucceeded = ParseDescription(JsonObj, Description.Tables, Description.Reducers, Description.Error);
+		}
 
-	return true;
+		if (!Result.StdErr.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[Spacetime] CLI output:\n%s"), *Result.StdErr);
+		}
+		if (!Description.bSucceeded)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[Spacetime] %s"), *Description.Error);
+		}
+		return Description;
+	});
 }
-
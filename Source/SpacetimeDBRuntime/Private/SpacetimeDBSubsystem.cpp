@@ -0,0 +1,19 @@
+#include "SpacetimeDBSubsystem.h"
+
+#include "Client/SpacetimeDBClient.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+USpacetimeDBSubsystem* USpacetimeDBSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<USpacetimeDBSubsystem>() : nullptr;
+}
+
+void USpacetimeDBSubsystem::Deinitialize()
+{
+	Client.Reset();
+	Super::Deinitialize();
+}
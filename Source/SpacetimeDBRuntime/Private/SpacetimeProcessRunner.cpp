@@ -0,0 +1,268 @@
+#include "SpacetimeProcessRunner.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	/** Bytes at the end of Bytes that begin a UTF-8 sequence whose remaining bytes did not arrive yet. */
+	int32 GetIncompleteUtf8Tail(const TArray<uint8>& Bytes)
+	{
+		for (int32 Back = 1; Back <= FMath::Min(4, Bytes.Num()); ++Back)
+		{
+			const uint8 Byte = Bytes[Bytes.Num() - Back];
+			if ((Byte & 0xC0) == 0x80)
+			{
+				continue;
+			}
+			const int32 Length = Byte >= 0xF0 ? 4 : Byte >= 0xE0 ? 3 : Byte >= 0xC0 ? 2 : 1;
+			return Length > Back ? Back : 0;
+		}
+		return 0;
+	}
+
+	/** Reads a pipe as UTF-8, keeping partial characters for the next read. */
+	struct FPipeReader
+	{
+		void* ReadPipe = nullptr;
+		void* WritePipe = nullptr;
+		TArray<uint8> Pending;
+
+		/** Text read since the last call; empty if nothing arrived. */
+		FString Read()
+		{
+			TArray<uint8> Bytes;
+			if (!FPlatformProcess::ReadPipeToArray(ReadPipe, Bytes) || Bytes.IsEmpty())
+			{
+				return FString();
+			}
+			Pending.Append(Bytes);
+
+			const int32 Complete = Pending.Num() - GetIncompleteUtf8Tail(Pending);
+			const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Pending.GetData()), Complete);
+			FString Text(Converted.Length(), Converted.Get());
+			Pending.RemoveAt(0, Complete);
+			return Text;
+		}
+
+		void Close()
+		{
+			FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+			ReadPipe = WritePipe = nullptr;
+		}
+	};
+}
+
+FString FSpacetimeProcessResult::DescribeFailure(const FSpacetimeProcessParams& Params) const
+{
+	if (!bLaunched)
+	{
+		return FString::Printf(TEXT("Failed to launch '%s'"), *Params.Executable);
+	}
+	if (bCanceled)
+	{
+		return FString::Printf(TEXT("'%s %s' was canceled"), *Params.Executable, *Params.Arguments);
+	}
+	if (bTimedOut)
+	{
+		return FString::Printf(TEXT("'%s %s' timed out after %.0f seconds"), *Params.Executable, *Params.Arguments, Params.Timeout);
+	}
+	return FString::Printf(TEXT("'%s %s' exited with code %d%s%s"), *Params.Executable, *Params.Arguments, ReturnCode,
+		StdErr.IsEmpty() ? TEXT("") : TEXT(": "), *StdErr);
+}
+
+FSpacetimeProcessRunner::FSpacetimeProcessRunner(FSpacetimeProcessParams InParams)
+	: Params(MoveTemp(InParams))
+{
+}
+
+TFuture<FSpacetimeProcessResult> FSpacetimeProcessRunner::Launch()
+{
+	check(!bLaunched);
+	bLaunched = true;
+	bRunning = true;
+
+	// A thread of its own rather than the pool's: a slow CLI would hold a worker for its whole run
+	return Async(EAsyncExecution::Thread, [This = AsShared()]
+	{
+		FSpacetimeProcessResult Result = This->Run();
+		This->bRunning = false;
+		if (This->OnCompleted.IsBound())
+		{
+			AsyncTask(ENamedThreads::GameThread, [This, Result]
+			{
+				This->OnCompleted.Execute(Result);
+			});
+		}
+		return Result;
+	});
+}
+
+FSpacetimeProcessResult FSpacetimeProcessRunner::Run()
+{
+	FSpacetimeProcessResult Result;
+
+	FPipeReader StdOut;
+	FPipeReader StdErr;
+	if (!FPlatformProcess::CreatePipe(StdOut.ReadPipe, StdOut.WritePipe) || !FPlatformProcess::CreatePipe(StdErr.ReadPipe, StdErr.WritePipe))
+	{
+		StdOut.Close();
+		StdErr.Close();
+		Result.StdErr = TEXT("Failed to create pipes");
+		return Result;
+	}
+
+	FProcHandle Process = FPlatformProcess::CreateProc(
+		*Params.Executable,
+		*Params.Arguments,
+		/*bLaunchDetached=*/ false,
+		/*bLaunchHidden=*/ true,
+		/*bLaunchReallyHidden=*/ true,
+		nullptr,
+		0,
+		Params.WorkingDirectory.IsEmpty() ? nullptr : *Params.WorkingDirectory,
+		StdOut.WritePipe,
+		nullptr,
+		StdErr.WritePipe);
+	if (!Process.IsValid())
+	{
+		StdOut.Close();
+		StdErr.Close();
+		return Result;
+	}
+	Result.bLaunched = true;
+
+	auto Drain = [this, &Result, &StdOut, &StdErr]() -> bool
+	{
+		const FString Out = StdOut.Read();
+		const FString Err = StdErr.Read();
+		if (!Out.IsEmpty())
+		{
+			if (Params.bCaptureStdOut)
+			{
+				Result.StdOut += Out;
+			}
+			OnStdOut.ExecuteIfBound(Out);
+		}
+		Result.StdErr += Err;
+		return !Out.IsEmpty() || !Err.IsEmpty();
+	};
+
+	const double Deadline = Params.Timeout > 0.0 ? FPlatformTime::Seconds() + Params.Timeout : TNumericLimits<double>::Max();
+	while (FPlatformProcess::IsProcRunning(Process))
+	{
+		if (bCancelRequested || FPlatformTime::Seconds() >= Deadline)
+		{
+			Result.bCanceled = bCancelRequested;
+			Result.bTimedOut = !bCancelRequested;
+			FPlatformProcess::TerminateProc(Process, /*KillTree=*/ true);
+			FPlatformProcess::WaitForProc(Process);
+			break;
+		}
+
+		// Reading keeps the pipes from filling up, which would stall the process
+		if (!Drain())
+		{
+			FPlatformProcess::Sleep(0.005f);
+		}
+	}
+	while (Drain())
+	{
+	}
+
+	FPlatformProcess::GetProcReturnCode(Process, &Result.ReturnCode);
+	FPlatformProcess::CloseProc(Process);
+	StdOut.Close();
+	StdErr.Close();
+	return Result;
+}
+
+FSpacetimeTextStream::FSpacetimeTextStream()
+	: DataAvailable(FPlatformProcess::GetSynchEventFromPool(/*bIsManualReset=*/ false))
+{
+	SetIsLoading(true);
+}
+
+FSpacetimeTextStream::~FSpacetimeTextStream()
+{
+	FPlatformProcess::ReturnSynchEventToPool(DataAvailable);
+}
+
+void FSpacetimeTextStream::Append(const FStringView Text)
+{
+	if (Text.IsEmpty())
+	{
+		return;
+	}
+	{
+		FScopeLock ScopeLock(&Lock);
+		Written.Append(Text.GetData(), Text.Len());
+	}
+	DataAvailable->Trigger();
+}
+
+void FSpacetimeTextStream::Close()
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		bClosed = true;
+	}
+	DataAvailable->Trigger();
+}
+
+bool FSpacetimeTextStream::Refill()
+{
+	for (;;)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (!Written.IsEmpty())
+			{
+				Reading.Reset();
+				Swap(Reading, Written);
+				ReadIndex = 0;
+				return true;
+			}
+			if (bClosed)
+			{
+				return false;
+			}
+		}
+		DataAvailable->Wait();
+	}
+}
+
+void FSpacetimeTextStream::Serialize(void* Data, const int64 Num)
+{
+	uint8* Dest = static_cast<uint8*>(Data);
+	int64 Remaining = Num;
+	while (Remaining > 0)
+	{
+		if (ReadIndex >= Reading.Num() && !Refill())
+		{
+			// Reading past the end, as FArchive does for a truncated file
+			SetError();
+			FMemory::Memzero(Dest, Remaining);
+			return;
+		}
+
+		// Readers take whole characters, as TJsonReader does
+		const int64 Available = (Reading.Num() - ReadIndex) * sizeof(TCHAR);
+		const int64 Count = FMath::Min(Remaining, Available) / sizeof(TCHAR) * sizeof(TCHAR);
+		if (Count == 0)
+		{
+			SetError();
+			return;
+		}
+		FMemory::Memcpy(Dest, Reading.GetData() + ReadIndex, Count);
+		ReadIndex += static_cast<int32>(Count / sizeof(TCHAR));
+		Dest += Count;
+		Remaining -= Count;
+	}
+}
+
+bool FSpacetimeTextStream::AtEnd()
+{
+	return ReadIndex >= Reading.Num() && !Refill();
+}
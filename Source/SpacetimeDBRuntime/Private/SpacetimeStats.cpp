@@ -0,0 +1,5 @@
+#include "SpacetimeStats.h"
+
+CSV_DEFINE_CATEGORY(SpacetimeDB, true);
+
+UE_TRACE_CHANNEL_DEFINE(SpacetimeDBChannel);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("SpacetimeDB"), STATGROUP_SpacetimeDB, STATCAT_Advanced);
+
+// Where the time goes; everything but Dispatch and Send runs on pool threads
+DECLARE_CYCLE_STAT(TEXT("Decompress Message"), STAT_SpacetimeDecompress, STATGROUP_SpacetimeDB);
+DECLARE_CYCLE_STAT(TEXT("Decode Message"), STAT_SpacetimeDecode, STATGROUP_SpacetimeDB);
+DECLARE_CYCLE_STAT(TEXT("Decode Rows"), STAT_SpacetimeDecodeRows, STATGROUP_SpacetimeDB);
+DECLARE_CYCLE_STAT(TEXT("Dispatch Table Changes"), STAT_SpacetimeDispatch, STATGROUP_SpacetimeDB);
+DECLARE_CYCLE_STAT(TEXT("Send Messages"), STAT_SpacetimeSend, STATGROUP_SpacetimeDB);
+
+// Throughput and latency, sampled about once per second
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes In/s"), STAT_SpacetimeBytesIn, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Out/s"), STAT_SpacetimeBytesOut, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages In/s"), STAT_SpacetimeMessagesIn, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Out/s"), STAT_SpacetimeMessagesOut, STATGROUP_SpacetimeDB);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Decode Time per Message (us)"), STAT_SpacetimeDecodeTimePerMessage, STATGROUP_SpacetimeDB);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Reducer Round Trip p50 (ms)"), STAT_SpacetimeReducerRttP50, STATGROUP_SpacetimeDB);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Reducer Round Trip p99 (ms)"), STAT_SpacetimeReducerRttP99, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reducer Calls in Flight"), STAT_SpacetimeReducerCallsInFlight, STATGROUP_SpacetimeDB);
+
+// Queues and the cache, every frame
+DECLARE_DWORD_COUNTER_STAT(TEXT("Receive Backlog (messages)"), STAT_SpacetimeReceiveBacklog, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Send Queue (messages)"), STAT_SpacetimeSendQueue, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dispatch Backlog (rows)"), STAT_SpacetimeDispatchBacklog, STATGROUP_SpacetimeDB);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cached Rows"), STAT_SpacetimeCachedRows, STATGROUP_SpacetimeDB);
+DECLARE_MEMORY_STAT(TEXT("Cache Memory"), STAT_SpacetimeCacheMemory, STATGROUP_SpacetimeDB);
+
+CSV_DECLARE_CATEGORY_EXTERN(SpacetimeDB);
+
+/** Enabled with -trace=SpacetimeDB, or 'trace.enable SpacetimeDB' at runtime. */
+UE_TRACE_CHANNEL_EXTERN(SpacetimeDBChannel);
+
+/**
+ * Times the rest of the scope for 'stat SpacetimeDB', as a CPU event on the SpacetimeDB Insights
+ * channel and as a CSV profiler timing. Stat is the name of a STAT_Spacetime* cycle stat, without the prefix.
+ */
+#define SPACETIME_SCOPED_TIMING(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_Spacetime##Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Spacetime##Stat, SpacetimeDBChannel); \
+	CSV_SCOPED_TIMING_STAT(SpacetimeDB, Stat)
@@ -0,0 +1,375 @@
+#include "SpacetimeSwarmCommandlet.h"
+
+#include "Algo/AllOf.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Cache/SpacetimeClientCache.h"
+#include "Client/SpacetimeDBClient.h"
+#include "Client/SpacetimeLatencyHistogram.h"
+#include "Client/SpacetimeSubscriptionManager.h"
+#include "Client/SpacetimeWebSocketTransport.h"
+#include "Containers/Ticker.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Modules/ModuleManager.h"
+
+namespace SpacetimeSwarm
+{
+	/** A point of the call rate profile. */
+	struct FRatePoint
+	{
+		double Time = 0.0;
+		double CallsPerSecond = 0.0;
+	};
+
+	/** Parses "seconds:rate" points separated by ','; times must increase. */
+	static bool ParseProfile(const FString& Text, TArray<FRatePoint>& OutPoints, FString& OutError)
+	{
+		TArray<FString> Points;
+		Text.ParseIntoArray(Points, TEXT(","));
+		for (const FString& Point : Points)
+		{
+			FString Time;
+			FString Rate;
+			if (!Point.Split(TEXT(":"), &Time, &Rate) || !Time.IsNumeric() || !Rate.IsNumeric())
+			{
+				OutError = FString::Printf(TEXT("Expected seconds:rate, got '%s'"), *Point);
+				return false;
+			}
+
+			const FRatePoint Parsed{FCString::Atod(*Time), FCString::Atod(*Rate)};
+			if (!OutPoints.IsEmpty() && Parsed.Time <= OutPoints.Last().Time)
+			{
+				OutError = FString::Printf(TEXT("Profile times must increase, got '%s'"), *Point);
+				return false;
+			}
+			OutPoints.Add(Parsed);
+		}
+
+		if (OutPoints.IsEmpty())
+		{
+			OutError = TEXT("Empty profile");
+			return false;
+		}
+		return true;
+	}
+
+	/** Calls per second and client at Time, interpolated between points and held outside them. */
+	static double EvaluateProfile(const TArray<FRatePoint>& Points, const double Time)
+	{
+		if (Time <= Points[0].Time)
+		{
+			return Points[0].CallsPerSecond;
+		}
+		for (int32 i = 1; i < Points.Num(); ++i)
+		{
+			if (Time < Points[i].Time)
+			{
+				const double Alpha = (Time - Points[i - 1].Time) / (Points[i].Time - Points[i - 1].Time);
+				return FMath::Lerp(Points[i - 1].CallsPerSecond, Points[i].CallsPerSecond, Alpha);
+			}
+		}
+		return Points.Last().CallsPerSecond;
+	}
+
+	struct FVirtualClient
+	{
+		TSharedPtr<FSpacetimeDBClient> Client;
+		TSharedPtr<FSpacetimeSubscriptionManager> Subscriptions;
+
+		/** Send times of the calls waiting for an answer, by request id. */
+		TMap<uint32, double> CallStartTimes;
+
+		/** Fractional calls owed by the rate profile. */
+		double CallsDue = 0.0;
+
+		bool bConnected = false;
+	};
+
+	/** Swarm-wide counters over one report interval, or the whole run. */
+	struct FCounters
+	{
+		FSpacetimeLatencyHistogram RoundTrips;
+		uint64 Calls = 0;
+		uint64 Committed = 0;
+		uint64 Failed = 0;
+		int32 Disconnects = 0;
+
+		void Merge(const FCounters& Other)
+		{
+			RoundTrips.Merge(Other.RoundTrips);
+			Calls += Other.Calls;
+			Committed += Other.Committed;
+			Failed += Other.Failed;
+			Disconnects += Other.Disconnects;
+		}
+	};
+
+	/** Warnings logged per kind before the rest are only counted. */
+	static constexpr int32 MaxLoggedErrors = 10;
+}
+
+USpacetimeSwarmCommandlet::USpacetimeSwarmCommandlet()
+{
+	LogToConsole = true;
+}
+
+int32 USpacetimeSwarmCommandlet::Main(const FString& Params)
+{
+	using namespace SpacetimeSwarm;
+
+	FSpacetimeConnectionParams ConnectionParams;
+	if (!FParse::Value(*Params, TEXT("Database="), ConnectionParams.DatabaseName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] Usage: -run=SpacetimeSwarm -Database=<name> [-Host=] [-Clients=] [-RampUp=] [-Duration=] "
+			"[-Query=] [-Reducer=] [-Args=] [-Profile=] [-Compression=] [-TickRate=] [-ReportInterval=] [-Csv=]"));
+		return 1;
+	}
+	FParse::Value(*Params, TEXT("Host="), ConnectionParams.Host);
+
+	FString CompressionName;
+	if (FParse::Value(*Params, TEXT("Compression="), CompressionName) && CompressionName.Equals(TEXT("none"), ESearchCase::IgnoreCase))
+	{
+		ConnectionParams.Compression = ESpacetimeCompression::None;
+	}
+
+	int32 NumClients = 100;
+	double RampUp = 10.0;
+	double Duration = 60.0;
+	double TickRate = 60.0;
+	double ReportInterval = 5.0;
+	FParse::Value(*Params, TEXT("Clients="), NumClients);
+	FParse::Value(*Params, TEXT("RampUp="), RampUp);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("TickRate="), TickRate);
+	FParse::Value(*Params, TEXT("ReportInterval="), ReportInterval);
+	NumClients = FMath::Max(NumClients, 1);
+	TickRate = FMath::Max(TickRate, 1.0);
+	ReportInterval = FMath::Max(ReportInterval, 0.1);
+
+	FString QueryList;
+	FParse::Value(*Params, TEXT("Query="), QueryList, /*bShouldStopOnSeparator=*/ false);
+	TArray<FString> Queries;
+	QueryList.ParseIntoArray(Queries, TEXT(";"));
+
+	FString Reducer;
+	FString ArgsHex;
+	FString ProfileText = TEXT("0:1");
+	FParse::Value(*Params, TEXT("Reducer="), Reducer);
+	FParse::Value(*Params, TEXT("Args="), ArgsHex);
+	FParse::Value(*Params, TEXT("Profile="), ProfileText, /*bShouldStopOnSeparator=*/ false);
+
+	TArray<uint8> Args;
+	if (ArgsHex.Len() % 2 != 0 || !Algo::AllOf(ArgsHex, [](const TCHAR Ch) { return FChar::IsHexDigit(Ch); }))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] -Args must be hex bytes, got '%s'"), *ArgsHex);
+		return 1;
+	}
+	Args.SetNumUninitialized(ArgsHex.Len() / 2);
+	HexToBytes(ArgsHex, Args.GetData());
+
+	TArray<FRatePoint> Profile;
+	FString Error;
+	if (!ParseProfile(ProfileText, Profile, Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[spacetime] Invalid -Profile: %s"), *Error);
+		return 1;
+	}
+
+	FString CsvPath;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvPath))
+	{
+		FFileHelper::SaveStringToFile(
+			TEXT("Seconds,Clients,CallsPerSecond,CommittedPerSecond,FailedPerSecond,RttP50Ms,RttP99Ms,BytesInPerSecond,MessagesInPerSecond,BytesOutPerSecond,MessagesOutPerSecond,MemoryPerClientKB\n"),
+			*CsvPath);
+	}
+
+	FModuleManager::Get().LoadModuleChecked(TEXT("WebSockets"));
+
+	UE_LOG(LogTemp, Display, TEXT("[spacetime] Swarm of %d clients against '%s' on %s: %d queries, reducer '%s', profile %s"),
+		NumClients, *ConnectionParams.DatabaseName, *ConnectionParams.Host, Queries.Num(), *Reducer, *ProfileText);
+
+	const uint64 BaselineMemory = FPlatformMemory::GetStats().UsedPhysical;
+	TArray<FVirtualClient> Clients;
+	Clients.SetNum(NumClients);
+	FCounters Interval;
+	FCounters Total;
+	int32 NumStarted = 0;
+	int32 NumConnected = 0;
+	int32 LoggedErrors = 0;
+
+	auto StartClient = [&](const int32 Index)
+	{
+		FVirtualClient& Virtual = Clients[Index];
+		Virtual.Client = MakeShared<FSpacetimeDBClient>(MakeShared<FSpacetimeWebSocketTransport>(), MakeShared<FSpacetimeClientCache>());
+		Virtual.CallsDue = FMath::FRand();	// so the swarm does not call in lockstep
+
+		// Delegates are bound to the stack frame; the clients are destroyed before it unwinds
+		Virtual.Client->OnConnected.AddLambda([&Clients, &NumConnected, Index]
+		{
+			Clients[Index].bConnected = true;
+			++NumConnected;
+		});
+		Virtual.Client->OnDisconnected.AddLambda([&Clients, &NumConnected, &Interval, &LoggedErrors, Index](const FString& Reason)
+		{
+			if (Clients[Index].bConnected)
+			{
+				--NumConnected;
+			}
+			Clients[Index].bConnected = false;
+			++Interval.Disconnects;
+			if (LoggedErrors++ < MaxLoggedErrors)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[spacetime] Virtual client %d disconnected: %s"), Index, *Reason);
+			}
+		});
+		auto CompleteCall = [&Clients, Index](const uint32 RequestId, FSpacetimeLatencyHistogram& RoundTrips)
+		{
+			double StartTime;
+			if (Clients[Index].CallStartTimes.RemoveAndCopyValue(RequestId, StartTime))
+			{
+				RoundTrips.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+			}
+		};
+		Virtual.Client->OnReducerCommitted.AddLambda([&Interval, CompleteCall](const FString& ReducerName, const uint32 RequestId)
+		{
+			++Interval.Committed;
+			CompleteCall(RequestId, Interval.RoundTrips);
+		});
+		Virtual.Client->OnReducerFailed.AddLambda([&Interval, &LoggedErrors, CompleteCall, Index](const FString& ReducerName, const uint32 RequestId, const FString& Reason)
+		{
+			++Interval.Failed;
+			CompleteCall(RequestId, Interval.RoundTrips);
+			if (LoggedErrors++ < MaxLoggedErrors)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[spacetime] Virtual client %d: reducer '%s' failed: %s"), Index, *ReducerName, *Reason);
+			}
+		});
+
+		if (!Queries.IsEmpty())
+		{
+			Virtual.Subscriptions = MakeShared<FSpacetimeSubscriptionManager>(Virtual.Client.ToSharedRef());
+			for (const FString& Query : Queries)
+			{
+				Virtual.Subscriptions->Subscribe(Query);
+			}
+		}
+		Virtual.Client->Connect(ConnectionParams);
+	};
+
+	auto Report = [&](const double Elapsed, const double Seconds, const FCounters& Counters, const TCHAR* Label)
+	{
+		FSpacetimeClientMetrics Sum;
+		for (const FVirtualClient& Virtual : Clients)
+		{
+			if (Virtual.Client.IsValid())
+			{
+				const FSpacetimeClientMetrics& Metrics = Virtual.Client->GetMetrics();
+				Sum.BytesInPerSecond += Metrics.BytesInPerSecond;
+				Sum.MessagesInPerSecond += Metrics.MessagesInPerSecond;
+				Sum.BytesOutPerSecond += Metrics.BytesOutPerSecond;
+				Sum.MessagesOutPerSecond += Metrics.MessagesOutPerSecond;
+			}
+		}
+
+		const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+		const double MemoryPerClientKB = UsedMemory > BaselineMemory
+			? (UsedMemory - BaselineMemory) / 1024.0 / FMath::Max(NumStarted, 1)
+			: 0.0;
+		const double P50 = Counters.RoundTrips.GetPercentile(0.5);
+		const double P99 = Counters.RoundTrips.GetPercentile(0.99);
+
+		UE_LOG(LogTemp, Display, TEXT("[spacetime] %s %.0fs: %d/%d clients connected, %d disconnects | calls %.1f/s, committed %.1f/s, failed %.1f/s, "
+			"round trip p50 %.1f ms p99 %.1f ms | in %.1f KB/s %.0f msg/s, out %.1f KB/s %.0f msg/s | %.1f KB per client"),
+			Label, Elapsed, NumConnected, NumClients, Counters.Disconnects,
+			Counters.Calls / Seconds, Counters.Committed / Seconds, Counters.Failed / Seconds, P50, P99,
+			Sum.BytesInPerSecond / 1024.0, Sum.MessagesInPerSecond, Sum.BytesOutPerSecond / 1024.0, Sum.MessagesOutPerSecond,
+			MemoryPerClientKB);
+
+		if (!CsvPath.IsEmpty())
+		{
+			FFileHelper::SaveStringToFile(
+				FString::Printf(TEXT("%.1f,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f,%.1f,%.0f,%.1f,%.1f\n"),
+					Elapsed, NumConnected, Counters.Calls / Seconds, Counters.Committed / Seconds, Counters.Failed / Seconds, P50, P99,
+					Sum.BytesInPerSecond, Sum.MessagesInPerSecond, Sum.BytesOutPerSecond, Sum.MessagesOutPerSecond, MemoryPerClientKB),
+				*CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+		}
+	};
+
+	// One loop drives every client: answers and events reach them as game thread tasks, and
+	// OnEndFrame flushes their sends and samples their metrics
+	const double Start = FPlatformTime::Seconds();
+	const double End = Start + RampUp + Duration;
+	double LastTick = Start;
+	double IntervalStart = Start;
+	while (!IsEngineExitRequested())
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (Now >= End)
+		{
+			break;
+		}
+		const double DeltaTime = Now - LastTick;
+		const double Elapsed = Now - Start;
+		LastTick = Now;
+
+		const int32 NumDue = RampUp > 0.0
+			? FMath::Min(NumClients, FMath::CeilToInt32(NumClients * Elapsed / RampUp))
+			: NumClients;
+		for (; NumStarted < NumDue; ++NumStarted)
+		{
+			StartClient(NumStarted);
+		}
+
+		if (!Reducer.IsEmpty())
+		{
+			const double Rate = EvaluateProfile(Profile, Elapsed);
+			for (FVirtualClient& Virtual : Clients)
+			{
+				if (!Virtual.bConnected)
+				{
+					continue;
+				}
+				for (Virtual.CallsDue += Rate * DeltaTime; Virtual.CallsDue >= 1.0; Virtual.CallsDue -= 1.0)
+				{
+					Virtual.CallStartTimes.Add(Virtual.Client->CallReducer(Reducer, Args), Now);
+					++Interval.Calls;
+				}
+			}
+		}
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+		FCoreDelegates::OnEndFrame.Broadcast();
+
+		if (Now - IntervalStart >= ReportInterval)
+		{
+			Report(Elapsed, Now - IntervalStart, Interval, TEXT("Swarm"));
+			Total.Merge(Interval);
+			Interval = {};
+			IntervalStart = Now;
+		}
+
+		const double Spare = 1.0 / TickRate - (FPlatformTime::Seconds() - Now);
+		if (Spare > 0.0)
+		{
+			FPlatformProcess::SleepNoStats(Spare);
+		}
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	Total.Merge(Interval);
+	Report(Now - Start, FMath::Max(Now - Start, 0.001), Total, TEXT("Swarm total over"));
+
+	for (FVirtualClient& Virtual : Clients)
+	{
+		if (Virtual.Client.IsValid())
+		{
+			Virtual.Client->Disconnect();
+		}
+	}
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	Clients.Empty();
+	return 0;
+}
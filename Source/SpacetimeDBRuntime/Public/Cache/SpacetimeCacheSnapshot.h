@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Cache/SpacetimeClientCache.h"
+
+/**
+ * The rows of a client cache, persisted so a restarted game does not wait for the initial
+ * subscription before it has data.
+ *
+ * A snapshot stores each table's rows as the server sent them, with the schema fingerprint of the
+ * generated code that cached them. Loading maps the file read-only and queues its rows like a
+ * server transaction, so lazy tables serve them straight from the mapped pages and decoded tables
+ * decode them on the cache worker; either way they are visible within a frame or two.
+ *
+ * The snapshot's rows are then reconciled with the server in the background: once the
+ * subscriptions were applied, Release queues the snapshot's rows for deletion. Rows the server
+ * also sent only drop the snapshot's reference and are not reported, rows that no longer exist
+ * leave the cache, and new ones arrived with the subscription.
+ *
+ * The same applies on reconnect, where the server sends every subscribed row again: Capture the
+ * cache before resubscribing and Release the capture once the subscriptions were applied.
+ *
+ * FSpacetimeDBClient loads the snapshot on Connect with FSpacetimeConnectionParams::bLoadCacheSnapshot,
+ * and FSpacetimeSubscriptionManager releases it, or captures and releases on reconnect. Games that
+ * subscribe otherwise release FSpacetimeDBClient::TakeLoadedSnapshot themselves. Saving is left to the game.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeCacheSnapshot
+{
+public:
+	~FSpacetimeCacheSnapshot();
+
+	/** Saved/SpacetimeDB/<DatabaseName>.stdbcache */
+	static FString GetDefaultPath(const FString& DatabaseName);
+
+	/**
+	 * Game thread. Copies the rows of every table of Cache; the file is written on a pool thread.
+	 * The file must not be mapped by a loaded snapshot at the time.
+	 * @return Whether the file was written
+	 */
+	static TFuture<bool> SaveAsync(const FSpacetimeClientCache& Cache, const FString& Path, uint32 SchemaFingerprint);
+
+	/**
+	 * Game thread. Maps a snapshot and queues its rows for Cache.
+	 * @return The loaded snapshot, or nullptr and OutError if there is none, it is damaged or it was
+	 *         saved with another schema; those are deleted
+	 */
+	static TSharedPtr<FSpacetimeCacheSnapshot> Load(
+		const FString& Path,
+		uint32 SchemaFingerprint,
+		const TSharedRef<FSpacetimeClientCache>& Cache,
+		FString& OutError);
+
+	/** Game thread. Takes the rows currently in Cache, to be released once the server sent them again. */
+	static TSharedRef<FSpacetimeCacheSnapshot> Capture(const TSharedRef<FSpacetimeClientCache>& Cache);
+
+	/** Queues the snapshot's rows for deletion; does nothing the second time. Released when destroyed at the latest. */
+	void Release();
+
+	/** Forgets the snapshot's rows without releasing them, such as once a later Capture holds them too. */
+	void Discard();
+
+	int32 GetNumRows() const;
+
+private:
+	FSpacetimeCacheSnapshot() = default;
+
+	/** Rows of the snapshot, as a transaction with one delta per table. */
+	static bool Parse(const FSpacetimeBsatnPagePtr& Page, uint32 SchemaFingerprint, TArray<FSpacetimeTableDelta>& OutTables, FString& OutError);
+
+	static void Serialize(const FSpacetimeClientCache& Cache, uint32 SchemaFingerprint, TArray<uint8>& OutData);
+
+	TWeakPtr<FSpacetimeClientCache> Cache;
+	TArray<FSpacetimeTableDelta> Tables;
+	bool bReleased = false;
+};
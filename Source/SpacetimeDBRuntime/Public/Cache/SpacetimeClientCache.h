@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Cache/SpacetimeTableCache.h"
+#include "Client/SpacetimePipelineStage.h"
+
+/** The table changes of one committed server transaction. */
+struct FSpacetimeTransactionUpdate
+{
+	TArray<FSpacetimeTableDelta> Tables;
+
+	/** Set if the transaction answers one of our reducer calls; empty Tables then also mean it failed. */
+	uint32 RequestId = 0;
+};
+
+/**
+ * Client-side replica of the subscribed rows of a SpacetimeDB database.
+ *
+ * Transactions are decoded in arrival order on a single pool worker, where deletes and inserts
+ * of the same primary key are paired into updates. That worker is the last stage of the client's
+ * receive pipeline: it holds a bounded number of transactions, and stops while the decoded rows
+ * waiting for the game thread exceed SetMaxBacklog. Once per frame the game thread applies
+ * everything decoded so far and each table broadcasts one coalesced change set, instead of
+ * one event per row.
+ *
+ * Applying is time-sliced: tables are published in priority order until the frame budget is
+ * spent, and whatever is left carries over to the next frame. Large initial subscriptions and
+ * bursts then arrive a few frames later instead of causing a hitch.
+ *
+ * Reducer calls can be predicted: their expected rows are applied right away and replaced by
+ * the server's transaction for the call once that is published (see TSpacetimeTableCache).
+ *
+ * Must be owned by a TSharedPtr.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeClientCache : public TSharedFromThis<FSpacetimeClientCache>
+{
+public:
+	~FSpacetimeClientCache();
+
+	/**
+	 * Game thread. Tables should be registered before any transaction for them arrives.
+	 * @param Priority Tables with a higher priority are published first when over budget
+	 */
+	void RegisterTable(const TSharedRef<ISpacetimeTableCache>& Table, int32 Priority = 0);
+
+	TSharedPtr<ISpacetimeTableCache> FindTable(const FString& TableName) const;
+
+	template <typename TableType>
+	TSharedPtr<TableType> FindTable(const FString& TableName) const
+	{
+		return StaticCastSharedPtr<TableType>(FindTable(TableName));
+	}
+
+	/** Any thread. Queues a transaction for decoding; its changes are published on a following frame. */
+	void EnqueueTransaction(FSpacetimeTransactionUpdate&& Update);
+
+	/** Any thread. Queues a transaction unless the decode queue is full; the transaction is only moved from on success. */
+	bool TryEnqueueTransaction(FSpacetimeTransactionUpdate& Update);
+
+	/** Called from the decoding worker when the queue has room again after TryEnqueueTransaction was refused. */
+	TFunction<void()> OnRoom;
+
+	/** Game thread. Applies and broadcasts what was decoded so far within the frame budget; driven by the core ticker once per frame. */
+	void PublishStagedChanges();
+
+	/** Milliseconds per frame spent applying changes; 0 or less for no limit. */
+	void SetFrameBudgetMs(const double InFrameBudgetMs) { FrameBudgetMs = InFrameBudgetMs; }
+	double GetFrameBudgetMs() const { return FrameBudgetMs; }
+
+	/** Any thread. Decoded rows waiting to be applied, across all tables. */
+	int32 GetBacklog() const;
+
+	/** Decoded rows waiting to be applied above which decoding pauses until they are published; 0 or less for no limit. */
+	void SetMaxBacklog(const int32 InMaxBacklog) { MaxBacklog = InMaxBacklog; }
+
+	/**
+	 * Game thread. Runs a predictor for the reducer call RequestId, which applies the rows it expects
+	 * through the tables' Predict functions. Must run before the call is sent.
+	 */
+	void Predict(uint32 RequestId, TFunctionRef<void()> Predictor);
+
+	/** Game thread. Rolls back every prediction whose call will not be answered, such as after a disconnect. */
+	void RollBackPredictions();
+
+	/** Game thread. Visits every registered table. */
+	void ForEachTable(TFunctionRef<void(const ISpacetimeTableCache&)> Functor) const;
+
+private:
+	bool Tick(float DeltaTime);
+
+	/** Game thread. Reports the backlog and the size of every table to the stats, trace and CSV profiler. */
+	void ReportStats() const;
+
+	using FDecodeStage = TSpacetimePipelineStage<FSpacetimeTransactionUpdate>;
+
+	/** Any thread. The decoding stage, created on first use. */
+	FDecodeStage& GetDecodeStage();
+
+	/** Worker. False while the backlog is over its limit. */
+	bool TryDecodeAndStage(const FSpacetimeTransactionUpdate& Update);
+	void DecodeAndStage(const FSpacetimeTransactionUpdate& Update);
+
+	TMap<FString, TSharedRef<ISpacetimeTableCache>> Tables;
+
+	/** Tables holding predicted rows, by the request id of the call they were predicted for. */
+	TMap<uint32, TArray<TSharedRef<ISpacetimeTableCache>>> PredictedTables;
+
+	/** Highest priority first; tables of equal priority in registration order. */
+	TArray<TPair<int32, TSharedRef<ISpacetimeTableCache>>> PublishOrder;
+
+	double FrameBudgetMs = 2.0;
+
+	std::atomic<int32> MaxBacklog{1 << 20};
+
+	TSharedPtr<FDecodeStage, ESPMode::ThreadSafe> DecodeStage;
+
+	/** Guards Tables, PredictedTables, DecodeStage and the tables' staged changes, so a transaction is published all at once. */
+	mutable FCriticalSection StagingLock;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
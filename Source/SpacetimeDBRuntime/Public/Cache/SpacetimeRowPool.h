@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Client/SpacetimeRingBuffer.h"
+
+/**
+ * Clears a value for reuse. Generated types get an overload that resets every member in place, so
+ * strings keep their capacity; other types are simply replaced by a default-constructed value.
+ */
+template <typename ValueType>
+void SpacetimeReset(ValueType& Value)
+{
+	Value = ValueType();
+}
+
+/**
+ * Recycled rows of one table, so churn of short-lived rows reuses their string allocations
+ * instead of going through the allocator for every insert and delete.
+ *
+ * Rows retire on the game thread, once their change set was broadcast, and are reset there.
+ * Most go back to the decoding worker through a lock-free ring; the rest stay with the game
+ * thread, which needs rows of its own for the copies it keeps in the cache. Rows beyond the pool
+ * size are freed.
+ */
+template <typename RowType>
+class TSpacetimeRowPool
+{
+public:
+	explicit TSpacetimeRowPool(const int32 InSize)
+		: Size(InSize)
+		, Recycled(InSize, ESpacetimeRingOverflow::Reject)
+	{
+	}
+
+	/** Decoding worker. A cleared row, recycled if one is available. */
+	RowType Acquire()
+	{
+		if (!Unused.IsEmpty())
+		{
+			return Unused.Pop();
+		}
+		RowType Row;
+		Recycled.Dequeue(Row);
+		return Row;
+	}
+
+	/** Decoding worker. Takes back a row Acquire handed out that was never published, e.g. when decoding failed. */
+	void ReturnUnused(RowType&& Row)
+	{
+		if (Unused.Num() < Size)
+		{
+			SpacetimeReset(Row);
+			Unused.Add(MoveTemp(Row));
+		}
+	}
+
+	/** Game thread. A cleared row, recycled if one is available. */
+	RowType AcquireOnGameThread()
+	{
+		return Spare.IsEmpty() ? RowType() : Spare.Pop();
+	}
+
+	/** Game thread. Resets a row that is no longer referenced and keeps it for reuse. */
+	void Release(RowType&& Row)
+	{
+		SpacetimeReset(Row);
+
+		// The game thread keeps a share for itself, the worker gets the rest
+		if (Spare.Num() < Size / 4 || !Recycled.Push(Row))
+		{
+			if (Spare.Num() < Size)
+			{
+				Spare.Add(MoveTemp(Row));
+			}
+		}
+	}
+
+	/**
+	 * Game thread. Fills the pool with new rows, for instance to reserve the usual length of hot
+	 * string columns up front; resetting keeps the capacity, so it survives every reuse.
+	 */
+	void Prime(const int32 NumRows, const TFunctionRef<void(RowType&)> Reserve)
+	{
+		for (int32 i = 0; i < NumRows; ++i)
+		{
+			RowType Row;
+			Reserve(Row);
+			Release(MoveTemp(Row));
+		}
+	}
+
+	/** Any thread. Occupancy of the ring towards the decoding worker. */
+	FSpacetimeRingStats GetStats() const { return Recycled.GetStats(); }
+
+private:
+	const int32 Size;
+	TSpacetimeRingBuffer<RowType, ESpacetimeRingProducers::Single> Recycled;
+
+	/** Game thread only. */
+	TArray<RowType> Spare;
+
+	/** Decoding worker only. */
+	TArray<RowType> Unused;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Codec/SpacetimeBsatnReader.h"
+
+/**
+ * BSATN rows back to back, shared by every row in it: the rows_data of one received row list,
+ * or the rows of a table in a mapped cache snapshot.
+ */
+class FSpacetimeBsatnPage
+{
+public:
+	explicit FSpacetimeBsatnPage(TArray<uint8>&& InData)
+		: Data(MoveTemp(InData))
+		, Bytes(Data)
+	{
+	}
+
+	virtual ~FSpacetimeBsatnPage() = default;
+
+	TConstArrayView<uint8> GetBytes() const { return Bytes; }
+
+protected:
+	/** For pages whose bytes are owned by a derived class, such as a mapped file region. */
+	explicit FSpacetimeBsatnPage(const TConstArrayView<uint8> InBytes)
+		: Bytes(InBytes)
+	{
+	}
+
+private:
+	TArray<uint8> Data;
+	TConstArrayView<uint8> Bytes;
+};
+
+using FSpacetimeBsatnPagePtr = TSharedPtr<const FSpacetimeBsatnPage, ESPMode::ThreadSafe>;
+
+/** One row inside a page. Keeps the whole page alive. */
+struct FSpacetimeRowRef
+{
+	FSpacetimeBsatnPagePtr Page;
+	int32 Offset = 0;
+	int32 Num = 0;
+
+	TConstArrayView<uint8> GetBytes() const
+	{
+		return Page.IsValid() ? Page->GetBytes().Slice(Offset, Num) : TConstArrayView<uint8>();
+	}
+};
+
+/**
+ * A cached row that stays BSATN-encoded in its received page and decodes fields on demand.
+ *
+ * Generated views derive from this with one getter per column: columns in the fixed-size prefix
+ * of the row are read at precomputed offsets, later ones by skipping the variable-size columns
+ * before them. Materialize() decodes the whole row into its USTRUCT.
+ */
+class FSpacetimeRowView
+{
+public:
+	FSpacetimeRowView() = default;
+
+	explicit FSpacetimeRowView(FSpacetimeRowRef InRow)
+		: Row(MoveTemp(InRow))
+	{
+	}
+
+	bool IsValid() const { return Row.Page.IsValid(); }
+
+	TConstArrayView<uint8> GetRowBytes() const { return Row.GetBytes(); }
+
+protected:
+	/** A reader positioned at a byte offset of the row. */
+	FSpacetimeBsatnReader MakeReader(const int32 Offset) const
+	{
+		FSpacetimeBsatnReader Reader(GetRowBytes());
+		Reader.Skip(Offset);
+		return Reader;
+	}
+
+	template <typename StructType>
+	StructType MaterializeAs() const
+	{
+		StructType Out;
+		FSpacetimeBsatnReader Reader(GetRowBytes());
+		SpacetimeReadBsatn(Reader, Out);
+		return Out;
+	}
+
+private:
+	FSpacetimeRowRef Row;
+};
+
+/** Identity of a cached row: its BSATN bytes, compared by content. Points into storage owned by the cache. */
+struct FSpacetimeRowKey
+{
+	TConstArrayView<uint8> Bytes;
+
+	friend bool operator==(const FSpacetimeRowKey& A, const FSpacetimeRowKey& B)
+	{
+		return A.Bytes.Num() == B.Bytes.Num()
+			&& FMemory::Memcmp(A.Bytes.GetData(), B.Bytes.GetData(), A.Bytes.Num()) == 0;
+	}
+
+	friend uint32 GetTypeHash(const FSpacetimeRowKey& Key)
+	{
+		return FCrc::MemCrc32(Key.Bytes.GetData(), Key.Bytes.Num());
+	}
+};
@@ -0,0 +1,937 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Cache/SpacetimeRowPool.h"
+#include "Cache/SpacetimeRowView.h"
+#include "Cache/SpacetimeTableIndex.h"
+#include "Codec/SpacetimeBsatnReader.h"
+#include "Codec/SpacetimeBsatnWriter.h"
+
+#include <atomic>
+
+/** A row's BSATN bytes in an allocation of their own. */
+using FSpacetimeRowBytes = TArray<uint8>;
+
+/** Inserts and deletes of one table within one server transaction, still BSATN-encoded. */
+struct FSpacetimeTableDelta
+{
+	FString TableName;
+	TArray<FSpacetimeRowRef> Inserts;
+	TArray<FSpacetimeRowRef> Deletes;
+};
+
+/** Decoded changes of one table that have not been applied to its cache yet. */
+struct FSpacetimeStagedChanges
+{
+	virtual ~FSpacetimeStagedChanges() = default;
+
+	/** Set if the changes answer one of our reducer calls, whose prediction they replace. */
+	uint32 RequestId = 0;
+};
+
+/** Type-erased table cache, as driven by FSpacetimeClientCache. */
+class ISpacetimeTableCache
+{
+public:
+	virtual ~ISpacetimeTableCache() = default;
+
+	virtual const FString& GetTableName() const = 0;
+
+	/**
+	 * Decodes a delta, pairing a delete and an insert of the same primary key into an update.
+	 * Thread-safe; does not touch the cached rows.
+	 * @return Decoded changes, or nullptr and OutError if a row could not be decoded
+	 */
+	virtual TUniquePtr<FSpacetimeStagedChanges> DecodeDelta(const FSpacetimeTableDelta& Delta, FString& OutError) const = 0;
+
+	/** Queues decoded changes for the next publish. Externally synchronized by the client cache. */
+	virtual void Stage(TUniquePtr<FSpacetimeStagedChanges> Changes) = 0;
+
+	/** Takes everything staged so far for publishing. Externally synchronized by the client cache. */
+	virtual bool SwapStaged() = 0;
+
+	/**
+	 * Game thread. Applies the swapped changes to the cache, in order, and broadcasts what was
+	 * applied as a single change set.
+	 * @param Deadline FPlatformTime::Seconds() after which the rest is left for the next call
+	 * @return true if nothing is left to apply
+	 */
+	virtual bool Publish(double Deadline) = 0;
+
+	/** Any thread. Rows staged or swapped but not applied yet. */
+	virtual int32 GetBacklog() const = 0;
+
+	/** Game thread. Whether rows were predicted for the reducer call RequestId and not reconciled yet. */
+	virtual bool HasPrediction(uint32 RequestId) const = 0;
+
+	/** Game thread. Visits the BSATN bytes of every cached row, with the number of subscriptions holding it. */
+	virtual void ForEachRowBytes(TFunctionRef<void(TConstArrayView<uint8> /*Bytes*/, int32 /*RefCount*/)> Functor) const = 0;
+
+	/** Game thread. Distinct cached rows. */
+	virtual int32 GetNumRows() const = 0;
+
+	/**
+	 * Game thread. Memory held by the cached rows: their slots, lookup and encoded bytes. Heap memory
+	 * of decoded members, such as strings, is not counted; it is usually close to the encoded size.
+	 */
+	virtual SIZE_T GetAllocatedSize() const = 0;
+};
+
+/** Everything that happened to one table since the previous frame. */
+template <typename RowType>
+struct TSpacetimeTableChangeSet
+{
+	TArray<RowType> Inserts;
+
+	/** Old and new row, for primary keys that were deleted and re-inserted by the same transaction. */
+	TArray<TPair<RowType, RowType>> Updates;
+
+	TArray<RowType> Deletes;
+
+	bool IsEmpty() const
+	{
+		return Inserts.IsEmpty() && Updates.IsEmpty() && Deletes.IsEmpty();
+	}
+};
+
+/**
+ * Client-side cache of the rows of a single SpacetimeDB table.
+ *
+ * Rows are identified by their BSATN bytes, which is how the server refers to them in
+ * subsequent deletes. Identical rows delivered by overlapping subscriptions are reference
+ * counted and only leave the cache once every subscription has deleted them.
+ *
+ * RowType is either a decoded USTRUCT, for which the cache keeps a compact copy of the row's
+ * bytes, or a generated FSpacetimeRowView. Views are not decoded at all: the cache keeps the
+ * received pages alive instead, which suits large, mostly-read tables such as static world data.
+ *
+ * Rows are decoded on a worker thread, but the cache itself is only ever read and written on
+ * the game thread, so queries need no locking.
+ *
+ * Decoded rows are recycled: rows that left the cache, once their change set was broadcast, and
+ * decoded rows that were never cached are reset and reused for the next decoded rows, and so are
+ * the byte buffers of cached rows. Steady churn, such as short-lived projectiles, then stops
+ * allocating once the pool is warm.
+ *
+ * Decoded tables also accept predicted changes for a reducer call in flight, which are applied
+ * at once and reconciled when the server's transaction for that call is published: changes the
+ * server confirms are not reported again, the rest of the prediction is rolled back, and what the
+ * server did differently is reported as usual. A corrected row with a primary key is reported as
+ * an update from the predicted to the authoritative row.
+ *
+ * Generated table classes derive from this, register their secondary indexes with AddIndex and
+ * describe their primary key, if any. Decoded RowTypes need a SpacetimeReadBsatn overload, and
+ * a SpacetimeWriteBsatn overload for predictions.
+ */
+template <typename RowType>
+class TSpacetimeTableCache : public ISpacetimeTableCache
+{
+public:
+	static constexpr bool bLazyRows = TIsDerivedFrom<RowType, FSpacetimeRowView>::Value;
+
+	/** Rows and row buffers each table keeps for reuse. */
+	static constexpr int32 DefaultRowPoolSize = 256;
+
+	explicit TSpacetimeTableCache(FString InTableName, const int32 RowPoolSize = DefaultRowPoolSize)
+		: TableName(MoveTemp(InTableName))
+		, RowPool(RowPoolSize)
+	{
+	}
+
+	/**
+	 * Broadcast on the game thread, at most once per frame, with every change applied since the previous broadcast.
+	 * Over the client cache's frame budget, the rest of a batch follows on the next frames.
+	 */
+	TMulticastDelegate<void(const TSpacetimeTableChangeSet<RowType>&)> OnChanged;
+
+	virtual const FString& GetTableName() const override
+	{
+		return TableName;
+	}
+
+	/**
+	 * Inserts a row, or bumps the reference count of an identical row already cached.
+	 * Does not broadcast OnChanged.
+	 * @param bOutAdded Set to true if the row was not cached before
+	 * @return Handle of the cached row
+	 */
+	FSpacetimeRowHandle Insert(const TConstArrayView<uint8> RowBytes, RowType Row, bool* bOutAdded = nullptr)
+	{
+		if (const FSpacetimeRowHandle* Existing = HandlesByBytes.Find(FSpacetimeRowKey{RowBytes}))
+		{
+			++Slots[*Existing].RefCount;
+			if (bOutAdded) *bOutAdded = false;
+			return *Existing;
+		}
+
+		const FSpacetimeRowHandle Handle = Slots.Add({MoveTemp(Row), FSpacetimeRowBytes(), 1});
+		if constexpr (!bLazyRows)
+		{
+			FSpacetimeRowBytes& OwnedBytes = Slots[Handle].OwnedBytes;
+			if (!SpareBytes.IsEmpty())
+			{
+				OwnedBytes = SpareBytes.Pop();
+			}
+			OwnedBytes.Reset();
+			OwnedBytes.Append(RowBytes.GetData(), RowBytes.Num());
+			OwnedBytesSize += OwnedBytes.GetAllocatedSize();
+		}
+		HandlesByBytes.Add(FSpacetimeRowKey{GetRowBytes(Slots[Handle])}, Handle);
+		for (const auto& Index : Indexes)
+		{
+			Index->OnRowInserted(Handle, Slots[Handle].Row);
+		}
+		if (bOutAdded) *bOutAdded = true;
+		return Handle;
+	}
+
+	/**
+	 * Drops one reference to the row with the given bytes. Does not broadcast OnChanged.
+	 * @param RowBytes BSATN bytes of the row, as sent by the server
+	 * @param OutRow   Receives the removed row, if it left the cache
+	 * @return true if the row left the cache
+	 */
+	bool Delete(const TConstArrayView<uint8> RowBytes, RowType* OutRow = nullptr)
+	{
+		const FSpacetimeRowHandle* Found = HandlesByBytes.Find(FSpacetimeRowKey{RowBytes});
+		if (!Found)
+		{
+			return false;
+		}
+
+		const FSpacetimeRowHandle Handle = *Found;
+		if (--Slots[Handle].RefCount > 0)
+		{
+			return false;
+		}
+
+		for (const auto& Index : Indexes)
+		{
+			Index->OnRowDeleted(Handle, Slots[Handle].Row);
+		}
+		// The key points into the slot, so it goes first
+		HandlesByBytes.Remove(FSpacetimeRowKey{RowBytes});
+		FSlot& Slot = Slots[Handle];
+		if (OutRow)
+		{
+			*OutRow = MoveTemp(Slot.Row);
+		}
+		else
+		{
+			RecycleRow(MoveTemp(Slot.Row));
+		}
+		if constexpr (!bLazyRows)
+		{
+			OwnedBytesSize -= Slot.OwnedBytes.GetAllocatedSize();
+			if (SpareBytes.Num() < DefaultRowPoolSize)
+			{
+				SpareBytes.Add(MoveTemp(Slot.OwnedBytes));
+			}
+		}
+		Slots.RemoveAt(Handle);
+		return true;
+	}
+
+	void Empty()
+	{
+		for (const auto& Index : Indexes)
+		{
+			Index->Empty();
+		}
+		HandlesByBytes.Empty();
+		Slots.Empty();
+		OwnedBytesSize = 0;
+		Predictions.Empty();
+	}
+
+	/**
+	 * Game thread. Inserts a row predicted for the reducer call RequestId; broadcast with the next
+	 * change set and reconciled when the server's answer to the call is published.
+	 * Only called from predictors run by FSpacetimeClientCache::Predict.
+	 */
+	void PredictInsert(const uint32 RequestId, const RowType& Row)
+	{
+		if (PredictRow(RequestId, Row, true))
+		{
+			PredictedChanges.Inserts.Add(Row);
+		}
+	}
+
+	/** Game thread. Deletes a row predicted for the reducer call RequestId; see PredictInsert. */
+	void PredictDelete(const uint32 RequestId, const RowType& Row)
+	{
+		if (PredictRow(RequestId, Row, false))
+		{
+			PredictedChanges.Deletes.Add(Row);
+		}
+	}
+
+	/** Game thread. Replaces a row, typically one with the same primary key; see PredictInsert. */
+	void PredictUpdate(const uint32 RequestId, const RowType& OldRow, const RowType& NewRow)
+	{
+		const bool bRemoved = PredictRow(RequestId, OldRow, false);
+		const bool bAdded = PredictRow(RequestId, NewRow, true);
+		if (bRemoved && bAdded)
+		{
+			PredictedChanges.Updates.Emplace(OldRow, NewRow);
+		}
+		else if (bRemoved)
+		{
+			PredictedChanges.Deletes.Add(OldRow);
+		}
+		else if (bAdded)
+		{
+			PredictedChanges.Inserts.Add(NewRow);
+		}
+	}
+
+	/**
+	 * Game thread. Adds rows to the pool ahead of time; Reserve can reserve the usual length of hot
+	 * string columns, and reused rows keep that capacity.
+	 */
+	void PrimeRowPool(const int32 NumRows, const TFunctionRef<void(RowType&)> Reserve)
+	{
+		static_assert(!bLazyRows, "Lazy tables do not decode rows");
+		RowPool.Prime(NumRows, Reserve);
+	}
+
+	/** Any thread. Occupancy of the pool's hand-over to the decoding worker. */
+	FSpacetimeRingStats GetRowPoolStats() const
+	{
+		return RowPool.GetStats();
+	}
+
+	virtual bool HasPrediction(const uint32 RequestId) const override
+	{
+		return Predictions.Contains(RequestId);
+	}
+
+	virtual void ForEachRowBytes(const TFunctionRef<void(TConstArrayView<uint8>, int32)> Functor) const override
+	{
+		for (const FSlot& Slot : Slots)
+		{
+			Functor(GetRowBytes(Slot), Slot.RefCount);
+		}
+	}
+
+	virtual int32 GetNumRows() const override
+	{
+		return Slots.Num();
+	}
+
+	virtual SIZE_T GetAllocatedSize() const override
+	{
+		return Slots.GetAllocatedSize() + HandlesByBytes.GetAllocatedSize() + OwnedBytesSize;
+	}
+
+	const RowType* Find(const TConstArrayView<uint8> RowBytes) const
+	{
+		const FSpacetimeRowHandle* Handle = HandlesByBytes.Find(FSpacetimeRowKey{RowBytes});
+		return Handle ? &Slots[*Handle].Row : nullptr;
+	}
+
+	bool IsValid(const FSpacetimeRowHandle Handle) const
+	{
+		return Slots.IsValidIndex(Handle);
+	}
+
+	const RowType& Get(const FSpacetimeRowHandle Handle) const
+	{
+		return Slots[Handle].Row;
+	}
+
+	int32 Num() const
+	{
+		return Slots.Num();
+	}
+
+	template <typename FunctorType>
+	void ForEachRow(FunctorType&& Functor) const
+	{
+		for (const FSlot& Slot : Slots)
+		{
+			Functor(Slot.Row);
+		}
+	}
+
+	virtual TUniquePtr<FSpacetimeStagedChanges> DecodeDelta(const FSpacetimeTableDelta& Delta, FString& OutError) const override
+	{
+		auto Changes = MakeUnique<FStaged>();
+		const bool bPairByKey = HasPrimaryKey();
+
+		TArray<FStagedRow> Deletes;
+		TBitArray<> Paired(false, Delta.Deletes.Num());
+
+		// A row that fails to decode drops the whole delta; the rows acquired for it so far go back to the pool
+		auto Discard = [&]() -> TUniquePtr<FSpacetimeStagedChanges>
+		{
+			for (int32 i = 0; i < Deletes.Num(); ++i)
+			{
+				if (bPairByKey && !Paired[i])
+				{
+					ReturnRow(MoveTemp(Deletes[i].Row));
+				}
+			}
+			for (TPair<FStagedRow, FStagedRow>& Updated : Changes->Updates)
+			{
+				ReturnRow(MoveTemp(Updated.Key.Row));
+				ReturnRow(MoveTemp(Updated.Value.Row));
+			}
+			for (FStagedRow& Inserted : Changes->Inserts)
+			{
+				ReturnRow(MoveTemp(Inserted.Row));
+			}
+			return nullptr;
+		};
+
+		// Deleted rows only need decoding to find their primary key; the cached copy is what gets published
+		Deletes.Reserve(Delta.Deletes.Num());
+		for (const FSpacetimeRowRef& RowRef : Delta.Deletes)
+		{
+			FStagedRow& Deleted = Deletes.Add_GetRef({RowRef, bPairByKey ? AcquireRow() : RowType()});
+			if (bPairByKey && !DecodeRow(RowRef, Deleted.Row, OutError))
+			{
+				return Discard();
+			}
+		}
+
+		TMap<uint32, TArray<int32>> DeletesByKey;
+		if (bPairByKey)
+		{
+			for (int32 i = 0; i < Deletes.Num(); ++i)
+			{
+				uint32 KeyHash;
+				GetPrimaryKeyHash(Deletes[i].Row, KeyHash);
+				DeletesByKey.FindOrAdd(KeyHash).Add(i);
+			}
+		}
+
+		Changes->Inserts.Reserve(Delta.Inserts.Num());
+		for (const FSpacetimeRowRef& RowRef : Delta.Inserts)
+		{
+			FStagedRow Inserted{RowRef, AcquireRow()};
+			if (!DecodeRow(RowRef, Inserted.Row, OutError))
+			{
+				ReturnRow(MoveTemp(Inserted.Row));
+				return Discard();
+			}
+
+			uint32 KeyHash;
+			const TArray<int32>* Candidates = bPairByKey && GetPrimaryKeyHash(Inserted.Row, KeyHash)
+				? DeletesByKey.Find(KeyHash)
+				: nullptr;
+			const int32* Match = Candidates
+				? Candidates->FindByPredicate([&](const int32 i)
+				{
+					return !Paired[i] && HasSamePrimaryKey(Deletes[i].Row, Inserted.Row);
+				})
+				: nullptr;
+
+			if (Match)
+			{
+				Paired[*Match] = true;
+				Changes->Updates.Emplace(MoveTemp(Deletes[*Match]), MoveTemp(Inserted));
+			}
+			else
+			{
+				Changes->Inserts.Add(MoveTemp(Inserted));
+			}
+		}
+
+		for (int32 i = 0; i < Deletes.Num(); ++i)
+		{
+			if (!Paired[i])
+			{
+				Changes->Deletes.Add(MoveTemp(Deletes[i]));
+			}
+		}
+
+		return Changes;
+	}
+
+	virtual void Stage(TUniquePtr<FSpacetimeStagedChanges> Changes) override
+	{
+		FStaged* Staged = static_cast<FStaged*>(Changes.Release());
+		Backlog += Staged->Num();
+		Pending.Emplace(Staged);
+	}
+
+	virtual bool SwapStaged() override
+	{
+		Swapped.Append(MoveTemp(Pending));
+		Pending.Reset();
+		return !Swapped.IsEmpty() || !PredictedChanges.IsEmpty();
+	}
+
+	virtual bool Publish(const double Deadline) override
+	{
+		// Checking the clock per row would cost more than applying most rows
+		constexpr int32 RowsPerClockCheck = 64;
+
+		// Predictions made since the last publish were applied already
+		TSpacetimeTableChangeSet<RowType>& ChangeSet = Published;
+		ChangeSet.Inserts.Append(MoveTemp(PredictedChanges.Inserts));
+		ChangeSet.Updates.Append(MoveTemp(PredictedChanges.Updates));
+		ChangeSet.Deletes.Append(MoveTemp(PredictedChanges.Deletes));
+		PredictedChanges = {};
+		int32 Applied = 0;
+		int32 SinceClockCheck = 0;
+		bool bOutOfTime = false;
+
+		// Transactions are applied in the order the server sent them, resuming where the last call stopped
+		while (!bOutOfTime && Resume.Staged < Swapped.Num())
+		{
+			FStaged& Changes = *Swapped[Resume.Staged];
+
+			FPrediction* Prediction = Resume.Row == 0 && Changes.RequestId != 0 ? Predictions.Find(Changes.RequestId) : nullptr;
+			if (Prediction)
+			{
+				// Reconciled in one go, so a prediction is never left half undone
+				Reconcile(Changes, *Prediction, ChangeSet);
+				Predictions.Remove(Changes.RequestId);
+				Applied += Changes.Num();
+				SinceClockCheck += Changes.Num();
+				Resume.Row = Changes.Num();
+			}
+
+			for (const int32 NumRows = Changes.Num(); Resume.Row < NumRows; ++Resume.Row)
+			{
+				// Counted apart from Applied, which reconciliations advance by whole transactions
+				if (SinceClockCheck >= RowsPerClockCheck)
+				{
+					SinceClockCheck = 0;
+					if (FPlatformTime::Seconds() > Deadline)
+					{
+						bOutOfTime = true;
+						break;
+					}
+				}
+				ApplyRow(Changes, Resume.Row, ChangeSet);
+				++Applied;
+				++SinceClockCheck;
+			}
+			if (!bOutOfTime)
+			{
+				// Done with this transaction; free it now rather than with the whole batch
+				Swapped[Resume.Staged].Reset();
+				++Resume.Staged;
+				Resume.Row = 0;
+			}
+		}
+		if (!bOutOfTime)
+		{
+			Swapped.Reset();
+			Resume = {};
+		}
+		Backlog -= Applied;
+
+		if (!ChangeSet.IsEmpty())
+		{
+			OnChanged.Broadcast(ChangeSet);
+		}
+
+		// Listeners are done with the rows; the arrays keep their capacity for the next frame
+		for (RowType& Row : ChangeSet.Inserts)
+		{
+			RecycleRow(MoveTemp(Row));
+		}
+		for (TPair<RowType, RowType>& Updated : ChangeSet.Updates)
+		{
+			RecycleRow(MoveTemp(Updated.Key));
+			RecycleRow(MoveTemp(Updated.Value));
+		}
+		for (RowType& Row : ChangeSet.Deletes)
+		{
+			RecycleRow(MoveTemp(Row));
+		}
+		ChangeSet.Inserts.Reset();
+		ChangeSet.Updates.Reset();
+		ChangeSet.Deletes.Reset();
+		return !bOutOfTime;
+	}
+
+	virtual int32 GetBacklog() const override
+	{
+		return Backlog;
+	}
+
+protected:
+	/** Overridden by generated tables that declare a primary key. */
+	virtual bool HasPrimaryKey() const { return false; }
+	virtual bool GetPrimaryKeyHash(const RowType& Row, uint32& OutHash) const { return false; }
+	virtual bool HasSamePrimaryKey(const RowType& A, const RowType& B) const { return false; }
+
+	/** Registers a secondary index and backfills it with the rows already cached. */
+	void AddIndex(const TSharedRef<ISpacetimeTableIndex<RowType>>& Index)
+	{
+		for (auto It = Slots.CreateConstIterator(); It; ++It)
+		{
+			Index->OnRowInserted(It.GetIndex(), It->Row);
+		}
+		Indexes.Add(Index);
+	}
+
+	/** Maps index lookup results back to rows. */
+	void ResolveHandles(const TArray<FSpacetimeRowHandle>& Handles, TArray<const RowType*>& OutRows) const
+	{
+		OutRows.Reserve(OutRows.Num() + Handles.Num());
+		for (const FSpacetimeRowHandle Handle : Handles)
+		{
+			OutRows.Add(&Slots[Handle].Row);
+		}
+	}
+
+	bool DecodeRow(const FSpacetimeRowRef& RowRef, RowType& OutRow, FString& OutError) const
+	{
+		if constexpr (bLazyRows)
+		{
+			// Views decode their fields when read
+			OutRow = RowType(RowRef);
+			return true;
+		}
+		else
+		{
+			FSpacetimeBsatnReader Reader(RowRef.GetBytes());
+			if (!SpacetimeReadBsatn(Reader, OutRow) || !Reader.IsAtEnd())
+			{
+				OutError = FString::Printf(TEXT("Failed to decode a %d byte row of table '%s' at offset %d"),
+					RowRef.Num, *TableName, Reader.GetOffset());
+				return false;
+			}
+			return true;
+		}
+	}
+
+private:
+	struct FSlot
+	{
+		RowType Row;
+
+		/** Decoded rows only; views point into their page. */
+		FSpacetimeRowBytes OwnedBytes;
+
+		int32 RefCount = 0;
+	};
+
+	static TConstArrayView<uint8> GetRowBytes(const FSlot& Slot)
+	{
+		if constexpr (bLazyRows)
+		{
+			return Slot.Row.GetRowBytes();
+		}
+		else
+		{
+			return Slot.OwnedBytes;
+		}
+	}
+
+	struct FStagedRow
+	{
+		FSpacetimeRowRef Ref;
+		RowType Row;
+	};
+
+	struct FStaged : FSpacetimeStagedChanges
+	{
+		TArray<FStagedRow> Inserts;
+		TArray<TPair<FStagedRow, FStagedRow>> Updates;
+		TArray<FStagedRow> Deletes;
+
+		int32 Num() const
+		{
+			return Deletes.Num() + Updates.Num() + Inserts.Num();
+		}
+	};
+
+	/** A row change made by a predictor. */
+	struct FPredictedRow
+	{
+		FSpacetimeRowBytes Bytes;
+		RowType Row;
+		bool bInserted = false;
+
+		/** Whether the row appeared or disappeared, rather than just changing its reference count. */
+		bool bVisible = false;
+	};
+
+	struct FPrediction
+	{
+		/** In the order they were made. */
+		TArray<FPredictedRow> Rows;
+	};
+
+	/** Predicted rows taken back out of the cache while their transaction is reconciled, by their bytes. */
+	struct FReconciliation
+	{
+		TMap<FSpacetimeRowKey, RowType*> Retracted;
+		TMap<FSpacetimeRowKey, RowType*> Restored;
+	};
+
+	/** Applies one predicted change and records it. @return true if the row appeared or disappeared */
+	bool PredictRow(const uint32 RequestId, const RowType& Row, const bool bInsert)
+	{
+		static_assert(!bLazyRows, "Lazy tables hold rows of the server's pages and cannot take predictions");
+		check(IsInGameThread());
+
+		FPredictedRow Predicted{FSpacetimeRowBytes(), Row, bInsert, false};
+		FSpacetimeBsatnWriter Writer(Predicted.Bytes);
+		if (!SpacetimeWriteBsatn(Writer, Row))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[spacetime] Ignoring a prediction for table '%s' that cannot be encoded"), *TableName);
+			return false;
+		}
+
+		if (bInsert)
+		{
+			Insert(Predicted.Bytes, Row, &Predicted.bVisible);
+		}
+		else if (Find(Predicted.Bytes))
+		{
+			Predicted.bVisible = Delete(Predicted.Bytes, &Predicted.Row);
+		}
+		else
+		{
+			// Not cached, so nothing to undo either
+			return false;
+		}
+
+		const bool bVisible = Predicted.bVisible;
+		Predictions.FindOrAdd(RequestId).Rows.Add(MoveTemp(Predicted));
+		return bVisible;
+	}
+
+	/**
+	 * Replaces a prediction with the server's transaction for the same call: the prediction is undone
+	 * unreported, the transaction applied, and only the differences between both end up in ChangeSet.
+	 */
+	void Reconcile(FStaged& Changes, FPrediction& Prediction, TSpacetimeTableChangeSet<RowType>& ChangeSet)
+	{
+		FReconciliation Reconciling;
+		for (int32 i = Prediction.Rows.Num() - 1; i >= 0; --i)
+		{
+			FPredictedRow& Predicted = Prediction.Rows[i];
+			if (Predicted.bInserted)
+			{
+				Delete(Predicted.Bytes, &Predicted.Row);
+				if (Predicted.bVisible)
+				{
+					Reconciling.Retracted.Add(FSpacetimeRowKey{Predicted.Bytes}, &Predicted.Row);
+				}
+			}
+			else
+			{
+				Insert(Predicted.Bytes, Predicted.Row);
+				if (Predicted.bVisible)
+				{
+					Reconciling.Restored.Add(FSpacetimeRowKey{Predicted.Bytes}, &Predicted.Row);
+				}
+			}
+		}
+
+		const int32 FirstInsert = ChangeSet.Inserts.Num();
+		for (int32 Row = 0; Row < Changes.Num(); ++Row)
+		{
+			ApplyRow(Changes, Row, ChangeSet, &Reconciling);
+		}
+
+		// Restored rows the server did not delete are back for good
+		for (const auto& [Key, Row] : Reconciling.Restored)
+		{
+			ChangeSet.Inserts.Add(*Row);
+		}
+
+		// Predicted rows the server did not insert are gone; replaced by the server's version if it has the same key
+		for (const auto& [Key, Row] : Reconciling.Retracted)
+		{
+			// Only rows inserted by this transaction; those before were reported already
+			int32 Correction = INDEX_NONE;
+			if (HasPrimaryKey())
+			{
+				for (int32 Index = FirstInsert; Index < ChangeSet.Inserts.Num(); ++Index)
+				{
+					if (HasSamePrimaryKey(*Row, ChangeSet.Inserts[Index]))
+					{
+						Correction = Index;
+						break;
+					}
+				}
+			}
+			if (Correction != INDEX_NONE)
+			{
+				ChangeSet.Updates.Emplace(MoveTemp(*Row), MoveTemp(ChangeSet.Inserts[Correction]));
+				ChangeSet.Inserts.RemoveAt(Correction);
+			}
+			else
+			{
+				ChangeSet.Deletes.Add(MoveTemp(*Row));
+			}
+		}
+	}
+
+	/**
+	 * Applies the RowIndex-th change of a transaction: deletes first, then updates, then inserts.
+	 * While reconciling, changes already shown by the prediction are applied unreported.
+	 */
+	void ApplyRow(FStaged& Changes, int32 RowIndex, TSpacetimeTableChangeSet<RowType>& ChangeSet, FReconciliation* Reconciling = nullptr)
+	{
+		// Both report whether the row appeared or disappeared; a row that is not reported is recycled
+		auto ApplyDelete = [this, Reconciling](const TConstArrayView<uint8> Bytes, RowType& OutOldRow)
+		{
+			const bool bConfirmed = Reconciling && Reconciling->Restored.Remove(FSpacetimeRowKey{Bytes}) > 0;
+			if (!Delete(Bytes, &OutOldRow))
+			{
+				return false;
+			}
+			if (bConfirmed)
+			{
+				RecycleRow(MoveTemp(OutOldRow));
+				return false;
+			}
+			return true;
+		};
+		auto ApplyInsert = [this, Reconciling](const TConstArrayView<uint8> Bytes, const RowType& Row)
+		{
+			const bool bConfirmed = Reconciling && Reconciling->Retracted.Remove(FSpacetimeRowKey{Bytes}) > 0;
+			// Another reference to a cached row needs no copy
+			bool bAdded;
+			Insert(Bytes, HandlesByBytes.Contains(FSpacetimeRowKey{Bytes}) ? RowType() : CopyRow(Row), &bAdded);
+			return bAdded && !bConfirmed;
+		};
+
+		if (RowIndex < Changes.Deletes.Num())
+		{
+			FStagedRow& Deleted = Changes.Deletes[RowIndex];
+			RowType OldRow;
+			if (ApplyDelete(Deleted.Ref.GetBytes(), OldRow))
+			{
+				ChangeSet.Deletes.Add(MoveTemp(OldRow));
+			}
+			if (HasPrimaryKey())
+			{
+				// Only decoded to pair updates
+				RecycleRow(MoveTemp(Deleted.Row));
+			}
+			return;
+		}
+		RowIndex -= Changes.Deletes.Num();
+
+		if (RowIndex < Changes.Updates.Num())
+		{
+			TPair<FStagedRow, FStagedRow>& Updated = Changes.Updates[RowIndex];
+			RowType OldRow;
+			const bool bRemoved = ApplyDelete(Updated.Key.Ref.GetBytes(), OldRow);
+			const bool bAdded = ApplyInsert(Updated.Value.Ref.GetBytes(), Updated.Value.Row);
+
+			if (bRemoved && bAdded)
+			{
+				ChangeSet.Updates.Emplace(MoveTemp(OldRow), MoveTemp(Updated.Value.Row));
+			}
+			else if (bRemoved)
+			{
+				ChangeSet.Deletes.Add(MoveTemp(OldRow));
+				RecycleRow(MoveTemp(Updated.Value.Row));
+			}
+			else if (bAdded)
+			{
+				ChangeSet.Inserts.Add(MoveTemp(Updated.Value.Row));
+			}
+			else
+			{
+				RecycleRow(MoveTemp(Updated.Value.Row));
+			}
+			RecycleRow(MoveTemp(Updated.Key.Row));
+			return;
+		}
+		RowIndex -= Changes.Updates.Num();
+
+		FStagedRow& Inserted = Changes.Inserts[RowIndex];
+		if (ApplyInsert(Inserted.Ref.GetBytes(), Inserted.Row))
+		{
+			ChangeSet.Inserts.Add(MoveTemp(Inserted.Row));
+		}
+		else
+		{
+			RecycleRow(MoveTemp(Inserted.Row));
+		}
+	}
+
+	/** Worker. A cleared row to decode into. */
+	RowType AcquireRow() const
+	{
+		if constexpr (bLazyRows)
+		{
+			return RowType();
+		}
+		else
+		{
+			return RowPool.Acquire();
+		}
+	}
+
+	/** Worker. Hands back a row from AcquireRow that will not be published. */
+	void ReturnRow(RowType&& Row) const
+	{
+		if constexpr (!bLazyRows)
+		{
+			RowPool.ReturnUnused(MoveTemp(Row));
+		}
+	}
+
+	/** Game thread. A copy for the cache to keep, made in a recycled row. */
+	RowType CopyRow(const RowType& Row)
+	{
+		if constexpr (bLazyRows)
+		{
+			return Row;
+		}
+		else
+		{
+			RowType Copy = RowPool.AcquireOnGameThread();
+			Copy = Row;
+			return Copy;
+		}
+	}
+
+	/** Game thread. Hands a row nobody refers to anymore back to the pool. */
+	void RecycleRow(RowType&& Row)
+	{
+		if constexpr (!bLazyRows)
+		{
+			RowPool.Release(MoveTemp(Row));
+		}
+	}
+
+	/** Where the last out-of-time Publish stopped. */
+	struct FResumePoint
+	{
+		int32 Staged = 0;
+		int32 Row = 0;
+	};
+
+	FString TableName;
+
+	TSparseArray<FSlot> Slots;
+	TMap<FSpacetimeRowKey, FSpacetimeRowHandle> HandlesByBytes;
+	TArray<TSharedRef<ISpacetimeTableIndex<RowType>>> Indexes;
+
+	TArray<TUniquePtr<FStaged>> Pending;
+	TArray<TUniquePtr<FStaged>> Swapped;
+	FResumePoint Resume;
+	std::atomic<int32> Backlog{0};
+
+	/** By request id; game thread only. */
+	TMap<uint32, FPrediction> Predictions;
+	TSpacetimeTableChangeSet<RowType> PredictedChanges;
+
+	/** Game thread. The change set being published, kept to reuse its arrays. */
+	TSpacetimeTableChangeSet<RowType> Published;
+
+	/** Acquired from by the decoding worker, which is why it is mutable. */
+	mutable TSpacetimeRowPool<RowType> RowPool;
+
+	/** Game thread. Byte buffers of rows that left the cache. */
+	TArray<FSpacetimeRowBytes> SpareBytes;
+
+	/** Allocated size of the cached rows' OwnedBytes. */
+	SIZE_T OwnedBytesSize = 0;
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+
+/** Stable slot of a row inside a table cache's row storage. */
+using FSpacetimeRowHandle = int32;
+
+/**
+ * A client-side secondary index over the rows of a single table cache.
+ * The owning cache keeps every registered index up to date on insert and delete.
+ */
+template <typename RowType>
+class ISpacetimeTableIndex
+{
+public:
+	virtual ~ISpacetimeTableIndex() = default;
+
+	virtual void OnRowInserted(FSpacetimeRowHandle Handle, const RowType& Row) = 0;
+	virtual void OnRowDeleted(FSpacetimeRowHandle Handle, const RowType& Row) = 0;
+	virtual void Empty() = 0;
+};
+
+/**
+ * How an index compares and hashes its keys. The default goes through the key type's own operators;
+ * generated tables pass their own where those disagree with SpacetimeDB, e.g. for case-sensitive strings.
+ */
+template <typename KeyType>
+struct TSpacetimeIndexKeyFuncs
+{
+	static bool Equals(const KeyType& A, const KeyType& B) { return A == B; }
+	static bool Less(const KeyType& A, const KeyType& B) { return A < B; }
+	static uint32 GetKeyHash(const KeyType& Key) { return GetTypeHash(Key); }
+};
+
+/**
+ * Equality index, mirrors a SpacetimeDB 'Hash' index.
+ * KeyFuncs needs Equals and GetKeyHash.
+ */
+template <typename RowType, typename KeyType, typename KeyFuncs = TSpacetimeIndexKeyFuncs<KeyType>>
+class TSpacetimeHashIndex final : public ISpacetimeTableIndex<RowType>
+{
+public:
+	using FKeyGetter = TFunction<KeyType(const RowType&)>;
+
+	explicit TSpacetimeHashIndex(FKeyGetter InGetKey)
+		: GetKey(MoveTemp(InGetKey))
+	{
+	}
+
+	virtual void OnRowInserted(const FSpacetimeRowHandle Handle, const RowType& Row) override
+	{
+		Buckets.FindOrAdd(GetKey(Row)).Add(Handle);
+	}
+
+	virtual void OnRowDeleted(const FSpacetimeRowHandle Handle, const RowType& Row) override
+	{
+		const KeyType Key = GetKey(Row);
+		if (TArray<FSpacetimeRowHandle>* Bucket = Buckets.Find(Key))
+		{
+			Bucket->RemoveSingleSwap(Handle);
+			if (Bucket->IsEmpty())
+			{
+				Buckets.Remove(Key);
+			}
+		}
+	}
+
+	virtual void Empty() override
+	{
+		Buckets.Empty();
+	}
+
+	/** Appends the handles of every row whose key equals Key. O(1) on average. */
+	void Find(const KeyType& Key, TArray<FSpacetimeRowHandle>& OutHandles) const
+	{
+		if (const TArray<FSpacetimeRowHandle>* Bucket = Buckets.Find(Key))
+		{
+			OutHandles.Append(*Bucket);
+		}
+	}
+
+private:
+	struct FBucketKeyFuncs : TDefaultMapKeyFuncs<KeyType, TArray<FSpacetimeRowHandle>, false>
+	{
+		static bool Matches(const KeyType& A, const KeyType& B) { return KeyFuncs::Equals(A, B); }
+		static uint32 GetKeyHash(const KeyType& Key) { return KeyFuncs::GetKeyHash(Key); }
+	};
+
+	FKeyGetter GetKey;
+	TMap<KeyType, TArray<FSpacetimeRowHandle>, FDefaultSetAllocator, FBucketKeyFuncs> Buckets;
+};
+
+/**
+ * Ordered index, mirrors a SpacetimeDB 'BTree' index.
+ * Backed by a sorted array of (key, handle) entries, so lookups and range scans are O(log n).
+ * KeyFuncs needs Less.
+ */
+template <typename RowType, typename KeyType, typename KeyFuncs = TSpacetimeIndexKeyFuncs<KeyType>>
+class TSpacetimeBTreeIndex final : public ISpacetimeTableIndex<RowType>
+{
+public:
+	using FKeyGetter = TFunction<KeyType(const RowType&)>;
+
+	explicit TSpacetimeBTreeIndex(FKeyGetter InGetKey)
+		: GetKey(MoveTemp(InGetKey))
+	{
+	}
+
+	virtual void OnRowInserted(const FSpacetimeRowHandle Handle, const RowType& Row) override
+	{
+		FEntry Entry{GetKey(Row), Handle};
+		const int32 Position = Algo::UpperBound(Entries, Entry, &FEntry::Less);
+		Entries.Insert(MoveTemp(Entry), Position);
+	}
+
+	virtual void OnRowDeleted(const FSpacetimeRowHandle Handle, const RowType& Row) override
+	{
+		const FEntry Entry{GetKey(Row), Handle};
+		const int32 Position = Algo::LowerBound(Entries, Entry, &FEntry::Less);
+		if (Entries.IsValidIndex(Position) && Entries[Position].Handle == Handle)
+		{
+			Entries.RemoveAt(Position);
+		}
+	}
+
+	virtual void Empty() override
+	{
+		Entries.Empty();
+	}
+
+	/** Appends the handles of every row whose key equals Key. */
+	void Find(const KeyType& Key, TArray<FSpacetimeRowHandle>& OutHandles) const
+	{
+		FindRange(Key, Key, OutHandles);
+	}
+
+	/** Appends the handles of every row whose key lies in the closed range [Min, Max], in key order. */
+	void FindRange(const KeyType& Min, const KeyType& Max, TArray<FSpacetimeRowHandle>& OutHandles) const
+	{
+		const int32 First = Algo::LowerBoundBy(Entries, Min, &FEntry::Key, &KeyFuncs::Less);
+		const int32 Last = Algo::UpperBoundBy(Entries, Max, &FEntry::Key, &KeyFuncs::Less);
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			OutHandles.Add(Entries[Index].Handle);
+		}
+	}
+
+private:
+	struct FEntry
+	{
+		KeyType Key;
+		FSpacetimeRowHandle Handle;
+
+		static bool Less(const FEntry& A, const FEntry& B)
+		{
+			if (KeyFuncs::Less(A.Key, B.Key)) return true;
+			if (KeyFuncs::Less(B.Key, A.Key)) return false;
+			return A.Handle < B.Handle;
+		}
+	};
+
+	FKeyGetter GetKey;
+	TArray<FEntry> Entries;
+};
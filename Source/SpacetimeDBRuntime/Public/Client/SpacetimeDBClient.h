@@ -0,0 +1,275 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Cache/SpacetimeClientCache.h"
+#include "Client/SpacetimePipelineStage.h"
+#include "Client/SpacetimeLatencyHistogram.h"
+#include "Client/SpacetimeProtocol.h"
+#include "Client/SpacetimeRingBuffer.h"
+#include "Client/SpacetimeTransport.h"
+#include "Codec/SpacetimeCompression.h"
+
+#include <atomic>
+
+class FSpacetimeCacheSnapshot;
+
+struct FSpacetimeConnectionParams
+{
+	/** host[:port], optionally prefixed with http:// or https:// */
+	FString Host = TEXT("localhost:3000");
+
+	FString DatabaseName;
+
+	/** Token received with a previous identity; empty to be assigned a new identity. */
+	FString Token;
+
+	bool bUseSsl = false;
+
+	/** Brotli is not available in Unreal and falls back to gzip. */
+	ESpacetimeCompression Compression = ESpacetimeCompression::Gzip;
+
+	/**
+	 * Connect maps the database's snapshot at FSpacetimeCacheSnapshot::GetDefaultPath into a cache
+	 * that is still empty, so its rows can be read before the subscriptions are applied. Saving the
+	 * snapshot, with FSpacetimeCacheSnapshot::SaveAsync, is up to the game.
+	 */
+	bool bLoadCacheSnapshot = false;
+
+	/** The generated F<Module>Tables::SchemaFingerprint; snapshots saved with another schema are discarded. */
+	uint32 SchemaFingerprint = 0;
+};
+
+/** Throughput and latency of a client, sampled about once per second on the game thread. */
+struct FSpacetimeClientMetrics
+{
+	double BytesInPerSecond = 0.0;
+	double BytesOutPerSecond = 0.0;
+	double MessagesInPerSecond = 0.0;
+	double MessagesOutPerSecond = 0.0;
+
+	/** Protocol decoding only; rows are decoded by the cache. */
+	double DecodeMicrosecondsPerMessage = 0.0;
+
+	/** From the call until its answer reached the game thread, over the last 10 to 20 seconds. */
+	double ReducerRttP50Ms = 0.0;
+	double ReducerRttP99Ms = 0.0;
+
+	int32 ReducerCallsInFlight = 0;
+};
+
+/**
+ * Connection to a SpacetimeDB database that keeps a client cache up to date.
+ *
+ * Received messages go through a pipeline of bounded stages on pool threads: decompression,
+ * then protocol decoding, then the cache's row decoding, which stages per-table change sets for
+ * the game thread to swap in. Each stage keeps message order and works on the next message while
+ * the following stage works on the previous one. A stage that falls behind stops the ones before
+ * it, down to the socket, whose messages are always accepted; the game thread only ever sees
+ * decoded results, through the cache's per-frame change events and the delegates below.
+ *
+ * Client messages are queued in a lock-free ring and handed to the transport together at the end
+ * of the frame, so a frame that calls hundreds of reducers never waits on the socket.
+ *
+ * Throughput, latency and queue depths are reported through 'stat SpacetimeDB', as counters and
+ * CPU events on the SpacetimeDB Insights trace channel, in the SpacetimeDB CSV profiler category,
+ * and through GetMetrics.
+ *
+ * Must be owned by a TSharedPtr.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeDBClient : public TSharedFromThis<FSpacetimeDBClient>
+{
+public:
+	FSpacetimeDBClient(TSharedRef<ISpacetimeTransport> InTransport, TSharedRef<FSpacetimeClientCache> InCache);
+	~FSpacetimeDBClient();
+
+	static FString MakeSubscribeUrl(const FSpacetimeConnectionParams& Params);
+
+	void Connect(const FSpacetimeConnectionParams& Params);
+	void Disconnect();
+	bool IsConnected() const;
+
+	/** Any thread. Queues an encoded client message; queued messages are sent in order at the end of the frame. */
+	void Send(TArray<uint8>&& Message);
+
+	/** Game thread. Sends the queued client messages now. */
+	void FlushSends();
+
+	/** Game thread. A fresh request id to correlate a client message with the server's answer. */
+	uint32 NextRequestId() { return ++LastRequestId; }
+
+	/**
+	 * Game thread. Calls a reducer without waiting for it; its outcome arrives as OnReducerCommitted
+	 * or OnReducerFailed with the returned request id.
+	 * @param Args The reducer's arguments, BSATN-encoded as a product
+	 */
+	uint32 CallReducer(const FString& ReducerName, TConstArrayView<uint8> Args);
+
+	/**
+	 * Predicts the effect of a call on the cache, through the tables' Predict functions; the
+	 * server's answer replaces the prediction once it is published. Runs on the game thread,
+	 * from CallReducer, before the call is sent.
+	 */
+	using FReducerPredictor = TFunction<void(uint32 /*RequestId*/, TConstArrayView<uint8> /*Args*/)>;
+
+	/** Game thread. Predicts every following call of a reducer; an unbound predictor removes it. */
+	void SetReducerPredictor(const FString& ReducerName, FReducerPredictor Predictor);
+
+	/** Any thread. A snapshot of the compression counters since the last Connect. */
+	FSpacetimeCompressionStats GetCompressionStats() const;
+
+	/** Any thread. Messages received but not handed to the cache yet. */
+	int32 GetReceiveBacklog() const;
+
+	/** Game thread. The latest sample of throughput and latency. */
+	const FSpacetimeClientMetrics& GetMetrics() const { return Metrics; }
+
+	/** Any thread. Occupancy and overflow counters of the receive stages and the send queue. */
+	FSpacetimeRingStats GetDecompressQueueStats() const;
+	FSpacetimeRingStats GetDecodeQueueStats() const;
+	FSpacetimeRingStats GetSendQueueStats() const { return Outgoing.GetStats(); }
+
+	const TSharedRef<FSpacetimeClientCache>& GetCache() const { return Cache; }
+
+	/**
+	 * Game thread. The snapshot Connect loaded, if any, to be released once the subscriptions were
+	 * applied; FSpacetimeSubscriptionManager takes it when the connection opens.
+	 */
+	TSharedPtr<FSpacetimeCacheSnapshot> TakeLoadedSnapshot() { return MoveTemp(LoadedSnapshot); }
+
+	/** Game thread. Empty until the server sent the identity of this connection. */
+	const FString& GetIdentity() const { return Identity; }
+
+	DECLARE_MULTICAST_DELEGATE(FOnConnected);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnDisconnected, const FString& /*Reason*/);
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnIdentityReceived, const FString& /*Identity*/, const FString& /*Token*/, const FString& /*ConnectionId*/);
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnReducerCommitted, const FString& /*ReducerName*/, uint32 /*RequestId*/);
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnReducerFailed, const FString& /*ReducerName*/, uint32 /*RequestId*/, const FString& /*Error*/);
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSubscriptionError, uint32 /*QueryId*/, const FString& /*Error*/);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnSubscriptionApplied, uint32 /*QueryId*/);
+
+	/** All broadcast on the game thread. */
+	FOnConnected OnConnected;
+	FOnDisconnected OnDisconnected;
+	FOnIdentityReceived OnIdentityReceived;
+	FOnReducerFailed OnReducerFailed;
+
+	/** Only for calls made by this connection; the rows it changed appear with the cache's next change events. */
+	FOnReducerCommitted OnReducerCommitted;
+	FOnSubscriptionError OnSubscriptionError;
+
+	/** The initial rows of the query set are queued for the cache, and appear with its next change events. */
+	FOnSubscriptionApplied OnSubscriptionApplied;
+	FOnSubscriptionApplied OnUnsubscriptionApplied;
+
+private:
+	/** A server message on its way through the receive pipeline; it keeps the progress made on it. */
+	struct FInboundMessage
+	{
+		/** As received, then decompressed. */
+		TArray<uint8> Bytes;
+
+		/** Where the BSATN message starts in Bytes, once decompressed. */
+		int32 MessageOffset = INDEX_NONE;
+
+		/** Bytes came from SpareBuffers, holding the decompressed message, and goes back once decoded. */
+		bool bSpareBuffer = false;
+
+		TOptional<FSpacetimeServerMessage> Decoded;
+	};
+
+	/** Frames arrive one at a time, and each stage pushes into the next from its single draining task. */
+	using FReceiveStage = TSpacetimePipelineStage<FInboundMessage, ESpacetimeRingProducers::Single>;
+
+	/** Game thread. Sets up the pipeline on first use, when AsShared is available. */
+	void CreatePipeline();
+
+	/** Transport's thread. Queues a frame for decompression. */
+	void HandleFrame(TArray<uint8>&& Frame);
+
+	/** Pipeline stages; false if the next stage is full. */
+	bool Decompress(FInboundMessage& Message);
+	bool Decode(FInboundMessage& Message);
+
+	/** Returns a buffer to SpareBuffers, unless the pool is full or the buffer too large to keep. Any thread. */
+	void RecycleBuffer(TArray<uint8>&& Buffer);
+
+	/** Decode stage. Hands the message's rows to the cache, then notifies the game thread. */
+	bool Dispatch(FSpacetimeServerMessage& Message);
+	void Notify(FSpacetimeServerMessage&& Message);
+
+	void RunOnGameThread(TUniqueFunction<void(FSpacetimeDBClient&)>&& Function);
+
+	void HandleEndFrame();
+
+	/** Game thread. Records the round trip of one of our reducer calls, if it was timed. */
+	void CompleteCall(uint32 RequestId);
+
+	/** Game thread. Resamples the metrics once a second, and reports them every frame. */
+	void UpdateMetrics();
+
+	TSharedRef<ISpacetimeTransport> Transport;
+	TSharedRef<FSpacetimeClientCache> Cache;
+
+	/** Loaded by Connect, until taken. */
+	TSharedPtr<FSpacetimeCacheSnapshot> LoadedSnapshot;
+
+	TSharedPtr<FReceiveStage, ESPMode::ThreadSafe> DecompressStage;
+	TSharedPtr<FReceiveStage, ESPMode::ThreadSafe> DecodeStage;
+
+	/** Client messages waiting for the end of the frame; never refuses one, spilling past its capacity. */
+	TSpacetimeRingBuffer<TArray<uint8>, ESpacetimeRingProducers::Multiple> Outgoing{1024, ESpacetimeRingOverflow::Spill};
+	FDelegateHandle EndFrameHandle;
+
+	/** At most this many spare buffers are kept, and none larger than MaxSpareBufferBytes. */
+	static constexpr int32 MaxSpareBuffers = 4;
+	static constexpr int64 MaxSpareBufferBytes = 4 * 1024 * 1024;
+
+	/** Decompression buffers of decoded messages, handed back so decompression rarely allocates. */
+	TQueue<TArray<uint8>, EQueueMode::Mpsc> SpareBuffers;
+	std::atomic<int32> NumSpareBuffers{0};
+
+	/** Only touched by the decode stage; it keeps its allocation between messages. */
+	TArray<uint8> QueryUpdateBuffer;
+
+	/** The decode stage's copy of ConnectionId, to recognize answers to our own calls. */
+	FString WorkerConnectionId;
+
+	TMap<FString, FReducerPredictor> Predictors;
+
+	std::atomic<uint8> NegotiatedCompression{0};
+	std::atomic<uint64> Messages{0};
+	std::atomic<uint64> CompressedMessages{0};
+	std::atomic<uint64> ReceivedBytes{0};
+	std::atomic<uint64> DecompressedBytes{0};
+	std::atomic<uint64> DecodeCycles{0};
+	std::atomic<uint64> DecodedMessages{0};
+	uint64 SentBytes = 0;
+	uint64 SentMessages = 0;
+
+	/** Game thread. Send time of the reducer calls waiting for an answer, by request id. */
+	TMap<uint32, double> CallStartTimes;
+
+	/** Game thread. Round trips of the current and the previous window. */
+	FSpacetimeLatencyHistogram RoundTrips;
+	FSpacetimeLatencyHistogram PreviousRoundTrips;
+	double RoundTripWindowStart = 0.0;
+
+	/** Game thread. Totals at the last sample, to turn them into rates. */
+	struct FMetricsSample
+	{
+		double Time = 0.0;
+		uint64 ReceivedBytes = 0;
+		uint64 Messages = 0;
+		uint64 SentBytes = 0;
+		uint64 SentMessages = 0;
+		uint64 DecodeCycles = 0;
+		uint64 DecodedMessages = 0;
+	};
+	FMetricsSample LastSample;
+	FSpacetimeClientMetrics Metrics;
+
+	FString Identity;
+	FString ConnectionId;
+	uint32 LastRequestId = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Latencies counted in log-spaced buckets, each 10% wider than the last, from 0.1 ms to about
+ * 80 seconds. Percentiles are accurate to the width of a bucket, without keeping any samples.
+ */
+struct FSpacetimeLatencyHistogram
+{
+	static constexpr int32 NumBuckets = 144;
+	static constexpr double FirstBucketMs = 0.1;
+	static constexpr double BucketGrowth = 1.1;
+
+	void Add(const double Milliseconds)
+	{
+		const int32 Bucket = Milliseconds <= FirstBucketMs
+			? 0
+			: FMath::Min(FMath::FloorToInt32(FMath::Loge(Milliseconds / FirstBucketMs) / FMath::Loge(BucketGrowth)), NumBuckets - 1);
+		++Counts[Bucket];
+		++Total;
+	}
+
+	/** Upper bound of the bucket that holds the given fraction of samples, such as 0.99; 0 without samples. */
+	double GetPercentile(const double Fraction) const
+	{
+		if (Total == 0)
+		{
+			return 0.0;
+		}
+
+		const uint64 Rank = FMath::Max<uint64>(1, FMath::CeilToInt64(Fraction * Total));
+		uint64 Seen = 0;
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Seen += Counts[Bucket];
+			if (Seen >= Rank)
+			{
+				return FirstBucketMs * FMath::Pow(BucketGrowth, static_cast<double>(Bucket + 1));
+			}
+		}
+		return FirstBucketMs * FMath::Pow(BucketGrowth, static_cast<double>(NumBuckets));
+	}
+
+	void Merge(const FSpacetimeLatencyHistogram& Other)
+	{
+		for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+		{
+			Counts[Bucket] += Other.Counts[Bucket];
+		}
+		Total += Other.Total;
+	}
+
+	void Reset()
+	{
+		FMemory::Memzero(Counts);
+		Total = 0;
+	}
+
+	uint64 Num() const { return Total; }
+
+private:
+	uint32 Counts[NumBuckets] = {};
+	uint64 Total = 0;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Client/SpacetimeRingBuffer.h"
+
+#include <atomic>
+
+/**
+ * One stage of the receive pipeline: a bounded queue, drained in order by at most one pool task
+ * at a time, so consecutive stages work on consecutive messages concurrently.
+ *
+ * Backpressure never blocks a thread. An item whose result the next stage has no room for stays
+ * at the head of the queue, together with whatever progress was made on it, and draining stops;
+ * the next stage kicks this one as soon as it made room. Meanwhile this queue fills up and
+ * refuses TryPush, which stops the stage before it in turn.
+ *
+ * Items carry their own progress: Process is called again with the same item after it was blocked.
+ * Items are held in a lock-free ring of Capacity slots; whatever is forced past it spills into an
+ * overflow queue. Must be owned by a thread-safe TSharedPtr.
+ */
+template <typename ItemType, ESpacetimeRingProducers Producers = ESpacetimeRingProducers::Multiple>
+class TSpacetimePipelineStage : public TSharedFromThis<TSpacetimePipelineStage<ItemType, Producers>, ESPMode::ThreadSafe>
+{
+public:
+	/** Works on the item at the head; returns false if it has to wait for the next stage. */
+	using FProcess = TFunction<bool(ItemType&)>;
+
+	TSpacetimePipelineStage(const TCHAR* InName, const int32 InCapacity, FProcess InProcess)
+		: Name(InName)
+		, Capacity(InCapacity)
+		, Process(MoveTemp(InProcess))
+		, Queue(InCapacity, ESpacetimeRingOverflow::Spill)
+	{
+	}
+
+	/** Called from the draining task whenever the stage made room after it was full, to resume the stage before it. */
+	TFunction<void()> OnRoom;
+
+	/** Any thread. Queues an item unless the stage is full. */
+	bool TryPush(ItemType& Item)
+	{
+		if (Count.load() >= Capacity)
+		{
+			return false;
+		}
+		Push(MoveTemp(Item));
+		return true;
+	}
+
+	/**
+	 * Any thread. Queues an item whether or not the stage is full; for the entry of the pipeline,
+	 * whose producer cannot wait, such as a socket.
+	 */
+	void Push(ItemType&& Item)
+	{
+		Queue.Push(MoveTemp(Item));
+		if (++Count > Capacity && !bWarnedFull.exchange(true))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[spacetime] Receive stage '%s' is over its capacity of %d; the stages after it fall behind"),
+				Name, Capacity);
+		}
+		Kick();
+	}
+
+	/** Any thread. Resumes draining, if it is not running. */
+	void Kick()
+	{
+		bKicked = true;
+		if (!Queue.IsEmpty() && !bDraining.exchange(true))
+		{
+			Async(EAsyncExecution::ThreadPool, [This = this->AsShared()]
+			{
+				This->Drain();
+			});
+		}
+	}
+
+	/** Any thread. Items queued, including one blocked at the head. */
+	int32 Num() const { return Count.load(); }
+	int32 GetCapacity() const { return Capacity; }
+
+	bool IsBlocked() const { return bBlocked.load(); }
+
+	FSpacetimeRingStats GetStats() const { return Queue.GetStats(); }
+
+private:
+	void Drain()
+	{
+		do
+		{
+			while (ItemType* Item = Queue.Peek())
+			{
+				// A kick from here on means the next stage made room since this attempt
+				bKicked = false;
+				if (!Process(*Item))
+				{
+					bBlocked = true;
+					bDraining = false;
+
+					// Unless it made room while this task was giving up, whoever kicks next restarts it
+					if (bKicked.exchange(false) && !bDraining.exchange(true))
+					{
+						bBlocked = false;
+						continue;
+					}
+					return;
+				}
+				bBlocked = false;
+
+				Queue.Pop();
+				if (Count-- == Capacity)
+				{
+					bWarnedFull = false;
+					if (OnRoom)
+					{
+						OnRoom();
+					}
+				}
+			}
+			bDraining = false;
+
+			// An item may have been queued after the last Peek but before the flag was cleared
+		}
+		while (!Queue.IsEmpty() && !bDraining.exchange(true));
+	}
+
+	const TCHAR* Name;
+	const int32 Capacity;
+	FProcess Process;
+
+	TSpacetimeRingBuffer<ItemType, Producers> Queue;
+	std::atomic<int32> Count{0};
+	std::atomic<bool> bDraining{false};
+	std::atomic<bool> bKicked{false};
+	std::atomic<bool> bBlocked{false};
+	std::atomic<bool> bWarnedFull{false};
+};
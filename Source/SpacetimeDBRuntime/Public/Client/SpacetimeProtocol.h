@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Cache/SpacetimeClientCache.h"
+
+class FSpacetimeBsatnReader;
+
+/** WebSocket subprotocol of the SpacetimeDB v1 BSATN client API. */
+#define SPACETIMEDB_WS_PROTOCOL TEXT("v1.bsatn.spacetimedb")
+
+/** Tag of a v1 ServerMessage. */
+enum class ESpacetimeServerMessage : uint8
+{
+	InitialSubscription = 0,
+	TransactionUpdate = 1,
+	TransactionUpdateLight = 2,
+	IdentityToken = 3,
+	OneOffQueryResponse = 4,
+	SubscribeApplied = 5,
+	UnsubscribeApplied = 6,
+	SubscriptionError = 7,
+	SubscribeMultiApplied = 8,
+	UnsubscribeMultiApplied = 9,
+};
+
+/** Tag of a v1 ClientMessage. */
+enum class ESpacetimeClientMessage : uint8
+{
+	CallReducer = 0,
+	Subscribe = 1,
+	OneOffQuery = 2,
+	SubscribeSingle = 3,
+	SubscribeMulti = 4,
+	Unsubscribe = 5,
+	UnsubscribeMulti = 6,
+};
+
+/** Outcome of the reducer call behind a TransactionUpdate. */
+enum class ESpacetimeUpdateStatus : uint8
+{
+	Committed = 0,
+	Failed = 1,
+	OutOfEnergy = 2,
+};
+
+/**
+ * A decoded server message. Only the fields of its Type are set; messages carrying a database
+ * update have it in Update, whose rows refer to pages copied out of the (reusable) message buffer.
+ */
+struct FSpacetimeServerMessage
+{
+	ESpacetimeServerMessage Type = ESpacetimeServerMessage::InitialSubscription;
+
+	uint32 RequestId = 0;
+	uint32 QueryId = 0;
+	FSpacetimeTransactionUpdate Update;
+
+	// TransactionUpdate
+	ESpacetimeUpdateStatus Status = ESpacetimeUpdateStatus::Committed;
+	FString ReducerName;
+
+	// TransactionUpdate (Failed) and SubscriptionError
+	FString Error;
+
+	// IdentityToken, as 0x-prefixed hex
+	FString Identity;
+	FString ConnectionId;
+	FString Token;
+};
+
+/** BSATN encoding and decoding of the SpacetimeDB v1 WebSocket protocol. */
+class SPACETIMEDBRUNTIME_API FSpacetimeProtocol
+{
+public:
+	/** Subscribes to a set of queries that is later unsubscribed as a whole, by QueryId. */
+	static TArray<uint8> EncodeSubscribeMulti(const TArray<FString>& Queries, uint32 RequestId, uint32 QueryId);
+
+	static TArray<uint8> EncodeUnsubscribeMulti(uint32 RequestId, uint32 QueryId);
+
+	/** Calls a reducer with its BSATN-encoded arguments; the server answers with a TransactionUpdate carrying RequestId. */
+	static TArray<uint8> EncodeCallReducer(const FString& ReducerName, TConstArrayView<uint8> Args, uint32 RequestId);
+
+	/**
+	 * Decodes a server message whose compression envelope was already removed.
+	 * @param Scratch Reusable buffer for query updates that the server compressed individually
+	 */
+	static bool DecodeServerMessage(
+		TConstArrayView<uint8> Message,
+		FSpacetimeServerMessage& OutMessage,
+		TArray<uint8>& Scratch,
+		FString& OutError);
+
+private:
+	static bool ReadDatabaseUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTransactionUpdate& OutUpdate, TArray<uint8>& Scratch);
+	static bool ReadTableUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTableDelta& OutDelta, TArray<uint8>& Scratch);
+	static bool ReadQueryUpdate(FSpacetimeBsatnReader& Reader, FSpacetimeTableDelta& OutDelta);
+	static bool ReadRowList(FSpacetimeBsatnReader& Reader, TArray<FSpacetimeRowRef>& OutRows);
+};
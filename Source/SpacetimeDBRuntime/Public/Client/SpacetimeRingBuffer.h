@@ -0,0 +1,253 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+
+#include <atomic>
+
+/** Who may push into a TSpacetimeRingBuffer; there is always a single consumer. */
+enum class ESpacetimeRingProducers : uint8
+{
+	/** One thread at a time, such as a socket's, or tasks that run one after another. */
+	Single,
+	Multiple,
+};
+
+/** What Push does when the ring is full. */
+enum class ESpacetimeRingOverflow : uint8
+{
+	/** Push returns false and leaves the item to the caller. */
+	Reject,
+
+	/** The item goes to an unbounded overflow queue, which allocates; Push always succeeds. */
+	Spill,
+};
+
+struct FSpacetimeRingStats
+{
+	int32 Capacity = 0;
+
+	/** Items queued, including spilled ones. */
+	int32 Num = 0;
+
+	/** Most items ever held by the ring itself. */
+	int32 HighWatermark = 0;
+
+	uint64 Pushed = 0;
+	uint64 Popped = 0;
+
+	/** Pushes that found the ring full, and were rejected or spilled. */
+	uint64 Overflows = 0;
+};
+
+/**
+ * Bounded lock-free FIFO of preallocated slots with a single consumer.
+ *
+ * Producers claim slots by advancing the tail and publish them through a per-slot sequence
+ * number, so neither side ever takes a lock or allocates while there is room. Head and tail are
+ * on separate cache lines, so producers and the consumer do not invalidate each other's line on
+ * every operation. With a single producer, claiming a slot is a plain store instead of a
+ * compare-and-swap.
+ *
+ * With ESpacetimeRingOverflow::Spill, once an item spilled every following push spills too until
+ * the overflow queue is empty again, so each producer's items stay in order.
+ *
+ * The capacity is rounded up to a power of two.
+ */
+template <typename ItemType, ESpacetimeRingProducers Producers>
+class TSpacetimeRingBuffer
+{
+public:
+	TSpacetimeRingBuffer(const int32 InCapacity, const ESpacetimeRingOverflow InOverflow)
+		: Mask(FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2)) - 1)
+		, Overflow(InOverflow)
+	{
+		Slots.SetNum(Mask + 1);
+		for (uint32 Index = 0; Index <= Mask; ++Index)
+		{
+			Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+		}
+	}
+
+	TSpacetimeRingBuffer(const TSpacetimeRingBuffer&) = delete;
+	TSpacetimeRingBuffer& operator=(const TSpacetimeRingBuffer&) = delete;
+
+	/** Producer. Queues an item; it is only moved from if this returns true. */
+	bool Push(ItemType& Item)
+	{
+		if (Overflow == ESpacetimeRingOverflow::Spill && NumSpilled.load(std::memory_order_acquire) > 0)
+		{
+			SpillItem(Item);
+			return true;
+		}
+		if (PushToRing(Item))
+		{
+			return true;
+		}
+
+		Overflows.fetch_add(1, std::memory_order_relaxed);
+		if (Overflow == ESpacetimeRingOverflow::Spill)
+		{
+			SpillItem(Item);
+			return true;
+		}
+		return false;
+	}
+
+	bool Push(ItemType&& Item) { return Push(Item); }
+
+	/** Consumer. The item at the head, or null if there is none; it stays queued until Pop. */
+	ItemType* Peek()
+	{
+		const uint64 Position = Head.Value.load(std::memory_order_relaxed);
+		FSlot& Slot = Slots[Position & Mask];
+		if (Slot.Sequence.load(std::memory_order_acquire) == Position + 1)
+		{
+			bHeadSpilled = false;
+			return &Slot.Value;
+		}
+
+		// The ring only runs empty before the overflow does, since spilling starts when it is full
+		bHeadSpilled = true;
+		return Spilled.Peek();
+	}
+
+	/** Consumer. Removes the item returned by the last Peek. */
+	void Pop()
+	{
+		if (bHeadSpilled)
+		{
+			Spilled.Pop();
+			NumSpilled.fetch_sub(1, std::memory_order_release);
+			SpillPopped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		const uint64 Position = Head.Value.load(std::memory_order_relaxed);
+		FSlot& Slot = Slots[Position & Mask];
+
+		// Releases what the item held now rather than when the slot is reused
+		Slot.Value = ItemType();
+		Slot.Sequence.store(Position + Mask + 1, std::memory_order_release);
+		Head.Value.store(Position + 1, std::memory_order_release);
+	}
+
+	/** Consumer. Moves the head item out; false if there is none. */
+	bool Dequeue(ItemType& OutItem)
+	{
+		ItemType* Item = Peek();
+		if (!Item)
+		{
+			return false;
+		}
+		OutItem = MoveTemp(*Item);
+		Pop();
+		return true;
+	}
+
+	/** Any thread. Only exact while producers and the consumer are idle. */
+	int32 Num() const
+	{
+		return static_cast<int32>(Tail.Value.load(std::memory_order_relaxed) - Head.Value.load(std::memory_order_relaxed))
+			+ NumSpilled.load(std::memory_order_relaxed);
+	}
+
+	bool IsEmpty() const { return Num() == 0; }
+
+	int32 GetCapacity() const { return static_cast<int32>(Mask + 1); }
+
+	/** Any thread. Counters are read one at a time, so they may disagree slightly while the ring is in use. */
+	FSpacetimeRingStats GetStats() const
+	{
+		FSpacetimeRingStats Stats;
+		Stats.Capacity = GetCapacity();
+		Stats.Num = Num();
+		Stats.HighWatermark = HighWatermark.load(std::memory_order_relaxed);
+		Stats.Pushed = Tail.Value.load(std::memory_order_relaxed) + SpillPushed.load(std::memory_order_relaxed);
+		Stats.Popped = Head.Value.load(std::memory_order_relaxed) + SpillPopped.load(std::memory_order_relaxed);
+		Stats.Overflows = Overflows.load(std::memory_order_relaxed);
+		return Stats;
+	}
+
+private:
+	struct FSlot
+	{
+		/** Position + 1 once the item at Position is published; Position + capacity once it was consumed. */
+		std::atomic<uint64> Sequence{0};
+		ItemType Value;
+	};
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FPaddedCounter
+	{
+		std::atomic<uint64> Value{0};
+	};
+
+	bool PushToRing(ItemType& Item)
+	{
+		uint64 Position = Tail.Value.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			FSlot& Slot = Slots[Position & Mask];
+			const int64 Lag = static_cast<int64>(Slot.Sequence.load(std::memory_order_acquire)) - static_cast<int64>(Position);
+			if (Lag < 0)
+			{
+				// The consumer has not freed this slot since the last lap: full
+				return false;
+			}
+			if (Lag == 0)
+			{
+				if constexpr (Producers == ESpacetimeRingProducers::Single)
+				{
+					Tail.Value.store(Position + 1, std::memory_order_relaxed);
+					break;
+				}
+				else if (Tail.Value.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else
+			{
+				// Another producer claimed it first
+				Position = Tail.Value.load(std::memory_order_relaxed);
+			}
+		}
+
+		FSlot& Slot = Slots[Position & Mask];
+		Slot.Value = MoveTemp(Item);
+		Slot.Sequence.store(Position + 1, std::memory_order_release);
+
+		const int32 Depth = static_cast<int32>(Position + 1 - Head.Value.load(std::memory_order_relaxed));
+		int32 Highest = HighWatermark.load(std::memory_order_relaxed);
+		while (Depth > Highest && !HighWatermark.compare_exchange_weak(Highest, Depth, std::memory_order_relaxed))
+		{
+		}
+		return true;
+	}
+
+	void SpillItem(ItemType& Item)
+	{
+		// Counted first, so a producer that sees it knows to spill behind this item
+		NumSpilled.fetch_add(1, std::memory_order_acq_rel);
+		SpillPushed.fetch_add(1, std::memory_order_relaxed);
+		Spilled.Enqueue(MoveTemp(Item));
+	}
+
+	const uint32 Mask;
+	const ESpacetimeRingOverflow Overflow;
+	TArray<FSlot> Slots;
+
+	FPaddedCounter Tail;
+	FPaddedCounter Head;
+
+	/** Only touched by the consumer. */
+	bool bHeadSpilled = false;
+
+	TQueue<ItemType, EQueueMode::Mpsc> Spilled;
+	std::atomic<int32> NumSpilled{0};
+	std::atomic<uint64> SpillPushed{0};
+	std::atomic<uint64> SpillPopped{0};
+
+	std::atomic<int32> HighWatermark{0};
+	std::atomic<uint64> Overflows{0};
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Misc/Crc.h"
+
+class FSpacetimeCacheSnapshot;
+class FSpacetimeDBClient;
+
+/** One caller's interest in a query; released with FSpacetimeSubscriptionManager::Unsubscribe. */
+struct FSpacetimeSubscriptionHandle
+{
+	uint32 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+};
+
+/**
+ * Shares SQL subscriptions between gameplay systems.
+ *
+ * Queries are canonicalized, so "select * from Player" and "SELECT *  FROM Player;" are the same
+ * subscription, and reference counted: a query reaches the server once, however many systems
+ * subscribe to it. Changes are collected during the frame and flushed once per frame; every query
+ * added in a frame goes out in a single SubscribeMulti message, and an unsubscribe followed by a
+ * subscribe within the same frame sends nothing at all.
+ *
+ * The server unsubscribes whole query sets, so a set stays subscribed until every query in it
+ * was released.
+ *
+ * After a reconnect the server sends every subscribed row again, while the cache still holds the
+ * rows of the previous connection. Those are captured when the connection opens and released once
+ * every set sent on it was applied, so rows the server still has are not reported twice and rows
+ * deleted in the meantime leave the cache (see FSpacetimeCacheSnapshot).
+ *
+ * Game thread only. Must be owned by a TSharedPtr.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeSubscriptionManager : public TSharedFromThis<FSpacetimeSubscriptionManager>
+{
+public:
+	explicit FSpacetimeSubscriptionManager(TSharedRef<FSpacetimeDBClient> InClient);
+	~FSpacetimeSubscriptionManager();
+
+	/** Canonical form of a query: tokens separated by single spaces, keywords upper case, no trailing ';'. */
+	static FString CanonicalizeQuery(const FString& Query);
+
+	FSpacetimeSubscriptionHandle Subscribe(const FString& Query);
+	void Unsubscribe(FSpacetimeSubscriptionHandle& Handle);
+
+	/** Sends the changes made since the last flush; driven by the core ticker once per frame. */
+	void Flush();
+
+	/** Distinct queries that have at least one subscriber. */
+	int32 GetNumActiveQueries() const;
+
+	bool IsApplied(FSpacetimeSubscriptionHandle Handle) const;
+
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnQueriesApplied, const TArray<FString>& /*Queries*/);
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnQueriesFailed, const TArray<FString>& /*Queries*/, const FString& /*Error*/);
+
+	FOnQueriesApplied OnQueriesApplied;
+
+	/** Failed queries are not retried until they are unsubscribed and subscribed again. */
+	FOnQueriesFailed OnQueriesFailed;
+
+private:
+	enum class EQueryState : uint8
+	{
+		Pending,
+		Sent,
+		Applied,
+		Failed,
+	};
+
+	struct FQuery
+	{
+		/** The text of the first subscriber, which is what the server gets. */
+		FString Text;
+		int32 RefCount = 0;
+		uint32 QueryId = 0;
+		EQueryState State = EQueryState::Pending;
+	};
+
+	/** Canonical queries keep literals verbatim, so 'Alice' and 'alice' must stay two queries. */
+	struct FQueryKeyFuncs : TDefaultMapKeyFuncs<FString, FQuery, false>
+	{
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	bool Tick(float DeltaTime);
+	void HandleConnected();
+	void HandleApplied(uint32 QueryId);
+	void HandleError(uint32 QueryId, const FString& Error);
+	void RemoveQuerySet(uint32 QueryId);
+
+	/** Releases Resync once the sets sent since the connection opened were all answered. */
+	void ReleaseResyncIfDone();
+
+	TSharedRef<FSpacetimeDBClient> Client;
+
+	/** By canonical query. */
+	TMap<FString, FQuery, FDefaultSetAllocator, FQueryKeyFuncs> Queries;
+
+	/** Canonical queries of each set sent to the server, by query id. */
+	TMap<uint32, TArray<FString>> QuerySets;
+
+	/** Rows cached before this connection's sets were sent; released once they were all answered. */
+	TSharedPtr<FSpacetimeCacheSnapshot> Resync;
+
+	/** Sets the first flush of this connection sent, not answered yet. */
+	TSet<uint32> ResyncQueryIds;
+	bool bResyncSent = false;
+
+	TMap<uint32, FString> HandleQueries;
+	uint32 LastHandleId = 0;
+	uint32 LastQueryId = 0;
+	bool bDirty = false;
+
+	FTSTicker::FDelegateHandle TickHandle;
+	FDelegateHandle ConnectedHandle;
+	FDelegateHandle AppliedHandle;
+	FDelegateHandle ErrorHandle;
+};
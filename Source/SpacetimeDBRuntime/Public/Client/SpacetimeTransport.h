@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Message-oriented connection to a SpacetimeDB server.
+ * Implemented over WebSockets; the client takes any other implementation, e.g. a stand-in server.
+ */
+class ISpacetimeTransport
+{
+public:
+	DECLARE_DELEGATE(FOnConnected);
+	DECLARE_DELEGATE_OneParam(FOnConnectionError, const FString& /*Error*/);
+	DECLARE_DELEGATE_TwoParams(FOnClosed, int32 /*StatusCode*/, const FString& /*Reason*/);
+
+	/** A complete binary message, still compressed. May fire on any thread. */
+	using FOnMessage = TDelegate<void(TArray<uint8>&& /*Frame*/)>;
+
+	virtual ~ISpacetimeTransport() = default;
+
+	/**
+	 * Opens the connection; the outcome is reported through OnConnected or OnConnectionError.
+	 * @param Url      ws:// or wss:// subscribe URL
+	 * @param Protocol WebSocket subprotocol
+	 * @param Headers  Extra upgrade request headers, e.g. Authorization
+	 */
+	virtual void Connect(const FString& Url, const FString& Protocol, const TMap<FString, FString>& Headers) = 0;
+
+	virtual void Close() = 0;
+
+	virtual bool IsConnected() const = 0;
+
+	/** Sends a binary client message. */
+	virtual void Send(TArray<uint8>&& Message) = 0;
+
+	FOnConnected OnConnected;
+	FOnConnectionError OnConnectionError;
+	FOnClosed OnClosed;
+	FOnMessage OnMessage;
+};
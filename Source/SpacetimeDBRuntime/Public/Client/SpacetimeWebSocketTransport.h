@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Client/SpacetimeTransport.h"
+
+class IWebSocket;
+
+/** Transport over Unreal's WebSockets module. */
+class SPACETIMEDBRUNTIME_API FSpacetimeWebSocketTransport : public ISpacetimeTransport
+{
+public:
+	virtual ~FSpacetimeWebSocketTransport() override;
+
+	virtual void Connect(const FString& Url, const FString& Protocol, const TMap<FString, FString>& Headers) override;
+	virtual void Close() override;
+	virtual bool IsConnected() const override;
+	virtual void Send(TArray<uint8>&& Message) override;
+
+private:
+	void HandleRawMessage(const void* Data, SIZE_T Size, SIZE_T BytesRemaining);
+
+	TSharedPtr<IWebSocket> Socket;
+
+	/** Fragments of the message being received. */
+	TArray<uint8> Partial;
+};
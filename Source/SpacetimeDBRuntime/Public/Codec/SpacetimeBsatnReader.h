@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "BSATN is little-endian; big-endian targets need byte swapping");
+
+/**
+ * Sequential reader over a BSATN-encoded buffer (SpacetimeDB's binary SATS encoding).
+ *
+ * Every Read* returns false once the buffer is exhausted or malformed, and the reader stays
+ * failed from then on, so callers can chain reads with && and check once.
+ * Generated code provides SpacetimeReadBsatn(FSpacetimeBsatnReader&, T&) for module types.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeBsatnReader
+{
+public:
+	explicit FSpacetimeBsatnReader(const TConstArrayView<uint8> InData)
+		: Data(InData)
+	{
+	}
+
+	bool IsOk() const { return !bFailed; }
+	bool IsAtEnd() const { return !bFailed && Offset == Data.Num(); }
+	int32 GetOffset() const { return Offset; }
+	int32 GetRemaining() const { return Data.Num() - Offset; }
+
+	/** Reads a fixed-size little-endian scalar. */
+	template <typename ScalarType>
+	bool ReadScalar(ScalarType& Out)
+	{
+		static_assert(TIsArithmetic<ScalarType>::Value, "ReadScalar expects an arithmetic type");
+		if (!Require(sizeof(ScalarType)))
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Out, Data.GetData() + Offset, sizeof(ScalarType));
+		Offset += sizeof(ScalarType);
+		return true;
+	}
+
+	/** Reads a WireType scalar into a wider or differently signed Unreal property (e.g. U16 into int32). */
+	template <typename WireType, typename PropertyType>
+	bool ReadAs(PropertyType& Out)
+	{
+		WireType Value;
+		if (!ReadScalar(Value))
+		{
+			return false;
+		}
+		Out = static_cast<PropertyType>(Value);
+		return true;
+	}
+
+	bool ReadBool(bool& Out);
+
+	/** Sum type tag, also used for Option (0 = some, 1 = none). */
+	bool ReadTag(uint8& Out) { return ReadScalar(Out); }
+
+	/** Length prefix of strings, byte arrays and arrays. */
+	bool ReadLength(uint32& Out);
+
+	bool ReadString(FString& Out);
+	bool ReadBytes(TArray<uint8>& Out);
+
+	/** Reads a length-prefixed byte array without copying; the view aliases the reader's buffer. */
+	bool ReadBytesView(TConstArrayView<uint8>& Out);
+
+	/** Reads a 128 or 256 bit integer as a 0x-prefixed big-endian hex string. */
+	bool ReadWideInt(FString& Out, int32 NumBytes);
+
+	bool Skip(int32 NumBytes);
+
+	/** Marks the reader as failed, e.g. on an unknown sum tag. */
+	bool Fail()
+	{
+		bFailed = true;
+		return false;
+	}
+
+private:
+	bool Require(const int64 NumBytes)
+	{
+		if (bFailed || NumBytes < 0 || Offset + NumBytes > Data.Num())
+		{
+			bFailed = true;
+			return false;
+		}
+		return true;
+	}
+
+	TConstArrayView<uint8> Data;
+	int32 Offset = 0;
+	bool bFailed = false;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "BSATN is little-endian; big-endian targets need byte swapping");
+
+/** Appends BSATN-encoded values to a byte buffer; the counterpart of FSpacetimeBsatnReader. */
+class SPACETIMEDBRUNTIME_API FSpacetimeBsatnWriter
+{
+public:
+	explicit FSpacetimeBsatnWriter(TArray<uint8>& InBuffer)
+		: Buffer(InBuffer)
+	{
+	}
+
+	/** Writes a fixed-size little-endian scalar. */
+	template <typename ScalarType>
+	void WriteScalar(const ScalarType Value)
+	{
+		static_assert(TIsArithmetic<ScalarType>::Value, "WriteScalar expects an arithmetic type");
+		Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(ScalarType));
+	}
+
+	void WriteBool(const bool bValue) { WriteScalar<uint8>(bValue ? 1 : 0); }
+
+	/** Sum type tag, also used for Option (0 = some, 1 = none). */
+	void WriteTag(const uint8 Tag) { WriteScalar(Tag); }
+
+	/** Length prefix of strings, byte arrays and arrays. */
+	void WriteLength(const int32 Length) { WriteScalar(static_cast<uint32>(Length)); }
+
+	void WriteString(const FString& Value);
+	void WriteBytes(TConstArrayView<uint8> Bytes);
+
+	/**
+	 * Writes a 128 or 256-bit integer given in hex, most significant digit first, as read by
+	 * FSpacetimeBsatnReader::ReadWideInt. Writes nothing if the text is not such a number.
+	 */
+	bool WriteWideInt(const FString& Hex, int32 NumBytes);
+
+private:
+	TArray<uint8>& Buffer;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Compression of a server message, as tagged by its first byte. */
+enum class ESpacetimeCompression : uint8
+{
+	None = 0,
+	Brotli = 1,
+	Gzip = 2,
+};
+
+SPACETIMEDBRUNTIME_API const TCHAR* LexToString(ESpacetimeCompression Compression);
+
+/** Received server messages and their sizes before and after decompression. */
+struct FSpacetimeCompressionStats
+{
+	/** Compression requested when connecting. */
+	ESpacetimeCompression Negotiated = ESpacetimeCompression::None;
+
+	uint64 Messages = 0;
+	uint64 CompressedMessages = 0;
+
+	/** Bytes as received from the socket. */
+	uint64 ReceivedBytes = 0;
+
+	/** Bytes after decompressing the message envelope. */
+	uint64 DecompressedBytes = 0;
+
+	/** How many times larger the messages are uncompressed; 1 if nothing was compressed. */
+	double GetRatio() const
+	{
+		return ReceivedBytes > 0 ? static_cast<double>(DecompressedBytes) / ReceivedBytes : 1.0;
+	}
+};
+
+/**
+ * Decompression of server messages and of the compressed query updates inside them.
+ * Unreal has no brotli decoder, so clients negotiate gzip and brotli payloads are rejected.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeDecompressor
+{
+public:
+	/**
+	 * Decompresses a payload into a reusable buffer. The buffer keeps its allocation between calls.
+	 * @return false and OutError if the payload is malformed or the compression is unsupported
+	 */
+	static bool Decompress(
+		ESpacetimeCompression Compression,
+		TConstArrayView<uint8> Payload,
+		TArray<uint8>& OutBuffer,
+		FString& OutError);
+
+	/**
+	 * Strips the compression tag of a server message and decompresses it if needed.
+	 * @param Frame       Message as received from the socket
+	 * @param Buffer      Reusable buffer for decompressed messages
+	 * @param OutMessage  The BSATN message; aliases either Frame or Buffer
+	 * @param OutCompression Compression the server used for this message
+	 */
+	static bool DecompressServerMessage(
+		TConstArrayView<uint8> Frame,
+		TArray<uint8>& Buffer,
+		TConstArrayView<uint8>& OutMessage,
+		ESpacetimeCompression& OutCompression,
+		FString& OutError);
+};
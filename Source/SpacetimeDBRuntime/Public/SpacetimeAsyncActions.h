@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "SpacetimeAsyncActions.generated.h"
+
+class FSpacetimeDBClient;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FSpacetimeReducerCallPin, const FString&, Error);
+
+/**
+ * A reducer call as a latent Blueprint node: the call is sent right away and OnSuccess or OnFailure
+ * fires once the server acknowledged it, or the connection was lost first.
+ *
+ * Generated reducer classes derive from it and add a factory per reducer, which encodes the
+ * arguments; it uses the client of the USpacetimeDBSubsystem of the caller's game instance.
+ */
+UCLASS()
+class SPACETIMEDBRUNTIME_API USpacetimeReducerCallAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/** For generated factories. Args are the reducer's BSATN-encoded arguments, or unset if they could not be encoded. */
+	static USpacetimeReducerCallAction* CallReducer(UObject* WorldContextObject, const FString& ReducerName, TOptional<TArray<uint8>>&& Args);
+
+	/** The reducer committed; its row changes appear with the client cache's next change events. */
+	UPROPERTY(BlueprintAssignable)
+	FSpacetimeReducerCallPin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FSpacetimeReducerCallPin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	void HandleCommitted(const FString& InReducerName, uint32 InRequestId);
+	void HandleFailed(const FString& InReducerName, uint32 InRequestId, const FString& Error);
+	void HandleDisconnected(const FString& Reason);
+	void Finish(bool bSucceeded, const FString& Error);
+
+	FString ReducerName;
+	TOptional<TArray<uint8>> Args;
+	TSharedPtr<FSpacetimeDBClient> Client;
+	uint32 RequestId = 0;
+
+	FDelegateHandle CommittedHandle;
+	FDelegateHandle FailedHandle;
+	FDelegateHandle DisconnectedHandle;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FSpacetimeDescribeDatabasePin,
+	const TArray<FString>&, Tables, const TArray<FString>&, Reducers, const FString&, Error);
+
+/** USpacetimeBlueprintLibrary::DescribeDatabase as a latent node; nothing blocks while the CLI runs. */
+UCLASS()
+class SPACETIMEDBRUNTIME_API USpacetimeDescribeDatabaseAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable,
+			  Category="SpacetimeDB",
+			  meta=(BlueprintInternalUseOnly="true",
+			  		DisplayName="Describe Database (Async)",
+			  		Keywords="SpacetimeDB Get Description Tables Reducers"))
+	static USpacetimeDescribeDatabaseAction* DescribeDatabaseAsync(const FString& DatabaseName);
+
+	UPROPERTY(BlueprintAssignable)
+	FSpacetimeDescribeDatabasePin OnSuccess;
+
+	UPROPERTY(BlueprintAssignable)
+	FSpacetimeDescribeDatabasePin OnFailure;
+
+	virtual void Activate() override;
+
+private:
+	FString DatabaseName;
+};
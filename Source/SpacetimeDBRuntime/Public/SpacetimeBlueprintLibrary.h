@@ -3,9 +3,21 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "SpacetimeBlueprintLibrary.generated.h"
 
+class FSpacetimeProcessRunner;
+
+/** Outcome of USpacetimeBlueprintLibrary::DescribeDatabaseAsync. */
+struct FSpacetimeDatabaseDescription
+{
+	bool bSucceeded = false;
+	TArray<FString> Tables;
+	TArray<FString> Reducers;
+	FString Error;
+};
+
 /**
  * 
  */
@@ -18,6 +30,8 @@ class SPACETIMEDBRUNTIME_API USpacetimeBlueprintLibrary : public UBlueprintFunct
 	/**
 	 * Calls: spacetime describe --json <DatabaseName>
 	 * Returns: true on success, and fills OutSpaces.
+	 * Blocks until the CLI exits; Blueprints should prefer the latent 'Describe Database (Async)'.
+	 * Safe to call from any thread.
 	 */
 	UFUNCTION(BlueprintCallable,
 			  Category="SpacetimeDB",
@@ -29,5 +43,14 @@ class SPACETIMEDBRUNTIME_API USpacetimeBlueprintLibrary : public UBlueprintFunct
 		TArray<FString>& Reducers,
 		FString& OutError);
 
-	
+	/**
+	 * Runs `spacetime describe --json <DatabaseName>` without blocking the caller. The JSON is
+	 * parsed while the CLI still writes it, and the future completes on a worker thread.
+	 * @param Timeout    Seconds before the CLI is killed; 0 for no limit.
+	 * @param OutRunner  Optionally receives the runner, to cancel the describe.
+	 */
+	static TFuture<FSpacetimeDatabaseDescription> DescribeDatabaseAsync(
+		const FString& DatabaseName,
+		double Timeout = 0.0,
+		TSharedPtr<FSpacetimeProcessRunner>* OutRunner = nullptr);
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpacetimeDBSubsystem.generated.h"
+
+class FSpacetimeDBClient;
+
+/**
+ * Makes a game's SpacetimeDB connection reachable from Blueprints.
+ *
+ * The game creates and connects its FSpacetimeDBClient as usual and hands it over with SetClient;
+ * Blueprint nodes find it through the world context they are called with.
+ */
+UCLASS()
+class SPACETIMEDBRUNTIME_API USpacetimeDBSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** The subsystem of the game instance WorldContextObject belongs to, if any. */
+	static USpacetimeDBSubsystem* Get(const UObject* WorldContextObject);
+
+	void SetClient(TSharedPtr<FSpacetimeDBClient> InClient) { Client = MoveTemp(InClient); }
+	const TSharedPtr<FSpacetimeDBClient>& GetClient() const { return Client; }
+
+	virtual void Deinitialize() override;
+
+private:
+	TSharedPtr<FSpacetimeDBClient> Client;
+};
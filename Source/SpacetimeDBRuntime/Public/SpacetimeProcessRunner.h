@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+
+#include <atomic>
+
+struct FSpacetimeProcessParams
+{
+	FString Executable = TEXT("spacetime");
+	FString Arguments;
+
+	/** Empty for the editor's own working directory. */
+	FString WorkingDirectory;
+
+	/** Seconds before the process is killed; 0 to wait for as long as it takes. */
+	double Timeout = 0.0;
+
+	/** Keep stdout in the result; off when OnStdOut consumes it all anyway. */
+	bool bCaptureStdOut = true;
+};
+
+struct FSpacetimeProcessResult
+{
+	bool bLaunched = false;
+	bool bCanceled = false;
+	bool bTimedOut = false;
+	int32 ReturnCode = -1;
+
+	/** Empty unless FSpacetimeProcessParams::bCaptureStdOut. */
+	FString StdOut;
+	FString StdErr;
+
+	bool Succeeded() const { return bLaunched && !bCanceled && !bTimedOut && ReturnCode == 0; }
+
+	/** Why the process did not succeed, for logs and dialogs. */
+	FString DescribeFailure(const FSpacetimeProcessParams& Params) const;
+};
+
+/**
+ * Runs an external process, such as the SpacetimeDB CLI, without blocking the caller.
+ *
+ * A dedicated thread watches the process and reads its pipes while it runs. Stdout is handed to
+ * OnStdOut in chunks as it arrives, split only between whole characters, so parsing can start
+ * before the process exits. The process is killed on Cancel or once its timeout passes.
+ *
+ * The result arrives through the future returned by Launch, on the runner's thread, and through
+ * OnCompleted on the game thread. The runner keeps itself alive until the process exited.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeProcessRunner : public TSharedFromThis<FSpacetimeProcessRunner>
+{
+public:
+	explicit FSpacetimeProcessRunner(FSpacetimeProcessParams InParams);
+
+	/** Starts the process; at most once per runner. */
+	TFuture<FSpacetimeProcessResult> Launch();
+
+	/** Any thread. Kills the process; the result reports bCanceled. */
+	void Cancel() { bCancelRequested = true; }
+
+	bool IsRunning() const { return bRunning; }
+
+	const FSpacetimeProcessParams& GetParams() const { return Params; }
+
+	DECLARE_DELEGATE_OneParam(FOnStdOut, FStringView /*Chunk*/);
+	DECLARE_DELEGATE_OneParam(FOnCompleted, const FSpacetimeProcessResult& /*Result*/);
+
+	/** Runner thread. Bind before Launch. */
+	FOnStdOut OnStdOut;
+
+	/** Game thread. Bind before Launch. */
+	FOnCompleted OnCompleted;
+
+private:
+	FSpacetimeProcessResult Run();
+
+	const FSpacetimeProcessParams Params;
+	bool bLaunched = false;
+	std::atomic<bool> bRunning{false};
+	std::atomic<bool> bCancelRequested{false};
+};
+
+/**
+ * Text written by one thread, such as a process runner's OnStdOut, and read as an archive by
+ * another, such as a TJsonReader. Reads block until enough text arrived or the stream was closed,
+ * so a parser can consume output while it is still being produced.
+ */
+class SPACETIMEDBRUNTIME_API FSpacetimeTextStream : public FArchive
+{
+public:
+	FSpacetimeTextStream();
+	virtual ~FSpacetimeTextStream() override;
+
+	/** Writer. */
+	void Append(FStringView Text);
+
+	/** Writer. No more text follows; readers see the end of the archive once they consumed the rest. */
+	void Close();
+
+	// FArchive, for the reader
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual bool AtEnd() override;
+	virtual FString GetArchiveName() const override { return TEXT("FSpacetimeTextStream"); }
+
+private:
+	/** Reader. Waits for text; false if the stream closed without any. */
+	bool Refill();
+
+	FCriticalSection Lock;
+	TArray<TCHAR> Written;
+	bool bClosed = false;
+	FEvent* DataAvailable;
+
+	/** Reader only. Taken from Written in one go, so the lock is not touched for every character. */
+	TArray<TCHAR> Reading;
+	int32 ReadIndex = 0;
+};
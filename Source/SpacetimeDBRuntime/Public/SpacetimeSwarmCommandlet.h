@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SpacetimeSwarmCommandlet.generated.h"
+
+/**
+ * Load test: runs a swarm of virtual clients against a SpacetimeDB database from a single process.
+ *
+ * Every virtual client is a full FSpacetimeDBClient with its own connection, receive pipeline and
+ * subscriptions, without any tables registered; all of them share the commandlet's game thread
+ * loop and the runtime's thread pool. Each client calls a reducer at the rate of a scripted
+ * profile, and the swarm reports throughput, reducer round trip percentiles and memory per client
+ * at a fixed interval.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd <Project> -run=SpacetimeSwarm -Database=<name> [options]
+ *
+ *   -Host=localhost:3000     Server, as for FSpacetimeConnectionParams
+ *   -Clients=100             Virtual clients
+ *   -RampUp=10               Seconds over which the clients connect
+ *   -Duration=60             Seconds to run after the last client connected
+ *   -Query="SELECT * FROM t" Subscription of every client; several are separated by ';'
+ *   -Reducer=<name>          Reducer every client calls; none to only receive
+ *   -Args=<hex>              The reducer's BSATN-encoded arguments; empty for no arguments
+ *   -Profile=0:1,30:10       Calls per second and client over time, as seconds:rate points,
+ *                            interpolated linearly and held after the last point
+ *   -Compression=gzip|none
+ *   -TickRate=60             Iterations of the shared loop per second
+ *   -ReportInterval=5        Seconds between reports
+ *   -Csv=<path>              Also writes every report as a CSV row
+ */
+UCLASS()
+class SPACETIMEDBRUNTIME_API USpacetimeSwarmCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USpacetimeSwarmCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -33,6 +33,7 @@ public class SpacetimeDBRuntime : ModuleRules
 		PrivateDependencyModuleNames.AddRange(new string[] {
 			"CoreUObject",
 			"Engine",
+			"WebSockets",	// Client connection to SpacetimeDB servers
 			// "Slate",
 			// "SlateCore",
 			"Json",			// Add Unreal JSON parser for std output from Spacetime CLI...